@@ -0,0 +1,26 @@
+#ifndef VSDL_ARENA_H
+#define VSDL_ARENA_H
+#include <stddef.h>
+#include "vsdl_types.h"
+
+int vsdl_arena_init(VSDL_Arena* arena, size_t capacity);
+// Never fails short of the heap: overflow goes to extra blocks and base grows to fit on the next reset
+void* vsdl_arena_alloc(VSDL_Arena* arena, size_t size, size_t alignment);
+void vsdl_arena_reset(VSDL_Arena* arena);
+void vsdl_arena_destroy(VSDL_Arena* arena);
+
+// Thread binding: worker threads bind their own arena, everything else uses ctx->frameArena
+void vsdl_arena_bind_thread(VSDL_Arena* arena);
+VSDL_Arena* vsdl_thread_arena(VSDL_Context* ctx);
+
+// Frame scope: memory stays valid until the next vsdl_frame_begin (main thread) or
+// until the current work item returns (worker threads)
+int vsdl_frame_arena_init(VSDL_Context* ctx, size_t capacity);
+void vsdl_frame_begin(VSDL_Context* ctx);
+void* vsdl_frame_alloc(VSDL_Context* ctx, size_t size, size_t alignment);
+void vsdl_frame_arena_shutdown(VSDL_Context* ctx);
+
+#define VSDL_ALIGNOF(type) offsetof(struct { char c; type t; }, t)
+#define VSDL_FRAME_NEW(ctx, type, count) ((type*)vsdl_frame_alloc((ctx), sizeof(type) * (count), VSDL_ALIGNOF(type)))
+
+#endif
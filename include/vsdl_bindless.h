@@ -0,0 +1,13 @@
+#ifndef VSDL_BINDLESS_H
+#define VSDL_BINDLESS_H
+#include "vsdl_types.h"
+
+// Leaves ctx->bindless.set null when the device lacks descriptor indexing; callers fall back to per-texture sets
+int vsdl_bindless_init(VSDL_Context* ctx);
+// Render thread, after the frame wait. Returns a slot that stays valid for the view's owner, or VSDL_BINDLESS_NONE
+uint32_t vsdl_bindless_register(VSDL_Context* ctx, VkImageView view);
+// Points an existing slot at a new view, e.g. when more mips of a streamed texture become resident
+void vsdl_bindless_update(VSDL_Context* ctx, uint32_t slot, VkImageView view);
+void vsdl_bindless_shutdown(VSDL_Context* ctx);
+
+#endif
@@ -7,7 +7,12 @@
 
 int vsdl_cimgui_init(VSDL_Context* ctx);
 void vsdl_cimgui_new_frame(void);
-void vsdl_cimgui_render(VSDL_Context* ctx, VkCommandBuffer commandBuffer);
+// Main thread: igRender, then snapshots the draw data into the packet
+void vsdl_cimgui_end_frame(VSDL_FramePacket* packet);
+// Render thread: records the packet's snapshot
+void vsdl_cimgui_render(VSDL_Context* ctx, const VSDL_FramePacket* packet, VkCommandBuffer commandBuffer);
+void vsdl_cimgui_release_packet(VSDL_FramePacket* packet);
+void vsdl_cimgui_destroy_packet(VSDL_FramePacket* packet);
 void vsdl_cimgui_shutdown(VSDL_Context* ctx);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,27 @@
+#ifndef VSDL_DEBUG_H
+#define VSDL_DEBUG_H
+#include "vsdl_types.h"
+
+// Gives every frame packet a vertex buffer
+int vsdl_debug_init(VSDL_Context* ctx);
+// Main thread, from vsdl_frame_packet_acquire: waits until the GPU is done with the packet's buffer
+void vsdl_debug_begin(VSDL_Context* ctx, VSDL_FramePacket* packet);
+
+// Any thread while a packet is built, as long as the call returns before vsdl_frame_packet_submit.
+// Coordinates are window pixels; color is RGBA8 (R in the low byte). Shapes past the buffer are
+// dropped for this frame and the buffer grows for the next use of the packet
+void vsdl_debug_line(VSDL_Context* ctx, float x0, float y0, float x1, float y1, uint32_t color);
+void vsdl_debug_box(VSDL_Context* ctx, float x, float y, float width, float height, uint32_t color);
+void vsdl_debug_circle(VSDL_Context* ctx, float x, float y, float radius, uint32_t color);
+void vsdl_debug_triangle(VSDL_Context* ctx, float x0, float y0, float x1, float y1, float x2, float y2,
+                         uint32_t color);
+void vsdl_debug_fill_box(VSDL_Context* ctx, float x, float y, float width, float height, uint32_t color);
+void vsdl_debug_fill_circle(VSDL_Context* ctx, float x, float y, float radius, uint32_t color);
+
+// Render thread, inside the main pass: one draw per primitive type
+void vsdl_debug_record(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_FramePacket* packet);
+// Render thread, after the frame's submit: retires the buffer and grows it if shapes were dropped
+void vsdl_debug_end_frame(VSDL_Context* ctx, const VSDL_FramePacket* packet);
+void vsdl_debug_shutdown(VSDL_Context* ctx);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef VSDL_DESCRIPTOR_H
+#define VSDL_DESCRIPTOR_H
+#include "vsdl_types.h"
+
+int vsdl_descriptors_init(VSDL_Context* ctx);
+// Long-lived sets; a new, larger pool is chained when the current one runs out
+VkDescriptorSet vsdl_descriptor_alloc(VSDL_Context* ctx, VkDescriptorSetLayout layout);
+// Written with these bindings and valid until the next vsdl_descriptor_begin_frame, for sets whose
+// bindings change too often to be worth caching. Safe to call from recording tasks
+VkDescriptorSet vsdl_descriptor_alloc_frame(VSDL_Context* ctx, VkDescriptorSetLayout layout,
+                                            const VSDL_DescriptorBinding* bindings, uint32_t count);
+// Returns a set holding these bindings, written once and reused for every later request with the
+// same layout and bindings. Safe to call from recording tasks
+VkDescriptorSet vsdl_descriptor_get(VSDL_Context* ctx, VkDescriptorSetLayout layout,
+                                    const VSDL_DescriptorBinding* bindings, uint32_t count);
+// Drops cached sets that reference a view about to be destroyed, so a recycled handle never
+// matches them. The sets go back to their pool once every frame submitted so far has completed
+void vsdl_descriptor_forget_view(VSDL_Context* ctx, VkImageView view);
+// Render thread, after the frame wait: resets last frame's pools in bulk and frees forgotten sets
+void vsdl_descriptor_begin_frame(VSDL_Context* ctx);
+void vsdl_descriptors_shutdown(VSDL_Context* ctx);
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef VSDL_GLYPH_RASTER_H
+#define VSDL_GLYPH_RASTER_H
+#include "vsdl_types.h"
+
+// Queues codepoints [first, last] on the workers in batches of VSDL_GLYPH_BATCH_SIZE.
+// fontData must stay valid until vsdl_glyph_raster_end.
+int vsdl_glyph_raster_begin(VSDL_Context* ctx, VSDL_GlyphRaster* raster, const void* fontData, size_t fontSize,
+                            uint32_t pixelHeight, uint32_t first, uint32_t last);
+// Next batch in codepoint order once it is rasterized; NULL while it is still running
+// (unless wait is set) or after the last batch was handed out
+const VSDL_GlyphBatch* vsdl_glyph_raster_next(VSDL_GlyphRaster* raster, int wait);
+int vsdl_glyph_raster_finished(const VSDL_GlyphRaster* raster);
+// Frees bitmaps and per-thread faces. Call once every batch was handed out, or after vsdl_workers_shutdown.
+void vsdl_glyph_raster_end(VSDL_GlyphRaster* raster);
+
+#endif
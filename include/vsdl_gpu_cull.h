@@ -0,0 +1,22 @@
+#ifndef VSDL_GPU_CULL_H
+#define VSDL_GPU_CULL_H
+#include "vsdl_types.h"
+
+int vsdl_init_gpu_cull(VSDL_Context* ctx, uint32_t maxObjects, uint32_t maxVertices, uint32_t maxIndices);
+uint32_t vsdl_gpu_cull_add_mesh(VSDL_Context* ctx, const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+uint32_t vsdl_gpu_cull_add_object(VSDL_Context* ctx, const GpuObject* object);
+// Before rendering starts or on the render thread; the object buffer changes with the next upload batch
+void vsdl_gpu_cull_set_object(VSDL_Context* ctx, uint32_t id, const GpuObject* object);
+void vsdl_gpu_cull_set_frustum(VSDL_Context* ctx, const float planes[6][4]);
+// Render thread, before vsdl_upload_flush: stages changed objects behind the reads of earlier frames
+void vsdl_gpu_cull_update(VSDL_Context* ctx);
+// Record outside the render pass, before vsdl_gpu_cull_draw, with the count buffer zeroed;
+// the caller orders the clear and the results
+void vsdl_gpu_cull_dispatch(VSDL_Context* ctx, VkCommandBuffer commandBuffer);
+// Render graph: adds the culling compute pass, then declares the draw pass's reads of its results
+void vsdl_gpu_cull_add_pass(VSDL_Context* ctx);
+void vsdl_gpu_cull_read_draws(VSDL_Context* ctx, uint32_t pass);
+void vsdl_gpu_cull_draw(VSDL_Context* ctx, VkCommandBuffer commandBuffer);
+void vsdl_gpu_cull_shutdown(VSDL_Context* ctx);
+
+#endif
\ No newline at end of file
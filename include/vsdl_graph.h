@@ -0,0 +1,37 @@
+#ifndef VSDL_GRAPH_H
+#define VSDL_GRAPH_H
+#include "vsdl_types.h"
+
+// Call after the frame wait; drops last frame's passes and resources.
+// Passes run in the order they are added, so producers go first
+void vsdl_graph_begin(VSDL_Context* ctx);
+
+// initialStage is where the previous owner left the image (e.g. the acquire semaphore wait stage);
+// finalLayout VK_IMAGE_LAYOUT_UNDEFINED leaves it in whatever layout it was last used in.
+// Imported images with a final layout are frame outputs
+uint32_t vsdl_graph_import_image(VSDL_Context* ctx, const char* name, VkImage image, VkImageView view, VkFormat format,
+                                 VkExtent2D extent, VkImageLayout initialLayout, VkPipelineStageFlags initialStage,
+                                 VkImageLayout finalLayout);
+// output: read after the frame, so passes writing it are never culled.
+// initialStage: stages of earlier submissions still reading it; the first write waits for them
+uint32_t vsdl_graph_import_buffer(VSDL_Context* ctx, const char* name, VkBuffer buffer, VkPipelineStageFlags initialStage,
+                                  int output);
+// Transient: contents start undefined each frame and memory is shared with transients
+// whose lifetimes do not overlap
+uint32_t vsdl_graph_create_image(VSDL_Context* ctx, const char* name, VkFormat format, VkExtent2D extent);
+
+uint32_t vsdl_graph_add_pass(VSDL_Context* ctx, const char* name, VSDL_GraphPassType type,
+                             VSDL_GraphExecuteFn execute, void* data);
+// One use per resource per pass; graphics passes render to their single color attachment
+void vsdl_graph_use(VSDL_Context* ctx, uint32_t pass, uint32_t resource, VSDL_GraphUsage usage);
+void vsdl_graph_clear(VSDL_Context* ctx, uint32_t pass, const float color[4]);
+// Valid while the graph executes
+VkImageView vsdl_graph_image_view(VSDL_Context* ctx, uint32_t resource);
+
+// Culls passes nothing reads, places barriers and records every remaining pass
+int vsdl_graph_execute(VSDL_Context* ctx, VkCommandBuffer commandBuffer);
+// Image views went away (swapchain recreation): drop cached framebuffers
+void vsdl_graph_invalidate(VSDL_Context* ctx);
+void vsdl_graph_shutdown(VSDL_Context* ctx);
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef VSDL_IDLE_H
+#define VSDL_IDLE_H
+#include <SDL3/SDL.h>
+#include "vsdl_types.h"
+
+// enabled 0 keeps the old behaviour of drawing every loop iteration
+int vsdl_idle_init(VSDL_Context* ctx, int enabled, uint32_t maxIdleMS);
+
+// Any thread: something visible changed (text, app state); draws at least one more frame
+void vsdl_request_redraw(VSDL_Context* ctx);
+// Main thread: keep drawing continuously for durationMS
+void vsdl_request_animation(VSDL_Context* ctx, uint32_t durationMS);
+// Any thread: wakes the main loop so it looks at finished background work
+void vsdl_idle_wake(void);
+
+// Blocks in SDL_WaitEventTimeout while nothing is dirty; polls otherwise. Returns 1 with an event.
+int vsdl_idle_wait_event(VSDL_Context* ctx, SDL_Event* event);
+// Marks input, window and wake events dirty; call for every event
+void vsdl_idle_handle_event(VSDL_Context* ctx, const SDL_Event* event);
+int vsdl_idle_should_draw(VSDL_Context* ctx);
+// Main thread, called by vsdl_draw_frame once per built frame
+void vsdl_idle_frame_begin(VSDL_Context* ctx);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef VSDL_MEMORY_H
+#define VSDL_MEMORY_H
+#include "vsdl_types.h"
+
+// Call after vmaCreateAllocator
+int vsdl_memory_init(VSDL_Context* ctx);
+
+// Tagged wrappers around vmaCreateBuffer/vmaCreateImage; outInfo may be NULL
+int vsdl_memory_create_buffer(VSDL_Context* ctx, VSDL_MemoryTag tag, const VkBufferCreateInfo* bufferInfo,
+                              const VmaAllocationCreateInfo* allocInfo, VkBuffer* buffer, VmaAllocation* allocation,
+                              VmaAllocationInfo* outInfo);
+int vsdl_memory_create_image(VSDL_Context* ctx, VSDL_MemoryTag tag, const VkImageCreateInfo* imageInfo,
+                             const VmaAllocationCreateInfo* allocInfo, VkImage* image, VmaAllocation* allocation,
+                             VmaAllocationInfo* outInfo);
+void vsdl_memory_destroy_buffer(VSDL_Context* ctx, VkBuffer buffer, VmaAllocation allocation);
+void vsdl_memory_destroy_image(VSDL_Context* ctx, VkImage image, VmaAllocation allocation);
+// Raw memory the caller binds resources to itself, e.g. aliased transient attachments
+int vsdl_memory_allocate(VSDL_Context* ctx, VSDL_MemoryTag tag, const VkMemoryRequirements* requirements,
+                         const VmaAllocationCreateInfo* allocInfo, VmaAllocation* allocation);
+void vsdl_memory_free(VSDL_Context* ctx, VmaAllocation allocation);
+
+// Device-local buffers in the defragmented pool; contents must only change through uploads
+int vsdl_memory_create_movable_buffer(VSDL_Context* ctx, VSDL_MemoryTag tag, VkDeviceSize size,
+                                      VkBufferUsageFlags usage, VSDL_MovableBuffer* buffer);
+void vsdl_memory_destroy_movable_buffer(VSDL_Context* ctx, VSDL_MovableBuffer* buffer);
+// The pending defragmentation pass is copying buffer to a new place
+int vsdl_memory_move_pending(VSDL_Context* ctx, const VSDL_MovableBuffer* buffer);
+// The upload path calls this for every buffer it writes: a movable buffer written while its move is
+// pending stays where it is, so the relocated copy never misses the write
+void vsdl_memory_buffer_written(VSDL_Context* ctx, VkBuffer buffer);
+
+// Once per frame after the frame wait, before any module writes movable buffers:
+// finishes the previous defragmentation pass and records the next one
+void vsdl_memory_update(VSDL_Context* ctx);
+// Render thread, after the frame's submit: publishes arena and defragmentation stats for the panel
+void vsdl_memory_snapshot(VSDL_Context* ctx);
+// Main thread, inside vsdl_draw_frame
+void vsdl_memory_draw_panel(VSDL_Context* ctx);
+void vsdl_memory_shutdown(VSDL_Context* ctx);
+
+#endif
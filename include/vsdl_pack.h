@@ -0,0 +1,15 @@
+#ifndef VSDL_PACK_H
+#define VSDL_PACK_H
+#include "vsdl_types.h"
+
+int vsdl_pack_open(VSDL_Context* ctx, const char* path);
+void vsdl_pack_close(VSDL_Context* ctx);
+const VSDL_PackEntry* vsdl_pack_find(const VSDL_Pack* pack, const char* name);
+
+// Stored entries point straight into the mapping; LZ4 entries and loose-file fallbacks own a copy
+int vsdl_asset_load(VSDL_Context* ctx, const char* name, VSDL_Asset* asset);
+// Read-only on the pack, safe to call from worker threads
+int vsdl_asset_load_from(const VSDL_Pack* pack, const char* name, VSDL_Asset* asset);
+void vsdl_asset_release(VSDL_Asset* asset);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef VSDL_PACK_FORMAT_H
+#define VSDL_PACK_FORMAT_H
+
+#include <stdint.h>
+
+// On-disk layout shared by the engine and tools/vsdl_packer.c (little endian):
+//   VSDL_PackHeader | VSDL_PackEntry[entryCount] sorted by hash | name strings | entry data (4K aligned)
+
+#define VSDL_PACK_MAGIC "VSDLPAK1"
+#define VSDL_PACK_VERSION 1
+#define VSDL_PACK_ALIGNMENT 4096
+
+typedef enum {
+    VSDL_PACK_COMPRESSION_NONE = 0,
+    VSDL_PACK_COMPRESSION_LZ4 = 1
+} VSDL_PackCompression;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint64_t tocOffset;
+    uint64_t namesOffset;
+} VSDL_PackHeader;
+
+typedef struct {
+    uint64_t hash;        // vsdl_pack_hash of the relative path
+    uint64_t offset;      // From start of file, VSDL_PACK_ALIGNMENT aligned
+    uint64_t storedSize;  // Bytes in the pack
+    uint64_t size;        // Bytes after decompression
+    uint32_t compression;
+    uint32_t nameOffset;  // Into the name table, NUL terminated
+} VSDL_PackEntry;
+
+// FNV-1a 64, with '\\' folded to '/' so Windows paths hash the same
+static inline uint64_t vsdl_pack_hash(const char* path) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const unsigned char* p = (const unsigned char*)path; *p; p++) {
+        unsigned char c = (*p == '\\') ? '/' : *p;
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+#endif
@@ -1,5 +1,28 @@
 #ifndef VSDL_PIPELINE_H
 #define VSDL_PIPELINE_H
 #include "vsdl_types.h"
+int vsdl_pipeline_registry_init(VSDL_Context* ctx);
+// Loaded once per path; the registry owns the module
+VkShaderModule vsdl_pipeline_shader(VSDL_Context* ctx, const char* path);
+// Deduplicated on set layouts and push range; the registry owns the layout
+VkPipelineLayout vsdl_pipeline_layout(VSDL_Context* ctx, const VkDescriptorSetLayout* setLayouts, uint32_t setLayoutCount,
+                                      const VkPushConstantRange* pushRange);
+// Returns the pipeline for key, creating it on first use. Viewport and scissor are dynamic.
+// Safe to call from recording tasks: the compile runs without the registry lock, and other callers
+// asking for the same key wait for it. A key that failed to compile keeps returning VK_NULL_HANDLE.
+// Creations after vsdl_pipeline_registry_warm are reported as hot; with the graphics pipeline
+// library those are fast-linked and optimized on the workers
+VkPipeline vsdl_pipeline_get(VSDL_Context* ctx, const VSDL_PipelineKey* key);
+// The pipeline to bind for a handle from vsdl_pipeline_get: its optimized replacement once the
+// background link has finished, otherwise the handle itself. Lock-free
+VkPipeline vsdl_pipeline_resolve(VSDL_Context* ctx, VkPipeline pipeline);
+// Startup prewarming is done: anything created from here on stalls a frame
+void vsdl_pipeline_registry_warm(VSDL_Context* ctx);
+// Logs the hot variants, then destroys every pipeline, layout and shader module
+void vsdl_pipeline_registry_shutdown(VSDL_Context* ctx);
 int vsdl_create_graphics_pipeline(VSDL_Context* ctx);
-#endif
\ No newline at end of file
+// Points a pipeline at the main color pass: ctx->renderPass, or with dynamic rendering a chained
+// VkPipelineRenderingCreateInfo that only needs the color format. renderingInfo must outlive creation
+void vsdl_pipeline_target_main_pass(VSDL_Context* ctx, VkGraphicsPipelineCreateInfo* pipelineInfo,
+                                    VkPipelineRenderingCreateInfo* renderingInfo);
+#endif
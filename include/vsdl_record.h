@@ -0,0 +1,25 @@
+#ifndef VSDL_RECORD_H
+#define VSDL_RECORD_H
+#include "vsdl_types.h"
+
+// Records draw commands into a secondary command buffer; runs on a worker or the calling thread.
+// Command pools are created by the first recording on each thread
+typedef void (*VSDL_RecordFn)(VSDL_Context* ctx, VkCommandBuffer commandBuffer, void* data);
+
+typedef struct {
+    VSDL_RecordFn fn;
+    void* data;
+} VSDL_RecordTask;
+
+// After the frame wait: last frame's secondary buffers are reusable
+void vsdl_record_begin_frame(VSDL_Context* ctx);
+// Records each task into its own secondary buffer in parallel (the caller takes the first)
+// and executes them in task order inside the render pass begun with
+// VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. Every task starts with viewport and scissor
+// covering extent from the attachment's top-left corner
+int vsdl_record_execute(VSDL_Context* ctx, VkCommandBuffer commandBuffer,
+                        const VkCommandBufferInheritanceInfo* inheritance, VkExtent2D extent,
+                        const VSDL_RecordTask* tasks, uint32_t count);
+void vsdl_record_shutdown(VSDL_Context* ctx);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef VSDL_RENDER_THREAD_H
+#define VSDL_RENDER_THREAD_H
+#include "vsdl_types.h"
+
+// Packets work without the thread too: until it starts (or if it fails to) they render inline
+int vsdl_render_thread_init(VSDL_Context* ctx);
+// Call once setup is done; module APIs other than frame building then belong to the render thread
+int vsdl_render_thread_start(VSDL_Context* ctx);
+
+// Main thread: next packet to fill, waiting while the render thread still holds all of them
+VSDL_FramePacket* vsdl_frame_packet_acquire(VSDL_Context* ctx);
+// Main thread: hands the packet over (or renders it right away without a render thread)
+void vsdl_frame_packet_submit(VSDL_Context* ctx, VSDL_FramePacket* packet);
+// Waits until every submitted packet has been rendered
+void vsdl_render_thread_flush(VSDL_Context* ctx);
+void vsdl_render_thread_shutdown(VSDL_Context* ctx);
+
+#endif
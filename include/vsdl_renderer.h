@@ -6,6 +6,12 @@
 // #include <cimgui_impl.h>    // Backend implementations (SDL3, Vulkan)
 
 int vsdl_init_renderer(VSDL_Context* ctx);
+// Main thread, before the first vsdl_draw_frame: the application's per-frame drawing
+void vsdl_set_draw_callback(VSDL_Context* ctx, VSDL_DrawCallback callback, void* userdata);
+// Main thread: builds this frame's packet (the draw callback, then the engine panels) and hands it
+// to the render thread
 void vsdl_draw_frame(VSDL_Context* ctx);
+// Render thread: records, submits and presents one packet
+void vsdl_render_frame(VSDL_Context* ctx, VSDL_FramePacket* packet);
 
 #endif
\ No newline at end of file
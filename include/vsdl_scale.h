@@ -0,0 +1,21 @@
+#ifndef VSDL_SCALE_H
+#define VSDL_SCALE_H
+#include "vsdl_types.h"
+
+// Without it the scene renders straight into the swapchain
+int vsdl_scale_init(VSDL_Context* ctx);
+int vsdl_scale_enabled(VSDL_Context* ctx);
+// Render thread, after the frame wait: reads last frame's GPU time and picks this frame's scale
+void vsdl_scale_begin_frame(VSDL_Context* ctx);
+// Around everything the frame records, outside any render pass
+void vsdl_scale_begin_commands(VSDL_Context* ctx, VkCommandBuffer commandBuffer);
+void vsdl_scale_end_commands(VSDL_Context* ctx, VkCommandBuffer commandBuffer);
+// Size of the transient scene target (swapchain at maxScale); stays put while the scale moves
+VkExtent2D vsdl_scale_target_extent(VSDL_Context* ctx);
+// Part of the target the scene renders into this frame, from its top-left corner
+VkExtent2D vsdl_scale_render_extent(VSDL_Context* ctx);
+// Inside the swapchain pass: samples ctx->scale.sceneImage over the whole attachment
+void vsdl_scale_record(VSDL_Context* ctx, VkCommandBuffer commandBuffer);
+void vsdl_scale_shutdown(VSDL_Context* ctx);
+
+#endif
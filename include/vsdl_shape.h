@@ -0,0 +1,15 @@
+#ifndef VSDL_SHAPE_H
+#define VSDL_SHAPE_H
+#include "vsdl_types.h"
+
+int vsdl_shape_init(VSDL_Context* ctx, size_t budgetBytes);
+// Evicts least recently used runs until the cache fits
+void vsdl_shape_set_budget(VSDL_Context* ctx, size_t budgetBytes);
+// Shapes text with face (FreeType kerning, or HarfBuzz when built with VSDL_USE_HARFBUZZ),
+// reusing the cached run when this string was shaped before. The result stays valid until
+// the next call. Returns NULL only on allocation failure.
+const VSDL_ShapedRun* vsdl_shape_text(VSDL_Context* ctx, FT_Face face, const char* text, size_t length);
+void vsdl_shape_clear(VSDL_Context* ctx);
+void vsdl_shape_shutdown(VSDL_Context* ctx);
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef VSDL_SPRITE_H
+#define VSDL_SPRITE_H
+#include "vsdl_types.h"
+
+int vsdl_init_sprites(VSDL_Context* ctx);
+// Main thread, while a frame is being built; sprites whose texture is not resident yet are skipped
+void vsdl_draw_sprite(VSDL_Context* ctx, const VSDL_Sprite* sprite);
+void vsdl_draw_sprites(VSDL_Context* ctx, const VSDL_Sprite* sprites, uint32_t count);
+// Render thread, inside the main pass: sorts by layer then texture, fills the instance
+// buffer and issues one instanced draw per run of sprites sharing a texture (one draw in
+// total with the bindless table)
+void vsdl_sprite_record(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_FramePacket* packet);
+void vsdl_sprite_shutdown(VSDL_Context* ctx);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef VSDL_SYNC_H
+#define VSDL_SYNC_H
+#include "vsdl_types.h"
+
+int vsdl_sync_init(VSDL_Context* ctx);
+// Submits on the graphics queue and additionally signals the next timeline value, returned in
+// *outValue. submitInfo's own wait/signal semaphores (binary, for the swapchain) are kept
+int vsdl_sync_submit(VSDL_Context* ctx, const VkSubmitInfo* submitInfo, uint64_t* outValue);
+// Last value handed to a submit; work recorded after this call can only land on later values
+uint64_t vsdl_sync_submitted(VSDL_Context* ctx);
+// Value 0 is always reached
+int vsdl_sync_reached(VSDL_Context* ctx, uint64_t value);
+int vsdl_sync_wait(VSDL_Context* ctx, uint64_t value);
+// Waits for everything submitted so far
+int vsdl_sync_wait_all(VSDL_Context* ctx);
+// Destroys the object once every submit made so far has completed, instead of stalling for it
+void vsdl_sync_defer_buffer(VSDL_Context* ctx, VkBuffer buffer, VmaAllocation allocation);
+void vsdl_sync_defer_image(VSDL_Context* ctx, VkImage image, VmaAllocation allocation);
+void vsdl_sync_defer_image_view(VSDL_Context* ctx, VkImageView view);
+// Render thread, once per frame: destroys deferred objects whose value has been reached
+void vsdl_sync_collect(VSDL_Context* ctx);
+// Waits for the GPU, then destroys everything still deferred
+void vsdl_sync_shutdown(VSDL_Context* ctx);
+
+#endif
@@ -4,6 +4,18 @@
 
 int vsdl_init_text(VSDL_Context* ctx);
 int vsdl_create_text_pipeline(VSDL_Context* ctx);
-void vsdl_render_text(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const char* text, float x, float y);
+// Once per frame after the frame wait, before any vsdl_render_text
+void vsdl_text_begin_frame(VSDL_Context* ctx);
+// Main thread, inside vsdl_draw_frame: queues text into the frame packet. x, y is the pen start
+// in pixels from the top-left of the window; vsdl_draw_text is white at scale 1
+void vsdl_draw_text(VSDL_Context* ctx, const char* text, float x, float y);
+void vsdl_draw_text_styled(VSDL_Context* ctx, const char* text, float x, float y, float scale, uint32_t color);
+// Render thread: records text straight into commandBuffer
+void vsdl_render_text(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_TextItem* item);
+// Places font-pixel geometry for the swapchain: color is RGBA8 (R in the low byte)
+void vsdl_text_push_constants(VSDL_Context* ctx, float x, float y, float scale, uint32_t color,
+                              VSDL_TextPushConstants* out);
+// Render thread: whether quads laid out against atlasVersion must be laid out again
+int vsdl_text_layout_stale(VSDL_Context* ctx, uint32_t atlasVersion);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef VSDL_TEXT_OBJECT_H
+#define VSDL_TEXT_OBJECT_H
+#include "vsdl_types.h"
+
+// Objects draw through the text pipeline and font atlas set of vsdl_create_text_pipeline
+int vsdl_text_objects_init(VSDL_Context* ctx);
+// Any thread. Returns VSDL_TEXT_OBJECT_NONE when the table is full. Ids of destroyed objects are
+// ignored everywhere, even after their slot is reused
+uint32_t vsdl_text_object_create(VSDL_Context* ctx, const char* text);
+// Any thread; the quads are laid out again only if text differs from the current content
+void vsdl_text_object_set_text(VSDL_Context* ctx, uint32_t id, const char* text);
+void vsdl_text_object_destroy(VSDL_Context* ctx, uint32_t id);
+// Main thread, inside vsdl_draw_frame: position, scale and colour are per draw (push constants)
+void vsdl_draw_text_object(VSDL_Context* ctx, uint32_t id, float x, float y, float scale, uint32_t color);
+// Render thread, after vsdl_text_begin_frame and before vsdl_upload_flush: frees destroyed objects
+// and lays out and uploads changed ones
+void vsdl_text_objects_update(VSDL_Context* ctx);
+// Render thread, inside the main pass
+void vsdl_text_objects_record(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_FramePacket* packet);
+void vsdl_text_objects_shutdown(VSDL_Context* ctx);
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef VSDL_TEXT_SIMD_H
+#define VSDL_TEXT_SIMD_H
+#include "vsdl_types.h"
+
+// Writes TL,TR,BR,TL,BR,BL per visible glyph starting at pen (x, y); sx/sy convert pixels to NDC.
+// penX, when not NULL, holds shaped pen offsets in pixels and replaces the summed advances.
+// out needs room for 6 * count vertices. Returns the number of vertices written.
+typedef uint32_t (*VSDL_GlyphKernel)(const VSDL_GlyphTable* table, const unsigned char* text, const float* penX, size_t count,
+                                     float x, float y, float sx, float sy, TextVertex* out);
+
+void vsdl_glyph_table_build(VSDL_GlyphTable* table, const FontAtlas* atlas);
+// Picks the widest kernel the CPU supports; call once before vsdl_glyph_quads
+void vsdl_text_simd_init(void);
+const char* vsdl_text_simd_name(void);
+uint32_t vsdl_glyph_quads(const VSDL_GlyphTable* table, const unsigned char* text, const float* penX, size_t count,
+                          float x, float y, float sx, float sy, TextVertex* out);
+
+// Individual kernels; the vector ones finish their tail with the scalar one
+uint32_t vsdl_glyph_quads_scalar(const VSDL_GlyphTable* table, const unsigned char* text, const float* penX, size_t count,
+                                 float x, float y, float sx, float sy, TextVertex* out);
+#ifdef VSDL_TEXT_AVX2
+uint32_t vsdl_glyph_quads_avx2(const VSDL_GlyphTable* table, const unsigned char* text, const float* penX, size_t count,
+                               float x, float y, float sx, float sy, TextVertex* out);
+#endif
+
+#endif
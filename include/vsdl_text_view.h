@@ -0,0 +1,25 @@
+#ifndef VSDL_TEXT_VIEW_H
+#define VSDL_TEXT_VIEW_H
+#include "vsdl_types.h"
+
+// After the font face is sized: rows are spaced by its line height
+int vsdl_text_views_init(VSDL_Context* ctx);
+// Any thread. Returns VSDL_TEXT_VIEW_NONE when the table is full. New views follow the newest line;
+// ids of destroyed views are ignored everywhere, even after their slot is reused
+uint32_t vsdl_text_view_create(VSDL_Context* ctx);
+// Any thread. Amortized O(1) per byte: '\n' ends a line, text after the last one stays open for the next append
+void vsdl_text_view_append(VSDL_Context* ctx, uint32_t id, const char* text, size_t length);
+// Any thread. Moves the top line by lines (negative scrolls up) and stops following the newest line
+void vsdl_text_view_scroll(VSDL_Context* ctx, uint32_t id, int64_t lines);
+void vsdl_text_view_follow(VSDL_Context* ctx, uint32_t id);
+void vsdl_text_view_destroy(VSDL_Context* ctx, uint32_t id);
+// Main thread, inside vsdl_draw_frame: x, y, width and height is the viewport in window pixels
+void vsdl_draw_text_view(VSDL_Context* ctx, uint32_t id, float x, float y, float width, float height, float scale,
+                         uint32_t color);
+// Render thread, before recording starts: frees destroyed views
+void vsdl_text_views_update(VSDL_Context* ctx);
+// Render thread, inside the main pass: lays out lines that scrolled into view and draws each viewport
+void vsdl_text_views_record(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_FramePacket* packet);
+void vsdl_text_views_shutdown(VSDL_Context* ctx);
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef VSDL_TEXTURE_H
+#define VSDL_TEXTURE_H
+#include "vsdl_types.h"
+
+int vsdl_init_textures(VSDL_Context* ctx);
+// Queues a decode on the workers; returns a texture id or UINT32_MAX
+uint32_t vsdl_texture_load(VSDL_Context* ctx, const char* path);
+const VSDL_Texture* vsdl_texture_get(VSDL_Context* ctx, uint32_t id);
+// Creates images and streams mips within the per-frame budget; call once per frame after the frame wait
+void vsdl_texture_update(VSDL_Context* ctx);
+void vsdl_textures_shutdown(VSDL_Context* ctx);
+
+#endif
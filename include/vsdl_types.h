@@ -8,6 +8,7 @@
 #include <vk_mem_alloc.h>
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include "vsdl_pack_format.h"
 
 typedef struct {
     float pos[2];  // x, y
@@ -20,10 +21,18 @@ typedef struct {
 } Vertex3D;  // For 3D objects
 
 typedef struct {
-    float pos[2];     // Position (x, y)
+    float pos[2];     // Font pixels from the pen start (x, y)
     float texCoord[2]; // Texture coordinates (u, v)
 } TextVertex;
 
+// Push constants of shaders/text.vert; the vertices never depend on position or window size
+typedef struct {
+    float origin[2];      // Pen start, pixels from the top-left of the target
+    float pixelToNdc[2];  // Projection: 2 / target size
+    float color[4];
+    float scale;
+} VSDL_TextPushConstants;
+
 typedef struct {
   float x, y;       // Position in atlas (normalized 0–1)
   float w, h;       // Size in atlas (normalized 0–1)
@@ -32,6 +41,21 @@ typedef struct {
   float bearingY;   // Top bearing (pixels)
 } GlyphMetrics;
 
+// Structure-of-arrays glyph metrics for the layout kernels (see vsdl_text_simd.c).
+// Pixel units except u/v; entries with width 0 advance but emit no quad.
+#define VSDL_GLYPH_TABLE_SIZE 128
+typedef struct {
+    float bearingX[VSDL_GLYPH_TABLE_SIZE];
+    float bearingY[VSDL_GLYPH_TABLE_SIZE];
+    float width[VSDL_GLYPH_TABLE_SIZE];
+    float height[VSDL_GLYPH_TABLE_SIZE];
+    float advance[VSDL_GLYPH_TABLE_SIZE];
+    float u0[VSDL_GLYPH_TABLE_SIZE];
+    float v0[VSDL_GLYPH_TABLE_SIZE];
+    float u1[VSDL_GLYPH_TABLE_SIZE];
+    float v1[VSDL_GLYPH_TABLE_SIZE];
+} VSDL_GlyphTable;
+
 typedef struct {
     VkImage texture;
     VmaAllocation textureAllocation;
@@ -41,9 +65,964 @@ typedef struct {
     uint32_t width;
     uint32_t height;
     GlyphMetrics glyphs[128]; // Metrics for ASCII 32–127
+    VSDL_GlyphTable table;    // Same metrics, SoA
+    uint32_t packX;           // Shelf packer cursor
+    uint32_t packY;
+    uint32_t packRowHeight;
+    uint32_t dirtyMinY;       // Rows packed since the last upload, [dirtyMinY, dirtyMaxY)
+    uint32_t dirtyMaxY;
+    uint32_t version;         // Bumped whenever glyphs are packed, so retained layouts know to redo theirs
+    uint32_t droppedBatches;  // Raster batches that did not fit; their remaining glyphs draw as blanks
 } FontAtlas;
 
+// Shaped text runs, cached per (face, string) with an LRU byte budget
+typedef struct VSDL_ShapedRun {
+    struct VSDL_ShapedRun* hashNext;
+    struct VSDL_ShapedRun* lruPrev;
+    struct VSDL_ShapedRun* lruNext;
+    uint64_t hash;
+    const void* face;
+    size_t textLength;
+    size_t bytes;         // Everything owned by the run, including this header
+    char* text;           // Key copy
+    uint32_t glyphCount;
+    unsigned char* glyphs;  // Atlas indices
+    float* penX;          // Pen offsets from the run origin, pixels
+    float width;          // Total advance, pixels
+} VSDL_ShapedRun;
+
+typedef struct {
+    VSDL_ShapedRun** buckets;
+    uint32_t bucketCount;     // Power of two
+    VSDL_ShapedRun* lruHead;  // Most recently used
+    VSDL_ShapedRun* lruTail;
+    uint32_t runCount;
+    size_t bytes;
+    size_t budget;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+} VSDL_ShapeCache;
+
+// Memory-mapped asset pack (see vsdl_pack_format.h)
+typedef struct {
+    const unsigned char* base;
+    size_t size;
+    const VSDL_PackHeader* header;
+    const VSDL_PackEntry* entries;
+    const char* names;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+} VSDL_Pack;
+
+typedef struct {
+    const void* data;
+    size_t size;
+    void* owned;  // Non-NULL when data is a private copy
+} VSDL_Asset;
+
+// Bump allocator for transient CPU memory (see vsdl_arena.c)
+typedef struct VSDL_ArenaBlock {
+    struct VSDL_ArenaBlock* next;
+    size_t size;
+    size_t offset;
+} VSDL_ArenaBlock;
+
+typedef struct {
+    unsigned char* base;
+    size_t capacity;
+    size_t offset;
+    size_t used;                // Includes overflow blocks
+    size_t highWater;           // Peak used across resets
+    VSDL_ArenaBlock* overflow;  // Heap blocks taken when base runs out; folded into base on reset
+} VSDL_Arena;
+
+// GPU memory accounting (see vsdl_memory.c)
+typedef enum {
+    VSDL_MEMORY_TAG_OTHER = 0,
+    VSDL_MEMORY_TAG_TEXT,
+    VSDL_MEMORY_TAG_MESH,
+    VSDL_MEMORY_TAG_TEXTURE,
+    VSDL_MEMORY_TAG_SPRITE,
+    VSDL_MEMORY_TAG_DEBUG,
+    VSDL_MEMORY_TAG_STAGING,
+    VSDL_MEMORY_TAG_TRANSIENT,  // Aliased render graph attachments
+    VSDL_MEMORY_TAG_IMGUI,    // Allocated by the ImGui backend outside VMA; estimated from the budget
+    VSDL_MEMORY_TAG_COUNT
+} VSDL_MemoryTag;
+
+// Long-lived device-local buffer that defragmentation may relocate.
+// Read buffer at record time; version bumps whenever the handle changes.
+typedef struct {
+    VkBuffer buffer;
+    VmaAllocation allocation;
+    VkDeviceSize size;
+    VkBufferUsageFlags usage;
+    VSDL_MemoryTag tag;
+    uint32_t version;
+} VSDL_MovableBuffer;
+
+#define VSDL_MAX_MOVABLE_BUFFERS 256
+#define VSDL_DEFRAG_MAX_MOVES 16
+
+// Render-thread state copied once per frame for the panel, which runs on the main thread
+typedef struct {
+    uint32_t movableCount;
+    int defragRunning;
+    uint32_t defragPasses;
+    uint64_t defragBytesMoved;
+    size_t frameArenaUsed;
+    size_t frameArenaPeak;
+    size_t frameArenaCapacity;
+    uint32_t workerArenaCount;
+    size_t workerArenaPeak;
+    size_t workerArenaCapacity;
+} VSDL_MemoryStats;
+
+typedef struct {
+    SDL_Mutex* lock;                     // Guards the tag counters and stats
+    uint64_t tagBytes[VSDL_MEMORY_TAG_COUNT];
+    uint32_t tagAllocations[VSDL_MEMORY_TAG_COUNT];
+    VkBool32 budgetExtension;            // VK_EXT_memory_budget enabled
+    uint32_t overBudgetHeaps;            // Bitmask of heaps above the warning threshold
+    VmaPool movablePool;
+    VSDL_MovableBuffer* movables[VSDL_MAX_MOVABLE_BUFFERS];
+    uint32_t movableCount;
+    VmaDefragmentationContext defrag;
+    VmaDefragmentationPassMoveInfo pass;
+    VkBuffer passBuffers[VSDL_DEFRAG_MAX_MOVES];  // Destination buffers for the pending pass
+    VkBuffer passSources[VSDL_DEFRAG_MAX_MOVES];  // Sources destroyed mid-pass; the recorded copy still reads them
+    int passActive;
+    uint64_t frameIndex;
+    uint32_t defragInterval;             // Frames between fragmentation checks
+    VkDeviceSize defragBytesPerPass;
+    uint64_t defragBytesMoved;
+    uint32_t defragPasses;
+    VSDL_MemoryStats stats;
+} VSDL_Memory;
+
+// GPU timeline: every queue submit signals the next value of one timeline semaphore, and every CPU
+// wait is "until value N". Without timeline semaphores a ring of reused fences stands in for it
+#define VSDL_SYNC_FALLBACK_FENCES 8
+#define VSDL_SYNC_MAX_DEFERRED 256
+
+typedef enum {
+    VSDL_DEFER_BUFFER,       // buffer + allocation, from vsdl_memory
+    VSDL_DEFER_IMAGE,        // image + allocation, from vsdl_memory
+    VSDL_DEFER_IMAGE_VIEW,
+} VSDL_DeferType;
+
+typedef struct {
+    VSDL_DeferType type;
+    VkBuffer buffer;
+    VkImage image;
+    VkImageView view;
+    VmaAllocation allocation;
+    uint64_t value;          // Destroyed once the timeline reaches this
+} VSDL_Deferred;
+
+typedef struct {
+    VkSemaphore semaphore;   // Timeline semaphore; VK_NULL_HANDLE on the fence fallback
+    PFN_vkWaitSemaphoresKHR waitSemaphores;
+    PFN_vkGetSemaphoreCounterValueKHR getCounterValue;
+    VkFence fences[VSDL_SYNC_FALLBACK_FENCES];   // Fallback: the submit of value v signals fences[v % N]
+    uint64_t fenceValues[VSDL_SYNC_FALLBACK_FENCES];
+    SDL_Mutex* lock;         // Keeps values increasing in queue submission order
+    uint64_t submitted;      // Last value handed to a submit
+    uint64_t completed;      // Last value known to be reached
+    VSDL_Deferred deferred[VSDL_SYNC_MAX_DEFERRED];
+    uint32_t deferredCount;
+} VSDL_Sync;
+
+// Shared staging path for buffer/image uploads
+typedef struct {
+    VkBuffer buffer;
+    VmaAllocation allocation;
+    unsigned char* mapped;
+    VkDeviceSize size;
+    VkDeviceSize offset;
+    VkCommandPool commandPool;
+    VkCommandBuffer commandBuffer;
+    uint64_t submitValue;    // Timeline value of the last batch; its staging memory is free once reached
+    int recording;
+} VSDL_Upload;
+
+// Background worker threads: work-stealing job system
+#define VSDL_MAX_WORKERS 16
+#define VSDL_WORK_QUEUE_SIZE 1024  // Shared queue (jobs from other threads) and parked jobs
+#define VSDL_WORK_DEQUE_SIZE 256   // Per worker; power of two
+
+typedef void (*VSDL_WorkFn)(void* data);
+
+// Jobs submitted with a counter add one to it and take it off when they finish
+typedef struct {
+    SDL_AtomicInt value;
+} VSDL_JobCounter;
+
+typedef struct {
+    VSDL_WorkFn fn;
+    void* data;
+    VSDL_JobCounter* counter;
+    VSDL_JobCounter* dependency;  // Parked until this reaches zero
+} VSDL_WorkItem;
+
+// Chase-Lev deque: the owning worker pushes and pops the bottom, any other worker steals from the top
+typedef struct {
+    SDL_AtomicU32 top;
+    SDL_AtomicU32 bottom;
+    VSDL_WorkItem items[VSDL_WORK_DEQUE_SIZE];
+} VSDL_WorkDeque;
+
+typedef struct {
+    SDL_Thread* threads[VSDL_MAX_WORKERS];
+    uint32_t threadCount;
+    VSDL_WorkDeque deques[VSDL_MAX_WORKERS];
+    SDL_Mutex* mutex;              // Guards the shared queue, parked jobs and sleeping workers
+    SDL_Condition* condition;      // Idle workers
+    SDL_Condition* doneCondition;  // Threads that are not workers waiting on a counter
+    VSDL_WorkItem queue[VSDL_WORK_QUEUE_SIZE];
+    uint32_t head;
+    uint32_t tail;
+    VSDL_WorkItem parked[VSDL_WORK_QUEUE_SIZE];
+    uint32_t parkedCount;
+    SDL_AtomicInt shared;    // Jobs in the shared queue
+    SDL_AtomicInt queued;    // Jobs in the shared queue or any deque
+    SDL_AtomicInt sleeping;
+    int quit;
+    SDL_AtomicInt nextIndex;              // Hands each thread its slot at startup
+    VSDL_Arena arenas[VSDL_MAX_WORKERS];  // Per-thread scratch, reset before each top-level job
+} VSDL_Workers;
+
+// Secondary command buffers recorded in parallel, one command pool per thread
+#define VSDL_RECORD_MAX_TASKS 16
+#define VSDL_RECORD_POOL_BUFFERS 8
+
+typedef struct {
+    VkCommandPool pool;
+    VkCommandBuffer buffers[VSDL_RECORD_POOL_BUFFERS];
+    uint32_t allocated;
+    uint32_t used;  // Handed out since the last frame reset
+} VSDL_RecordPool;
+
+typedef struct {
+    VSDL_RecordPool pools[VSDL_MAX_WORKERS + 1];  // Last slot is for threads that are not workers
+} VSDL_Recorder;
+
+// On-demand rendering: frames are drawn only while something is dirty
+#define VSDL_IDLE_INPUT_FRAMES 3  // ImGui needs a few frames to settle hover/active state after input
+
+typedef struct {
+    int enabled;
+    uint32_t maxIdleMS;       // Redraw at least this often; 0 waits for events indefinitely
+    SDL_AtomicInt dirtyFrames;  // Frames still owed; the render thread may add to it
+    uint64_t animateUntilNS;  // Draw continuously until this time
+    uint64_t lastFrameNS;
+    uint64_t framesDrawn;
+    uint64_t wakeups;         // Waits that timed out with nothing to draw
+} VSDL_Idle;
+
+// Render thread: the main thread builds frame packets, the render thread records and submits them
+#define VSDL_FRAME_PACKETS 2  // Double-buffered: frame N+1 is built while frame N renders
+
+typedef enum {
+    VSDL_PACKET_FREE,
+    VSDL_PACKET_BUILDING,
+    VSDL_PACKET_QUEUED,
+    VSDL_PACKET_RENDERING
+} VSDL_PacketState;
+
+typedef struct {
+    const char* text;  // In the packet arena
+    float x;           // Pen start in pixels, origin at the top-left of the window
+    float y;
+    float scale;
+    uint32_t color;    // RGBA8 (R in the low byte)
+} VSDL_TextItem;
+
+typedef struct {
+    uint32_t id;           // vsdl_text_object_create id
+    float x, y;            // Pen start in pixels, origin at the top-left of the window
+    float scale;
+    uint32_t color;        // RGBA8 (R in the low byte)
+} VSDL_TextObjectDraw;
+
+typedef struct {
+    uint32_t id;           // vsdl_text_view_create id
+    float x, y;            // Top-left of the viewport in pixels, origin at the top-left of the window
+    float width, height;   // Viewport; lines outside it are neither laid out nor drawn
+    float scale;
+    uint32_t color;        // RGBA8 (R in the low byte)
+} VSDL_TextViewDraw;
+
+// Debug draw: lines and filled triangles in window pixels, appended from any thread while a packet
+// is built. Each thread claims fixed chunks of the packet's mapped buffer with one atomic add and
+// fills them without locks; the render thread pads unfilled chunk tails and draws each primitive
+// type with one call
+#define VSDL_DEBUG_CHUNK_VERTICES 768     // Whole lines and whole triangles
+#define VSDL_DEBUG_CIRCLE_SEGMENTS 32
+
+typedef struct {
+    float pos[2];          // Window pixels
+    uint32_t color;        // RGBA8 (R in the low byte)
+} VSDL_DebugVertex;
+
+typedef enum {
+    VSDL_DEBUG_LINES = 0,
+    VSDL_DEBUG_TRIANGLES,
+    VSDL_DEBUG_PRIMITIVE_COUNT
+} VSDL_DebugPrimitive;
+
+typedef struct {
+    uint32_t offset;             // First vertex of the region in the buffer
+    uint32_t capacity;           // Vertices, a multiple of VSDL_DEBUG_CHUNK_VERTICES
+    SDL_AtomicInt reserved;      // Vertices claimed in chunks; running past capacity grows the buffer
+    uint32_t* chunkFill;         // Vertices written per chunk, each by the thread that claimed it
+} VSDL_DebugRegion;
+
+// One per frame packet, kept across the frames that reuse it
+typedef struct {
+    VkBuffer buffer;             // Host-visible and mapped
+    VmaAllocation allocation;
+    VSDL_DebugVertex* vertices;
+    VSDL_DebugRegion regions[VSDL_DEBUG_PRIMITIVE_COUNT];
+    uint64_t retireValue;        // Timeline value of the last frame that drew from the buffer
+} VSDL_DebugFrame;
+
+// Sprites: positions and sizes in pixels, origin at the top-left of the window
+typedef struct {
+    float x, y;            // Center
+    float width, height;
+    float rotation;        // Radians, clockwise on screen
+    float uv[4];           // u0, v0, u1, v1
+    uint32_t color;        // RGBA8 (R in the low byte), multiplied with the texture
+    uint32_t texture;      // vsdl_texture_load id
+    uint16_t layer;        // Lower layers draw first; submission order is kept within a layer and texture
+} VSDL_Sprite;
+
+typedef struct {
+    VSDL_PacketState state;
+    uint64_t frameNumber;
+    int windowWidth;              // Sampled on the main thread for swapchain recreation
+    int windowHeight;
+    VSDL_Arena arena;             // Frame-scope memory of the thread building the packet
+    VSDL_TextItem* textItems;     // In the arena
+    uint32_t textCount;
+    uint32_t textCapacity;
+    VSDL_TextObjectDraw* textObjects;  // In the arena
+    uint32_t textObjectCount;
+    uint32_t textObjectCapacity;
+    VSDL_TextViewDraw* textViews;  // In the arena
+    uint32_t textViewCount;
+    uint32_t textViewCapacity;
+    VSDL_Sprite* sprites;         // In the arena
+    uint32_t spriteCount;
+    uint32_t spriteCapacity;
+    struct ImDrawData* drawData;  // Points at drawLists, this frame's copies of ImGui's draw lists
+    struct ImDrawList** drawLists;  // Kept across frames and refilled in place
+    int drawListCount;
+} VSDL_FramePacket;
+
+typedef struct {
+    SDL_Thread* thread;
+    SDL_Mutex* mutex;
+    SDL_Condition* condition;
+    VSDL_FramePacket packets[VSDL_FRAME_PACKETS];
+    VSDL_FramePacket* building;   // Packet the main thread is filling, NULL outside vsdl_draw_frame
+    uint32_t writeIndex;
+    uint32_t readIndex;
+    uint64_t framesBuilt;
+    uint64_t buildStallNS;        // Main thread time spent waiting for a free packet
+    int quit;
+} VSDL_RenderThread;
+
+// Parallel glyph rasterization; one FreeType library/face per worker slot
+#define VSDL_GLYPH_BATCH_SIZE 32
+
+typedef struct {
+    uint32_t codepoint;
+    uint32_t width;
+    uint32_t rows;
+    int32_t left;
+    int32_t top;
+    float advance;
+    unsigned char* bitmap;  // width * rows, tightly packed; NULL for blank glyphs
+} VSDL_RasterGlyph;
+
+typedef struct VSDL_GlyphRaster VSDL_GlyphRaster;
+
+typedef struct {
+    VSDL_GlyphRaster* raster;
+    uint32_t firstCodepoint;
+    uint32_t count;
+    VSDL_RasterGlyph glyphs[VSDL_GLYPH_BATCH_SIZE];
+    SDL_AtomicInt done;
+} VSDL_GlyphBatch;
+
+struct VSDL_GlyphRaster {
+    const void* fontData;     // Shared read-only by every face
+    size_t fontSize;
+    uint32_t pixelHeight;
+    FT_Library libraries[VSDL_MAX_WORKERS + 1];  // Last slot is for callers that are not workers
+    FT_Face faces[VSDL_MAX_WORKERS + 1];
+    SDL_Mutex* sharedFaceLock;  // The main and render threads both land in the last slot
+    SDL_Mutex* doneLock;        // Pairs with batchDone for vsdl_glyph_raster_next(..., wait)
+    SDL_Condition* batchDone;   // Broadcast whenever a batch finishes
+    VSDL_GlyphBatch* batches;
+    uint32_t batchCount;
+    uint32_t nextBatch;       // Batches are handed out in order
+};
+
+// Textures
+#define VSDL_MAX_TEXTURES 256
+#define VSDL_TEXTURE_PREVIEW_SIZE 128   // Largest mip uploaded up front while finer levels stream in
+#define VSDL_TEXTURE_MAX_LEVELS 32      // Mip chain of a 32-bit extent
+
+typedef enum {
+    VSDL_TEXTURE_EMPTY = 0,
+    VSDL_TEXTURE_LOADING,    // Decoding on a worker
+    VSDL_TEXTURE_DECODED,    // Pixels ready, waiting for GPU image
+    VSDL_TEXTURE_STREAMING,  // Preview mips resident, finer levels uploading coarse to fine
+    VSDL_TEXTURE_READY,
+    VSDL_TEXTURE_FAILED
+} VSDL_TextureState;
+
+typedef struct {
+    char path[256];
+    const VSDL_Pack* pack;   // Source for the worker decode
+    SDL_AtomicInt state;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipLevels;
+    uint32_t previewLevel;   // Level the CPU preview fills (0 when the texture is small)
+    uint32_t residentLevel;  // Most detailed level visible through view
+    uint32_t streamLevel;    // Level currently streaming, previewLevel - 1 down to 0
+    uint32_t streamedRows;   // Rows of streamLevel uploaded so far
+    unsigned char* levels[VSDL_TEXTURE_MAX_LEVELS];  // RGBA8 levels 0..previewLevel; level 0 from stb_image, the rest box-filtered
+    VkImage image;
+    VmaAllocation allocation;
+    VkImageView view;
+    uint32_t version;        // Bumped whenever view changes
+    uint32_t bindlessSlot;   // Index into the bindless table, VSDL_BINDLESS_NONE until the first view
+} VSDL_Texture;
+
+typedef struct {
+    VSDL_Texture textures[VSDL_MAX_TEXTURES];
+    uint32_t count;
+    VkSampler sampler;
+    VkDeviceSize uploadBudget;  // Staging bytes streamed per frame
+} VSDL_TextureSystem;
+
+// Optional device capabilities detected in vsdl_init
+typedef struct {
+    VkBool32 drawIndirectCount;          // VK_KHR_draw_indirect_count
+    VkBool32 drawIndirectFirstInstance;
+    VkBool32 multiDrawIndirect;
+    VkBool32 dynamicRendering;           // Vulkan 1.3 or VK_KHR_dynamic_rendering; no render passes/framebuffers
+    VkBool32 descriptorIndexing;         // Vulkan 1.2 or VK_EXT_descriptor_indexing; enables the bindless texture table
+    VkBool32 timelineSemaphore;          // Vulkan 1.2 or VK_KHR_timeline_semaphore; fence ring otherwise
+    VkBool32 graphicsPipelineLibrary;    // VK_EXT_graphics_pipeline_library with fast linking; registry links prebuilt parts
+} VSDL_DeviceFeatures;
+
+// Pipeline registry: graphics pipelines are described by a key, hashed, and created once; shader
+// modules and layouts are shared between the variants that use them
+#define VSDL_PIPELINE_MAX_ATTRIBUTES 8
+#define VSDL_PIPELINE_MAX_SHADERS 32
+#define VSDL_PIPELINE_MAX_LAYOUTS 16
+#define VSDL_PIPELINE_MAX_VARIANTS 64
+#define VSDL_PIPELINE_MAX_SET_LAYOUTS 4
+#define VSDL_PIPELINE_MAX_LIBRARIES 128
+#define VSDL_PIPELINE_LOOKUP_SLOTS 128   // Power of two, above VSDL_PIPELINE_MAX_VARIANTS
+
+typedef enum {
+    VSDL_BLEND_NONE = 0,
+    VSDL_BLEND_ALPHA,          // Source over destination, color and alpha
+    VSDL_BLEND_ALPHA_REPLACE,  // Color blended the same way, alpha written from the source
+} VSDL_BlendMode;
+
+typedef struct {
+    uint32_t location;
+    VkFormat format;
+    uint32_t offset;
+} VSDL_VertexAttribute;
+
+// Hashed and compared as bytes: handles first, then 32-bit fields, so there is no padding
+// (vsdl_pipeline.c asserts it). Zero-initialize before filling so unused attributes compare equal
+typedef struct {
+    VkShaderModule vertexShader;   // From vsdl_pipeline_shader
+    VkShaderModule fragmentShader;
+    VkPipelineLayout layout;       // From vsdl_pipeline_layout
+    uint32_t vertexStride;         // 0: no vertex buffer
+    VkVertexInputRate inputRate;
+    uint32_t attributeCount;
+    VSDL_VertexAttribute attributes[VSDL_PIPELINE_MAX_ATTRIBUTES];
+    VkPrimitiveTopology topology;
+    VkCullModeFlags cullMode;
+    VkFrontFace frontFace;
+    VSDL_BlendMode blend;
+    VkFormat colorFormat;          // VK_FORMAT_UNDEFINED: the main pass's format
+} VSDL_PipelineKey;
+
+typedef struct {
+    char path[64];
+    VkShaderModule module;
+} VSDL_PipelineShader;
+
+typedef struct {
+    VkDescriptorSetLayout setLayouts[VSDL_PIPELINE_MAX_SET_LAYOUTS];
+    uint32_t setLayoutCount;
+    VkPushConstantRange pushRange;   // size 0: none
+    VkPipelineLayout layout;
+} VSDL_PipelineLayoutEntry;
+
+// One stage group of a variant built as a pipeline library (graphics pipeline library only).
+// key holds just the fields that part depends on, the rest zeroed, so parts are shared across variants
+typedef struct {
+    VkGraphicsPipelineLibraryFlagsEXT part;
+    VSDL_PipelineKey key;
+    VkPipeline pipeline;
+} VSDL_PipelineLibrary;
+
+typedef enum {
+    VSDL_PIPELINE_VARIANT_EMPTY = 0,
+    VSDL_PIPELINE_VARIANT_COMPILING,  // Slot claimed and key set; the creating thread compiles without the lock
+    VSDL_PIPELINE_VARIANT_READY,
+    VSDL_PIPELINE_VARIANT_OPTIMIZED,  // optimized is set
+    VSDL_PIPELINE_VARIANT_FAILED,
+} VSDL_PipelineVariantState;
+
+typedef struct {
+    SDL_AtomicInt state;             // VSDL_PipelineVariantState; set after the fields it covers
+    uint64_t hash;
+    VSDL_PipelineKey key;
+    VkPipeline pipeline;
+    VkPipeline optimized;            // Link-time optimized replacement for a fast-linked pipeline, once compiled
+    VkPipeline libraries[4];         // Vertex input, pre-raster, fragment shader, fragment output
+    int hot;                         // Created while rendering rather than ahead of time
+} VSDL_PipelineVariant;
+
+typedef struct {
+    struct VSDL_Context* ctx;
+    uint32_t variant;
+} VSDL_PipelineOptimizeJob;
+
+typedef struct {
+    SDL_Mutex* lock;                 // Recording tasks may look up variants; never held across a compile
+    SDL_Condition* compiled;         // Signalled when a compiling variant is published
+    VSDL_PipelineShader shaders[VSDL_PIPELINE_MAX_SHADERS];
+    uint32_t shaderCount;
+    VSDL_PipelineLayoutEntry layouts[VSDL_PIPELINE_MAX_LAYOUTS];
+    uint32_t layoutCount;
+    VSDL_PipelineVariant variants[VSDL_PIPELINE_MAX_VARIANTS];
+    uint32_t variantCount;
+    SDL_AtomicInt lookup[VSDL_PIPELINE_LOOKUP_SLOTS];  // Published handle to variant index + 1, read without the lock
+    VSDL_PipelineLibrary libraries[VSDL_PIPELINE_MAX_LIBRARIES];
+    uint32_t libraryCount;
+    VSDL_PipelineOptimizeJob optimizeJobs[VSDL_PIPELINE_MAX_VARIANTS];
+    int warm;                        // Set once startup prewarming is done; later creations are hot
+    uint32_t hotCreated;
+} VSDL_PipelineRegistry;
+
+// Descriptor sets: allocators chain pools as they fill, the cache hands back an existing set
+// for a layout and bindings it has already written
+#define VSDL_DESCRIPTOR_MAX_BINDINGS 8
+
+typedef struct {
+    VkDescriptorPool* ready;   // Last one is allocated from
+    uint32_t readyCount;
+    uint32_t readyCapacity;
+    VkDescriptorPool* full;    // Back to ready on reset
+    uint32_t fullCount;
+    uint32_t fullCapacity;
+    uint32_t setsPerPool;      // Next pool's size, grows by half per new pool
+    VkDescriptorPoolCreateFlags poolFlags;
+} VSDL_DescriptorAllocator;
+
+// One descriptor; buffer bindings set buffer, image and sampler bindings leave it null
+typedef struct {
+    uint32_t binding;
+    VkDescriptorType type;
+    VkSampler sampler;
+    VkImageView imageView;
+    VkImageLayout imageLayout;
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    VkDeviceSize range;
+} VSDL_DescriptorBinding;
+
+typedef struct {
+    uint64_t hash;             // 0 marks an empty slot
+    VkDescriptorSetLayout layout;
+    VSDL_DescriptorBinding bindings[VSDL_DESCRIPTOR_MAX_BINDINGS];
+    uint32_t bindingCount;
+    VkDescriptorSet set;
+    VkDescriptorPool pool;     // Where set goes back to once it is forgotten
+} VSDL_DescriptorCacheEntry;
+
+// A forgotten cached set, freed once the GPU is past value
+typedef struct {
+    VkDescriptorSet set;
+    VkDescriptorPool pool;
+    uint64_t value;
+} VSDL_RetiredDescriptorSet;
+
+typedef struct {
+    SDL_Mutex* lock;                      // Recording tasks run on the workers
+    VSDL_DescriptorAllocator persistent;  // Cached and long-lived sets; pools allow freeing single sets
+    VSDL_DescriptorAllocator frame;       // Reset in bulk after the frame wait
+    VSDL_DescriptorCacheEntry* entries;   // Open addressing, power-of-two capacity
+    uint32_t entryCount;
+    uint32_t entryCapacity;
+    VSDL_RetiredDescriptorSet* retired;
+    uint32_t retiredCount;
+    uint32_t retiredCapacity;
+    uint64_t hits;
+    uint64_t misses;
+} VSDL_Descriptors;
+
+// Bindless texture table: one update-after-bind array of sampled images that shaders index directly
+#define VSDL_BINDLESS_CAPACITY 4096
+#define VSDL_BINDLESS_NONE UINT32_MAX
+
+typedef struct {
+    VkDescriptorSetLayout descriptorSetLayout;  // Binding 0 textures[], binding 1 the texture sampler
+    VkDescriptorPool descriptorPool;
+    VkDescriptorSet set;       // Null without descriptor indexing
+    uint32_t capacity;         // Clamped to the device's update-after-bind limits
+    uint32_t count;            // Slots handed out; a slot keeps its index for the life of the table
+} VSDL_Bindless;
+
+// GPU-driven rendering (std430 layouts shared with shaders/cull.comp)
+typedef struct {
+    float transform[16];  // Column-major model matrix
+    float bounds[4];      // Object-space bounding sphere (xyz center, w radius)
+    uint32_t meshIndex;
+    uint32_t pad[3];
+} GpuObject;
+
+typedef struct {
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t pad;
+} GpuMesh;
+
+typedef struct {
+    uint32_t maxObjects;
+    uint32_t objectCount;
+    uint32_t meshCount;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    float planes[6][4];   // Frustum planes (xyz normal, w distance), inside when dot >= -radius
+    GpuObject* objects;   // CPU copy; changes reach objectBuffer through the upload batch
+    uint32_t dirtyFirst;  // Objects [dirtyFirst, dirtyEnd) changed since the last upload
+    uint32_t dirtyEnd;
+    GpuMesh* meshes;      // Persistently mapped
+    Vertex* vertices;     // Persistently mapped
+    uint32_t* indices;    // Persistently mapped
+    VkBuffer objectBuffer;
+    VmaAllocation objectAllocation;
+    VkBuffer meshBuffer;
+    VmaAllocation meshAllocation;
+    VkBuffer vertexBuffer;
+    VmaAllocation vertexAllocation;
+    VkBuffer indexBuffer;
+    VmaAllocation indexAllocation;
+    VkBuffer commandBuffer;   // VkDrawIndexedIndirectCommand[maxObjects]
+    VmaAllocation commandAllocation;
+    VkBuffer countBuffer;     // uint32_t draw count
+    VmaAllocation countAllocation;
+    VkBuffer visibleBuffer;   // uint32_t object id per draw
+    VmaAllocation visibleAllocation;
+    VkDescriptorSetLayout descriptorSetLayout;
+    VkDescriptorSet descriptorSet;
+    VkPipelineLayout pipelineLayout;
+    VkPipeline cullPipeline;
+    VkPipeline drawPipeline;
+    PFN_vkCmdDrawIndexedIndirectCountKHR cmdDrawIndexedIndirectCount;
+    uint32_t graphCommands;  // This frame's render graph handles, set by vsdl_gpu_cull_add_pass
+    uint32_t graphCount;
+    uint32_t graphVisible;
+} VSDL_GpuCull;
+
+// Per-instance vertex data for shaders/sprite.vert
+typedef struct {
+    float position[2];
+    float size[2];
+    float rotation;
+    uint32_t color;
+    float uv[4];
+    uint32_t texture;     // Bindless slot; unused on the per-texture set path
+} VSDL_SpriteInstance;
+
+typedef struct {
+    VkDescriptorSetLayout descriptorSetLayout;  // Without bindless only
+    VkPipelineLayout pipelineLayout;
+    VkPipeline pipeline;
+    VkBuffer instanceBuffer;           // Persistently mapped, refilled every frame
+    VmaAllocation instanceAllocation;
+    VSDL_SpriteInstance* instances;
+    uint32_t capacity;
+    VkBool32 bindless;                 // One draw per layer-sorted frame, texture picked per instance
+    uint32_t drawn;                    // Last frame
+    uint32_t draws;                    // Last frame
+} VSDL_SpriteBatcher;
+
+// Text object and view ids: the low bits pick the slot, the rest is the slot's generation, bumped
+// on destroy so a stale id never reaches the slot's next owner. Tables stay under 255 slots, so no
+// id is ever UINT32_MAX
+#define VSDL_HANDLE_SLOT_BITS 8
+#define VSDL_HANDLE_GENERATION_MASK ((1u << (32 - VSDL_HANDLE_SLOT_BITS)) - 1)
+#define VSDL_HANDLE_MAKE(slot, generation) (((generation) << VSDL_HANDLE_SLOT_BITS) | (slot))
+#define VSDL_HANDLE_SLOT(id) ((id) & ((1u << VSDL_HANDLE_SLOT_BITS) - 1))
+#define VSDL_HANDLE_GENERATION(id) ((id) >> VSDL_HANDLE_SLOT_BITS)
+
+// Retained text: laid out once into device-local quads, then drawn with one bind and one draw
+// through the text pipeline.
+// Each object holds up to two movable buffers, so the count stays well under VSDL_MAX_MOVABLE_BUFFERS
+#define VSDL_MAX_TEXT_OBJECTS 128
+#define VSDL_TEXT_OBJECT_NONE UINT32_MAX
+
 typedef struct {
+    // Guarded by the table lock
+    char* text;                  // NULL for a free slot
+    int dirty;                   // Content changed since the last layout
+    int released;                // Destroyed; the render thread frees the quads, then the slot is free again
+    uint32_t generation;         // Kept when the slot is freed
+    // Render thread only
+    VSDL_MovableBuffer quads[2]; // Pixel-space TextVertex relative to the pen start; a grown layout goes
+                                 // into the other one, so a failed upload keeps the current quads
+    uint32_t current;            // quads[current] is drawn
+    uint32_t vertexCount;
+    uint32_t atlasVersion;       // Font atlas the quads were laid out against
+} VSDL_TextObject;
+
+typedef struct {
+    SDL_Mutex* lock;
+    VSDL_TextObject objects[VSDL_MAX_TEXT_OBJECTS];
+    uint32_t count;              // Slots ever used
+    uint64_t layouts;            // Relayouts since startup
+} VSDL_TextObjects;
+
+// Virtualized text views for documents too large to lay out whole (live logs). Line bytes go into
+// fixed chunks and line records into fixed pages, so appends never move content. Only visible lines
+// are laid out, into a direct-mapped cache whose entries are recycled as lines scroll off
+#define VSDL_MAX_TEXT_VIEWS 16
+#define VSDL_TEXT_VIEW_NONE UINT32_MAX
+#define VSDL_TEXT_VIEW_CHUNK_BYTES (64 * 1024)
+#define VSDL_TEXT_VIEW_PAGE_LINES 4096
+#define VSDL_TEXT_VIEW_CACHE_LINES 256    // Power of two; caps the lines a viewport shows
+#define VSDL_TEXT_VIEW_MAX_COLUMNS 512    // Bytes of a line that are laid out; the rest is never visible
+
+typedef struct {
+    const char* text;            // In a chunk, not terminated
+    uint32_t length;
+} VSDL_TextLine;
+
+typedef struct {
+    uint64_t line;               // UINT64_MAX when empty
+    uint32_t length;             // Bytes laid out; only the open last line can grow past it
+    uint32_t atlasVersion;
+    TextVertex* vertices;        // Pixels from the line's pen start; kept when the entry is recycled
+    uint32_t vertexCount;
+    uint32_t vertexCapacity;
+} VSDL_TextViewLine;
+
+typedef struct {
+    // Guarded by the table lock
+    int used;
+    int released;                // Destroyed; the render thread frees it, then the slot is free again
+    uint32_t generation;         // Kept when the slot is freed
+    char** chunks;
+    uint32_t chunkCount;
+    uint32_t chunkCapacity;
+    uint32_t chunkUsed;          // Bytes used in the last chunk
+    uint32_t chunkSize;          // Size of the last chunk (larger than VSDL_TEXT_VIEW_CHUNK_BYTES for long lines)
+    VSDL_TextLine** pages;       // VSDL_TEXT_VIEW_PAGE_LINES lines each
+    uint32_t pageCount;
+    uint32_t pageCapacity;
+    uint64_t lineCount;
+    int lineOpen;                // The last line has not seen its newline yet
+    uint64_t firstLine;          // Top line while not following
+    uint64_t shownFirst;         // Top line of the last recorded draw
+    int follow;                  // Keep the newest line in view
+    // Render thread only
+    VSDL_TextViewLine* cache;    // VSDL_TEXT_VIEW_CACHE_LINES entries, indexed by line number
+} VSDL_TextView;
+
+typedef struct {
+    SDL_Mutex* lock;
+    VSDL_TextView views[VSDL_MAX_TEXT_VIEWS];
+    uint32_t count;              // Slots ever used
+    float lineHeight;            // Font pixels between baselines
+    float ascender;              // Font pixels from the top of a line to its baseline
+    uint64_t layouts;            // Lines laid out since startup
+} VSDL_TextViews;
+
+typedef struct {
+    VkPipelineLayout pipelineLayout;
+    VkPipeline pipelines[VSDL_DEBUG_PRIMITIVE_COUNT];  // Line list, triangle list
+    float circle[VSDL_DEBUG_CIRCLE_SEGMENTS + 1][2];   // Unit circle, closed
+    VSDL_DebugFrame frames[VSDL_FRAME_PACKETS];         // Indexed like renderThread.packets
+} VSDL_DebugDraw;
+
+// Dynamic resolution: the scene renders into a corner of a transient target sized for maxScale,
+// then one fullscreen pass upscales it into the swapchain under text and UI
+#define VSDL_SCALE_STEP 0.05f     // Growth per frame while the GPU has headroom
+
+typedef struct {
+    VkDescriptorSetLayout descriptorSetLayout;
+    VkPipelineLayout pipelineLayout;
+    VkPipeline pipeline;
+    VkSampler sampler;
+    VkQueryPool queryPool;             // Two timestamps around the frame; NULL without timestamp support
+    float timestampPeriod;             // Nanoseconds per tick
+    uint64_t timestampMask;
+    int queriesWritten;                // Last frame's commands carry the timestamps
+    float minScale;                    // VSDL_RENDER_SCALE_MIN/MAX, per axis
+    float maxScale;
+    float budgetMS;                    // VSDL_GPU_BUDGET_MS, or the display refresh interval
+    float sharpness;                   // VSDL_UPSCALE_SHARPNESS, 0 = plain bilinear
+    float scale;                       // This frame
+    float gpuMS;                       // Smoothed GPU frame time
+    uint32_t sceneImage;               // This frame's render graph handle
+} VSDL_Scale;
+
+// Render graph: passes declare what they read and write; barriers, culling and
+// transient memory aliasing are derived from that every frame
+#define VSDL_GRAPH_MAX_PASSES 32
+#define VSDL_GRAPH_MAX_RESOURCES 32
+#define VSDL_GRAPH_MAX_USES 8
+#define VSDL_GRAPH_MAX_CACHED 16
+#define VSDL_GRAPH_NONE UINT32_MAX
+
+typedef struct VSDL_Context VSDL_Context;
+typedef struct VSDL_GraphPass VSDL_GraphPass;
+
+typedef enum {
+    VSDL_GRAPH_PASS_COMPUTE,
+    VSDL_GRAPH_PASS_GRAPHICS,
+    VSDL_GRAPH_PASS_GRAPHICS_SECONDARY,  // Render pass contents come from vkCmdExecuteCommands
+} VSDL_GraphPassType;
+
+typedef enum {
+    VSDL_GRAPH_COLOR_ATTACHMENT,
+    VSDL_GRAPH_SAMPLED,
+    VSDL_GRAPH_STORAGE_READ,
+    VSDL_GRAPH_STORAGE_WRITE,
+    VSDL_GRAPH_INDIRECT,
+    VSDL_GRAPH_TRANSFER_SRC,
+    VSDL_GRAPH_TRANSFER_DST,
+} VSDL_GraphUsage;
+
+typedef void (*VSDL_GraphExecuteFn)(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_GraphPass* pass, void* data);
+
+typedef struct {
+    uint32_t resource;
+    VSDL_GraphUsage usage;
+} VSDL_GraphUse;
+
+struct VSDL_GraphPass {
+    const char* name;
+    VSDL_GraphPassType type;
+    VSDL_GraphUse uses[VSDL_GRAPH_MAX_USES];
+    uint32_t useCount;
+    int clear;                 // Color attachment is cleared instead of loaded
+    VkClearColorValue clearColor;
+    VSDL_GraphExecuteFn execute;
+    void* data;
+    int alive;
+    // Valid during execute for graphics passes; renderPass and framebuffer
+    // stay VK_NULL_HANDLE under dynamic rendering
+    VkRenderPass renderPass;
+    VkFramebuffer framebuffer;
+    VkFormat format;
+    VkExtent2D extent;
+};
+
+typedef struct {
+    const char* name;
+    int image;
+    int imported;
+    int output;                // Imported and consumed after the frame; keeps its writers alive
+    VkImage handle;
+    VkImageView view;
+    VkBuffer buffer;
+    VkFormat format;
+    VkExtent2D extent;
+    VkImageUsageFlags usage;   // Transient images: union of every declared use
+    VkImageLayout finalLayout;
+    uint32_t firstPass;
+    uint32_t lastPass;
+    uint32_t memory;           // Transient images: aliasing slot
+    // Tracked state while barriers are built
+    VkImageLayout layout;
+    VkPipelineStageFlags writeStage;
+    VkAccessFlags writeAccess;
+    VkPipelineStageFlags readStages;
+    VkPipelineStageFlags visibleStages;
+    VkAccessFlags visibleAccess;
+} VSDL_GraphResource;
+
+typedef struct {
+    VkFormat format;
+    int clear;
+    VkRenderPass renderPass;
+} VSDL_GraphRenderPass;
+
+typedef struct {
+    VkRenderPass renderPass;
+    VkImageView view;
+    VkExtent2D extent;
+    VkFramebuffer framebuffer;
+} VSDL_GraphFramebuffer;
+
+// Transient images persist across frames while the graph keeps asking for the same ones
+typedef struct {
+    VkFormat format;
+    VkExtent2D extent;
+    VkImageUsageFlags usage;
+    uint32_t memory;
+    VkImage image;
+    VkImageView view;
+    int used;                  // Claimed this frame
+} VSDL_GraphImage;
+
+typedef struct {
+    VmaAllocation allocation;
+    VkDeviceSize size;
+    uint32_t memoryTypeBits;
+    // Last occupant this frame, so the next one waits for it
+    VkPipelineStageFlags stages;
+    VkAccessFlags writeAccess;
+    uint32_t lastPass;
+} VSDL_GraphMemory;
+
+typedef struct {
+    VSDL_GraphPass passes[VSDL_GRAPH_MAX_PASSES];
+    uint32_t passCount;
+    VSDL_GraphResource resources[VSDL_GRAPH_MAX_RESOURCES];
+    uint32_t resourceCount;
+    VSDL_GraphRenderPass renderPasses[VSDL_GRAPH_MAX_CACHED];
+    uint32_t renderPassCount;
+    VSDL_GraphFramebuffer framebuffers[VSDL_GRAPH_MAX_CACHED];
+    uint32_t framebufferCount;
+    VSDL_GraphImage images[VSDL_GRAPH_MAX_CACHED];
+    uint32_t imageCount;
+    VSDL_GraphMemory memory[VSDL_GRAPH_MAX_CACHED];
+    uint32_t memoryCount;
+    PFN_vkCmdBeginRenderingKHR cmdBeginRendering;  // Loaded in vsdl_init with dynamic rendering
+    PFN_vkCmdEndRenderingKHR cmdEndRendering;
+    uint32_t culledPasses;     // Last frame
+    uint32_t barriers;         // Last frame
+} VSDL_Graph;
+
+// Application content for a frame: vsdl_draw_frame calls it on the main thread while the packet is
+// built, after the ImGui frame has begun
+typedef void (*VSDL_DrawCallback)(VSDL_Context* ctx, void* userdata);
+
+struct VSDL_Context {
     SDL_Window* window;
     VkInstance instance;
     VkPhysicalDevice physicalDevice;
@@ -66,24 +1045,52 @@ typedef struct {
     VkPipelineLayout textPipelineLayout;     // For the text pipeline
 
     VkDescriptorSetLayout descriptorSetLayout;  // For text texture
-    VkDescriptorPool descriptorPool;
+    VSDL_Descriptors descriptors;
+    VSDL_PipelineRegistry pipelines;
     VkDescriptorSet descriptorSet;
-    VkFramebuffer* framebuffers;
-    uint32_t framebufferCount;
     VkCommandPool commandPool;
-    VkBuffer vertexBuffer;              // For triangle
-    VmaAllocation vertexBufferAllocation;
-    VkBuffer textVertexBuffer;          // For text
+    VSDL_MovableBuffer vertexBuffer;    // For triangle
+    VkBuffer textVertexBuffer;          // For text, persistently mapped, refilled every frame
     VmaAllocation textVertexBufferAllocation;
+    TextVertex* textVertices;
+    uint32_t textVertexCapacity;
+    uint32_t textVertexCount;           // Used this frame
+    uint32_t textVertexDemand;          // Requested this frame, drives growth
+    int textVertexOverflowLogged;       // The first dropped text draw is logged, later ones only redraw
+    VSDL_Arena frameArena;              // Main thread transient memory, reset every frame
     VkSemaphore imageAvailableSemaphore;
     VkSemaphore renderFinishedSemaphore;
-    VkFence frameFence;
+    VSDL_Sync sync;
+    uint64_t frameValue;                // Timeline value signaled by the last frame submit
     VkDebugUtilsMessengerEXT debugMessenger;
     FT_Library ftLibrary;
     FT_Face ftFace;
     FontAtlas fontAtlas;
+    VSDL_Asset fontAsset;  // Backs ftFace, kept alive until FT_Done_Face
+    VSDL_GlyphRaster glyphRaster;
+    VSDL_ShapeCache shapeCache;
+    VSDL_Idle idle;
+    VSDL_RenderThread renderThread;
     VkCommandBuffer commandBuffer;
-    VkDescriptorPool imguiDescriptorPool; // Optional, if not using ctx->descriptorPool
-} VSDL_Context;
+    VkDescriptorPool imguiDescriptorPool; // ImGui's backend frees its own sets, so it gets a pool of its own
+    uint32_t apiVersion;          // Negotiated instance/device version
+    VSDL_DeviceFeatures features;
+    VSDL_Memory memory;
+    VSDL_GpuCull gpuCull;
+    VSDL_SpriteBatcher sprites;
+    VSDL_Scale scale;
+    VSDL_TextObjects textObjects;
+    VSDL_TextViews textViews;
+    VSDL_DebugDraw debugDraw;
+    VSDL_Pack pack;
+    VSDL_Upload upload;
+    VSDL_Workers workers;
+    VSDL_Recorder recorder;
+    VSDL_TextureSystem textures;
+    VSDL_Bindless bindless;
+    VSDL_Graph graph;
+    VSDL_DrawCallback drawCallback;
+    void* drawUserdata;
+};
 
 #endif
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef VSDL_UPLOAD_H
+#define VSDL_UPLOAD_H
+#include "vsdl_types.h"
+
+int vsdl_upload_init(VSDL_Context* ctx, VkDeviceSize stagingSize);
+// Begins recording if needed; waits for the previous batch's timeline value before reusing staging memory
+VkCommandBuffer vsdl_upload_command_buffer(VSDL_Context* ctx);
+// Returns NULL when the batch has no room left; flush and retry
+void* vsdl_upload_alloc(VSDL_Context* ctx, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize* outOffset);
+VkDeviceSize vsdl_upload_available(VSDL_Context* ctx);
+// Copies rows [y, y + height) of a tightly packed image into mipLevel (layout TRANSFER_DST_OPTIMAL)
+int vsdl_upload_image(VSDL_Context* ctx, VkImage image, uint32_t mipLevel, uint32_t y, uint32_t width, uint32_t height,
+                      const void* pixels, uint32_t bytesPerPixel);
+int vsdl_upload_buffer(VSDL_Context* ctx, VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size);
+int vsdl_upload_flush(VSDL_Context* ctx, int wait);
+void vsdl_upload_shutdown(VSDL_Context* ctx);
+
+void vsdl_cmd_image_barrier(VkCommandBuffer cmd, VkImage image, uint32_t baseMipLevel, uint32_t levelCount,
+                            VkImageLayout oldLayout, VkImageLayout newLayout,
+                            VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+                            VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage);
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef VSDL_WORKERS_H
+#define VSDL_WORKERS_H
+#include "vsdl_types.h"
+
+// Called with [begin, end) slices of a vsdl_parallel_for range
+typedef void (*VSDL_ParallelFn)(void* data, uint32_t begin, uint32_t end);
+
+// threadCount 0 picks one thread per logical core minus the main thread
+int vsdl_workers_init(VSDL_Context* ctx, uint32_t threadCount);
+int vsdl_workers_submit(VSDL_Context* ctx, VSDL_WorkFn fn, void* data);
+// counter may be NULL; it must outlive the job
+int vsdl_workers_submit_counted(VSDL_Context* ctx, VSDL_WorkFn fn, void* data, VSDL_JobCounter* counter);
+// Runs fn once every job counted by dependency has finished
+int vsdl_workers_submit_after(VSDL_Context* ctx, VSDL_JobCounter* dependency, VSDL_WorkFn fn, void* data,
+                              VSDL_JobCounter* counter);
+// Workers run other jobs while they wait; other threads sleep
+void vsdl_workers_wait(VSDL_Context* ctx, VSDL_JobCounter* counter);
+// Splits [0, count) into grain-sized slices pulled by the workers and the caller; grain 0 picks one
+void vsdl_parallel_for(VSDL_Context* ctx, uint32_t count, uint32_t grain, VSDL_ParallelFn fn, void* data);
+// Index of the calling worker thread, or VSDL_MAX_WORKERS on any other thread
+uint32_t vsdl_workers_thread_slot(void);
+void vsdl_workers_shutdown(VSDL_Context* ctx);
+
+#endif
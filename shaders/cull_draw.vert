@@ -0,0 +1,20 @@
+#version 450
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 0) out vec3 fragColor;
+
+struct GpuObject {
+    mat4 transform;
+    vec4 bounds;
+    uint meshIndex;
+    uint pad0, pad1, pad2;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Objects { GpuObject objects[]; };
+layout(std430, set = 0, binding = 4) readonly buffer Visible { uint visibleIds[]; };
+
+void main() {
+    GpuObject obj = objects[visibleIds[gl_InstanceIndex]];
+    gl_Position = obj.transform * vec4(inPosition, 0.0, 1.0);
+    fragColor = inColor;
+}
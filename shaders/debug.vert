@@ -0,0 +1,14 @@
+#version 450
+layout(location = 0) in vec2 inPosition;  // Window pixels
+layout(location = 1) in vec4 inColor;
+
+layout(push_constant) uniform Push {
+    vec2 pixelToNdc;
+} pc;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    gl_Position = vec4(inPosition * pc.pixelToNdc - 1.0, 0.0, 1.0);
+    outColor = inColor;
+}
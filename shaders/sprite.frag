@@ -0,0 +1,8 @@
+#version 450
+layout(location = 0) in vec2 inTexCoord;
+layout(location = 1) in vec4 inColor;
+layout(location = 0) out vec4 outColor;
+layout(binding = 0) uniform sampler2D spriteTexture;
+void main() {
+    outColor = texture(spriteTexture, inTexCoord) * inColor;
+}
\ No newline at end of file
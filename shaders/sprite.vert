@@ -0,0 +1,28 @@
+#version 450
+// Per-instance; the four corners of the strip come from gl_VertexIndex
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inSize;
+layout(location = 2) in float inRotation;
+layout(location = 3) in vec4 inColor;
+layout(location = 4) in vec4 inUV;
+layout(location = 5) in uint inTexture;  // Bindless slot, ignored by sprite.frag
+
+layout(push_constant) uniform Push {
+    vec2 pixelToNdc;
+} pc;
+
+layout(location = 0) out vec2 outTexCoord;
+layout(location = 1) out vec4 outColor;
+layout(location = 2) flat out uint outTexture;
+
+void main() {
+    vec2 corner = vec2(gl_VertexIndex & 1, gl_VertexIndex >> 1);
+    vec2 local = (corner - 0.5) * inSize;
+    float c = cos(inRotation);
+    float s = sin(inRotation);
+    vec2 pixel = inPosition + vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+    gl_Position = vec4(pixel * pc.pixelToNdc - 1.0, 0.0, 1.0);
+    outTexCoord = mix(inUV.xy, inUV.zw, corner);
+    outColor = inColor;
+    outTexture = inTexture;
+}
@@ -0,0 +1,12 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+layout(location = 0) in vec2 inTexCoord;
+layout(location = 1) in vec4 inColor;
+layout(location = 2) flat in uint inTexture;
+layout(location = 0) out vec4 outColor;
+// Bindless table from vsdl_bindless.c; the slot varies per instance, hence nonuniformEXT
+layout(set = 0, binding = 0) uniform texture2D textures[];
+layout(set = 0, binding = 1) uniform sampler textureSampler;
+void main() {
+    outColor = texture(sampler2D(textures[nonuniformEXT(inTexture)], textureSampler), inTexCoord) * inColor;
+}
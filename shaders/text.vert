@@ -1,10 +1,19 @@
 #version 450
-layout(location = 0) in vec2 inPos;
+layout(location = 0) in vec2 inPos;       // Pixels from the pen start
 layout(location = 1) in vec2 inTexCoord;
 
+layout(push_constant) uniform Push {
+    vec2 origin;      // Pen start, pixels from the top-left
+    vec2 pixelToNdc;
+    vec4 color;
+    float scale;
+} pc;
+
 layout(location = 0) out vec2 outTexCoord;
+layout(location = 1) flat out vec4 outColor;
 
 void main() {
-    gl_Position = vec4(inPos, 0.0, 1.0);
+    gl_Position = vec4((pc.origin + inPos * pc.scale) * pc.pixelToNdc - 1.0, 0.0, 1.0);
     outTexCoord = inTexCoord;
-}
\ No newline at end of file
+    outColor = pc.color;
+}
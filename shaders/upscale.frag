@@ -0,0 +1,32 @@
+#version 450
+layout(location = 0) in vec2 inUV;  // 0-1 across the swapchain
+layout(location = 0) out vec4 outColor;
+layout(binding = 0) uniform sampler2D sceneTexture;
+
+layout(push_constant) uniform Push {
+    vec2 uvScale;    // Rendered part of the scene target
+    vec2 texelSize;
+    float sharpness; // 0 = plain bilinear
+} pc;
+
+// Stays half a texel inside the rendered part so filtering never reads the unused border
+vec3 fetch(vec2 uv) {
+    return texture(sceneTexture, clamp(uv, 0.5 * pc.texelSize, pc.uvScale - 0.5 * pc.texelSize)).rgb;
+}
+
+void main() {
+    vec2 uv = inUV * pc.uvScale;
+    vec3 color = fetch(uv);
+    if (pc.sharpness > 0.0) {
+        vec3 n = fetch(uv - vec2(0.0, pc.texelSize.y));
+        vec3 s = fetch(uv + vec2(0.0, pc.texelSize.y));
+        vec3 w = fetch(uv - vec2(pc.texelSize.x, 0.0));
+        vec3 e = fetch(uv + vec2(pc.texelSize.x, 0.0));
+        // Unsharp mask, limited to the neighbourhood's range so edges do not ring
+        vec3 sharpened = color + (color - 0.25 * (n + s + w + e)) * (2.0 * pc.sharpness);
+        vec3 lo = min(color, min(min(n, s), min(w, e)));
+        vec3 hi = max(color, max(max(n, s), max(w, e)));
+        color = clamp(sharpened, lo, hi);
+    }
+    outColor = vec4(color, 1.0);
+}
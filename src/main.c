@@ -3,9 +3,107 @@
 #include "vsdl_renderer.h"
 #include "vsdl_cleanup.h"
 #include "vsdl_text.h"
+#include "vsdl_gpu_cull.h"
+#include "vsdl_texture.h"
+#include "vsdl_sprite.h"
+#include "vsdl_debug.h"
+#include "vsdl_scale.h"
+#include "vsdl_idle.h"
+#include "vsdl_render_thread.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_text_object.h"
+#include "vsdl_text_view.h"
 #include <cimgui.h>
 #include <cimgui_impl.h>
 
+// Scatter small triangles across (and past) the screen so the GPU cull pass has work to reject
+static void add_demo_objects(VSDL_Context* ctx) {
+    Vertex vertices[] = {
+        {{ 0.0f, -0.5f}, {1.0f, 0.5f, 0.0f}},
+        {{ 0.5f,  0.5f}, {0.0f, 0.5f, 1.0f}},
+        {{-0.5f,  0.5f}, {0.5f, 1.0f, 0.0f}}
+    };
+    uint32_t indices[] = {0, 1, 2};
+    uint32_t mesh = vsdl_gpu_cull_add_mesh(ctx, vertices, 3, indices, 3);
+    if (mesh == UINT32_MAX) return;
+
+    const int grid = 64;
+    for (int y = 0; y < grid; y++) {
+        for (int x = 0; x < grid; x++) {
+            GpuObject object = {0};
+            float scale = 0.02f;
+            object.transform[0] = scale;
+            object.transform[5] = scale;
+            object.transform[10] = scale;
+            // Clip space runs -1..1, so about a third of each row lands off screen
+            object.transform[12] = -2.5f + 5.0f * (float)x / (float)(grid - 1);
+            object.transform[13] = -2.5f + 5.0f * (float)y / (float)(grid - 1);
+            object.transform[15] = 1.0f;
+            // Bounding sphere of the triangle in mesh units; the shader scales it by the transform
+            object.bounds[1] = 0.125f;
+            object.bounds[3] = 0.625f;
+            object.meshIndex = mesh;
+            vsdl_gpu_cull_add_object(ctx, &object);
+        }
+    }
+}
+
+typedef struct {
+    uint32_t label;
+    uint32_t logView;
+    Uint64 nextLogLine;
+    uint64_t frames;
+} Demo;
+
+static void draw_demo(VSDL_Context* ctx, void* userdata) {
+    Demo* demo = (Demo*)userdata;
+    demo->frames++;
+
+    vsdl_draw_text(ctx, "Hello", 200.0f, 150.0f);
+
+    // Retained label: laid out and uploaded once, then one bind and one draw per frame
+    if (demo->label == VSDL_TEXT_OBJECT_NONE) demo->label = vsdl_text_object_create(ctx, "Retained text");
+    vsdl_draw_text_object(ctx, demo->label, 16.0f, 200.0f, 0.5f, 0xFF40C0FFu);
+
+    // Log view: appends are O(1) and only the rows inside the viewport are laid out
+    if (demo->logView == VSDL_TEXT_VIEW_NONE) demo->logView = vsdl_text_view_create(ctx);
+    Uint64 now = SDL_GetTicks();
+    if (now >= demo->nextLogLine) {
+        char line[64];
+        int length = SDL_snprintf(line, sizeof(line), "[%llu ms] frame %llu\n", (unsigned long long)now,
+                                  (unsigned long long)demo->frames);
+        if (length > 0) vsdl_text_view_append(ctx, demo->logView, line, SDL_min((size_t)length, sizeof(line) - 1));
+        demo->nextLogLine = now + 1000;
+    }
+    vsdl_draw_text_view(ctx, demo->logView, 16.0f, 240.0f, 360.0f, 120.0f, 0.4f, 0xFFC0C0C0u);
+
+    // Debug shapes go straight into the packet's mapped buffer, from this or any worker thread
+    vsdl_debug_box(ctx, 16.0f, 240.0f, 360.0f, 120.0f, 0xFF808080u);
+    for (int i = 0; i < 4; i++) {
+        vsdl_debug_circle(ctx, 64.0f + 80.0f * (float)i, 64.0f, 46.0f, 0xFF00FF00u);
+    }
+
+    // First loaded texture (crate.png), drawn once it is resident
+    if (ctx->textures.count > 0) {
+        VSDL_Sprite sprite = {0};
+        sprite.width = 64.0f;
+        sprite.height = 64.0f;
+        sprite.uv[2] = 1.0f;
+        sprite.uv[3] = 1.0f;
+        sprite.color = 0xFFFFFFFFu;
+        for (int i = 0; i < 4; i++) {
+            sprite.x = 64.0f + 80.0f * (float)i;
+            sprite.y = 64.0f;
+            sprite.rotation = 0.25f * (float)i;
+            vsdl_draw_sprite(ctx, &sprite);
+        }
+    }
+
+    igBegin("Test Window", NULL, 0);
+    igText("Hello, ImGui!");
+    igEnd();
+}
+
 int main(int argc, char* argv[]) {
     SDL_Log("init main");
     VSDL_Context ctx = {0};
@@ -27,16 +125,53 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    if (vsdl_init_gpu_cull(&ctx, 65536, 1024, 1024)) {
+        add_demo_objects(&ctx);
+    } else {
+        SDL_Log("GPU-driven rendering unavailable, continuing without it");
+    }
+
+    if (!vsdl_init_sprites(&ctx)) {
+        SDL_Log("Sprite batcher unavailable, continuing without it");
+    }
+
+    if (!vsdl_debug_init(&ctx)) {
+        SDL_Log("Debug draw unavailable, continuing without it");
+    }
+
+    if (!vsdl_scale_init(&ctx)) {
+        SDL_Log("Dynamic resolution unavailable, rendering the scene at native resolution");
+    }
+
+    vsdl_texture_load(&ctx, "crate.png");
+
+    Demo demo = {VSDL_TEXT_OBJECT_NONE, VSDL_TEXT_VIEW_NONE, 0, 0};
+    vsdl_set_draw_callback(&ctx, draw_demo, &demo);
+
+    // Every pipeline the demo uses exists by now; later creations are reported as hot
+    vsdl_pipeline_registry_warm(&ctx);
+
+    // From here on recording and submission run on the render thread
+    if (!vsdl_render_thread_start(&ctx)) {
+        SDL_Log("Render thread unavailable, rendering on the main thread");
+    }
+
     SDL_Log("init loop");
     SDL_Log("Starting render loop");
     SDL_Event event;
     int running = 1;
     while (running) {
-        while (SDL_PollEvent(&event)) {
-            ImGui_ImplSDL3_ProcessEvent(&event);
-            if (event.type == SDL_EVENT_QUIT) running = 0;
+        // Sleeps in SDL_WaitEventTimeout while nothing needs drawing
+        if (vsdl_idle_wait_event(&ctx, &event)) {
+            do {
+                ImGui_ImplSDL3_ProcessEvent(&event);
+                vsdl_idle_handle_event(&ctx, &event);
+                if (event.type == SDL_EVENT_QUIT) running = 0;
+            } while (SDL_PollEvent(&event));
+        }
+        if (running && vsdl_idle_should_draw(&ctx)) {
+            vsdl_draw_frame(&ctx);
         }
-        vsdl_draw_frame(&ctx);
     }
 
     SDL_Log("Exiting render loop");
@@ -0,0 +1,116 @@
+#include <SDL3/SDL.h>
+#include "vsdl_arena.h"
+#include "vsdl_types.h"
+
+static SDL_TLSID threadArena;
+
+static size_t align_up(size_t value, size_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+int vsdl_arena_init(VSDL_Arena* arena, size_t capacity) {
+  SDL_memset(arena, 0, sizeof(*arena));
+  arena->base = (unsigned char*)SDL_aligned_alloc(64, capacity);
+  if (!arena->base) return 0;
+  arena->capacity = capacity;
+  return 1;
+}
+
+void* vsdl_arena_alloc(VSDL_Arena* arena, size_t size, size_t alignment) {
+  if (alignment == 0) alignment = sizeof(void*);
+
+  size_t offset = align_up(arena->offset, alignment);
+  if (offset + size <= arena->capacity) {
+      arena->used += offset + size - arena->offset;
+      arena->offset = offset + size;
+      if (arena->used > arena->highWater) arena->highWater = arena->used;
+      return arena->base + offset;
+  }
+
+  VSDL_ArenaBlock* block = arena->overflow;
+  if (block) {
+      uintptr_t data = (uintptr_t)(block + 1);
+      size_t blockOffset = align_up(data + block->offset, alignment) - data;
+      if (blockOffset + size <= block->size) {
+          arena->used += blockOffset + size - block->offset;
+          block->offset = blockOffset + size;
+          if (arena->used > arena->highWater) arena->highWater = arena->used;
+          return (unsigned char*)data + blockOffset;
+      }
+  }
+
+  // Slow path, only until the next reset resizes base
+  size_t blockSize = size + alignment > arena->capacity ? size + alignment : arena->capacity;
+  block = (VSDL_ArenaBlock*)SDL_malloc(sizeof(VSDL_ArenaBlock) + blockSize);
+  if (!block) return NULL;
+  block->next = arena->overflow;
+  block->size = blockSize;
+  arena->overflow = block;
+
+  uintptr_t data = (uintptr_t)(block + 1);
+  size_t blockOffset = align_up(data, alignment) - data;
+  block->offset = blockOffset + size;
+  arena->used += block->offset;
+  if (arena->used > arena->highWater) arena->highWater = arena->used;
+  return (unsigned char*)data + blockOffset;
+}
+
+void vsdl_arena_reset(VSDL_Arena* arena) {
+  if (arena->overflow) {
+      while (arena->overflow) {
+          VSDL_ArenaBlock* next = arena->overflow->next;
+          SDL_free(arena->overflow);
+          arena->overflow = next;
+      }
+      size_t capacity = arena->capacity ? arena->capacity : 4096;
+      while (capacity < arena->highWater) capacity *= 2;
+      unsigned char* base = (unsigned char*)SDL_aligned_alloc(64, capacity);
+      if (base) {
+          SDL_Log("Arena grown from %zu to %zu bytes", arena->capacity, capacity);
+          SDL_aligned_free(arena->base);
+          arena->base = base;
+          arena->capacity = capacity;
+      }
+  }
+  arena->offset = 0;
+  arena->used = 0;
+}
+
+void vsdl_arena_destroy(VSDL_Arena* arena) {
+  while (arena->overflow) {
+      VSDL_ArenaBlock* next = arena->overflow->next;
+      SDL_free(arena->overflow);
+      arena->overflow = next;
+  }
+  SDL_aligned_free(arena->base);
+  SDL_memset(arena, 0, sizeof(*arena));
+}
+
+void vsdl_arena_bind_thread(VSDL_Arena* arena) {
+  SDL_SetTLS(&threadArena, arena, NULL);
+}
+
+VSDL_Arena* vsdl_thread_arena(VSDL_Context* ctx) {
+  VSDL_Arena* arena = (VSDL_Arena*)SDL_GetTLS(&threadArena);
+  return arena ? arena : &ctx->frameArena;
+}
+
+int vsdl_frame_arena_init(VSDL_Context* ctx, size_t capacity) {
+  if (!vsdl_arena_init(&ctx->frameArena, capacity)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate frame arena (%zu bytes)", capacity);
+      return 0;
+  }
+  return 1;
+}
+
+void vsdl_frame_begin(VSDL_Context* ctx) {
+  vsdl_arena_reset(&ctx->frameArena);
+}
+
+void* vsdl_frame_alloc(VSDL_Context* ctx, size_t size, size_t alignment) {
+  return vsdl_arena_alloc(vsdl_thread_arena(ctx), size, alignment);
+}
+
+void vsdl_frame_arena_shutdown(VSDL_Context* ctx) {
+  vsdl_arena_destroy(&ctx->frameArena);
+}
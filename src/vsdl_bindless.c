@@ -0,0 +1,123 @@
+// #define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+// #include <volk.h>
+#include <SDL3/SDL.h>
+#include "vsdl_bindless.h"
+#include "vsdl_types.h"
+
+int vsdl_bindless_init(VSDL_Context* ctx) {
+  VSDL_Bindless* bindless = &ctx->bindless;
+  if (!ctx->features.descriptorIndexing) {
+      SDL_Log("Descriptor indexing unavailable, textures use one descriptor set each");
+      return 1;
+  }
+
+  // Stay inside the update-after-bind limits; drivers report these separately from the regular ones
+  VkPhysicalDeviceDescriptorIndexingProperties indexingProperties = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES};
+  VkPhysicalDeviceProperties2 properties2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+  properties2.pNext = &indexingProperties;
+  vkGetPhysicalDeviceProperties2(ctx->physicalDevice, &properties2);
+  uint32_t capacity = VSDL_BINDLESS_CAPACITY;
+  capacity = SDL_min(capacity, indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages);
+  capacity = SDL_min(capacity, indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages);
+
+  // Binding 0: the texture table, written while sets are bound and only partially filled.
+  // Binding 1: the shared texture sampler, baked into the layout
+  VkDescriptorSetLayoutBinding bindings[2] = {0};
+  bindings[0].binding = 0;
+  bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+  bindings[0].descriptorCount = capacity;
+  bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+  bindings[1].binding = 1;
+  bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+  bindings[1].descriptorCount = 1;
+  bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+  bindings[1].pImmutableSamplers = &ctx->textures.sampler;
+
+  VkDescriptorBindingFlags bindingFlags[2] = {
+      VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT,
+      0
+  };
+  VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO};
+  flagsInfo.bindingCount = 2;
+  flagsInfo.pBindingFlags = bindingFlags;
+
+  VkDescriptorSetLayoutCreateInfo layoutInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+  layoutInfo.pNext = &flagsInfo;
+  layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+  layoutInfo.bindingCount = 2;
+  layoutInfo.pBindings = bindings;
+  if (vkCreateDescriptorSetLayout(ctx->device, &layoutInfo, NULL, &bindless->descriptorSetLayout) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create bindless descriptor set layout");
+      return 0;
+  }
+
+  VkDescriptorPoolSize poolSizes[2] = {
+      {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, capacity},
+      {VK_DESCRIPTOR_TYPE_SAMPLER, 1}
+  };
+  VkDescriptorPoolCreateInfo poolInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+  poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+  poolInfo.maxSets = 1;
+  poolInfo.poolSizeCount = 2;
+  poolInfo.pPoolSizes = poolSizes;
+  if (vkCreateDescriptorPool(ctx->device, &poolInfo, NULL, &bindless->descriptorPool) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create bindless descriptor pool");
+      vsdl_bindless_shutdown(ctx);
+      return 0;
+  }
+
+  VkDescriptorSetAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+  allocInfo.descriptorPool = bindless->descriptorPool;
+  allocInfo.descriptorSetCount = 1;
+  allocInfo.pSetLayouts = &bindless->descriptorSetLayout;
+  if (vkAllocateDescriptorSets(ctx->device, &allocInfo, &bindless->set) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate bindless descriptor set");
+      bindless->set = VK_NULL_HANDLE;
+      vsdl_bindless_shutdown(ctx);
+      return 0;
+  }
+
+  bindless->capacity = capacity;
+  bindless->count = 0;
+  SDL_Log("Bindless texture table initialized (%u slots)", capacity);
+  return 1;
+}
+
+uint32_t vsdl_bindless_register(VSDL_Context* ctx, VkImageView view) {
+  VSDL_Bindless* bindless = &ctx->bindless;
+  if (bindless->set == VK_NULL_HANDLE) return VSDL_BINDLESS_NONE;
+  if (bindless->count >= bindless->capacity) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Bindless texture table full (%u slots)", bindless->capacity);
+      return VSDL_BINDLESS_NONE;
+  }
+  uint32_t slot = bindless->count++;
+  vsdl_bindless_update(ctx, slot, view);
+  return slot;
+}
+
+void vsdl_bindless_update(VSDL_Context* ctx, uint32_t slot, VkImageView view) {
+  VSDL_Bindless* bindless = &ctx->bindless;
+  if (bindless->set == VK_NULL_HANDLE || slot >= bindless->count) return;
+
+  VkDescriptorImageInfo imageInfo = {VK_NULL_HANDLE, view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+  VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+  write.dstSet = bindless->set;
+  write.dstBinding = 0;
+  write.dstArrayElement = slot;
+  write.descriptorCount = 1;
+  write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+  write.pImageInfo = &imageInfo;
+  vkUpdateDescriptorSets(ctx->device, 1, &write, 0, NULL);
+}
+
+void vsdl_bindless_shutdown(VSDL_Context* ctx) {
+  VSDL_Bindless* bindless = &ctx->bindless;
+  if (ctx->device == VK_NULL_HANDLE) return;
+  if (bindless->descriptorPool != VK_NULL_HANDLE) vkDestroyDescriptorPool(ctx->device, bindless->descriptorPool, NULL);
+  if (bindless->descriptorSetLayout != VK_NULL_HANDLE) {
+      vkDestroyDescriptorSetLayout(ctx->device, bindless->descriptorSetLayout, NULL);
+  }
+  SDL_memset(bindless, 0, sizeof(*bindless));
+}
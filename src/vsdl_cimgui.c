@@ -5,6 +5,7 @@
 #include <vulkan/vulkan.h>
 #include <cimgui.h>
 #include <cimgui_impl.h>
+#include "vsdl_sync.h"
 //#include "vsdl_types.h"
 
 static void checkVkResult(VkResult err) {
@@ -35,6 +36,20 @@ int vsdl_cimgui_init(VSDL_Context* ctx) {
         return 0;
     }
 
+    // The backend frees the sets it allocates, which the shared descriptor allocator does not allow
+    VkDescriptorPoolSize imguiPoolSize = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 16};
+    VkDescriptorPoolCreateInfo imguiPoolInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    imguiPoolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    imguiPoolInfo.maxSets = 16;
+    imguiPoolInfo.poolSizeCount = 1;
+    imguiPoolInfo.pPoolSizes = &imguiPoolSize;
+    if (vkCreateDescriptorPool(ctx->device, &imguiPoolInfo, NULL, &ctx->imguiDescriptorPool) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create ImGui descriptor pool");
+        ImGui_ImplSDL3_Shutdown();
+        igDestroyContext(NULL);
+        return 0;
+    }
+
     // Initialize Vulkan backend
     SDL_Log("Setting up ImGui Vulkan backend");
     ImGui_ImplVulkan_InitInfo init_info = {0};
@@ -43,8 +58,15 @@ int vsdl_cimgui_init(VSDL_Context* ctx) {
     init_info.Device = ctx->device;
     init_info.QueueFamily = ctx->graphicsFamily;
     init_info.Queue = ctx->graphicsQueue;
-    init_info.DescriptorPool = ctx->descriptorPool;
+    init_info.DescriptorPool = ctx->imguiDescriptorPool;
     init_info.RenderPass = ctx->renderPass;
+    if (ctx->features.dynamicRendering) {
+        // Rendered inside the graph's main pass; the format pointer outlives the backend
+        init_info.UseDynamicRendering = true;
+        init_info.PipelineRenderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        init_info.PipelineRenderingCreateInfo.colorAttachmentCount = 1;
+        init_info.PipelineRenderingCreateInfo.pColorAttachmentFormats = &ctx->swapchainImageFormat;
+    }
     init_info.MinImageCount = 2;
     init_info.ImageCount = ctx->swapchainImageCount;
     init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
@@ -82,19 +104,85 @@ void vsdl_cimgui_new_frame(void) {
     igNewFrame();
 }
 
-void vsdl_cimgui_render(VSDL_Context* ctx, VkCommandBuffer commandBuffer) {
+// ImVector storage comes from ImGui's allocator; old contents are overwritten, so growth skips the copy
+static void copy_vector(void** data, int* size, int* capacity, const void* src, int count, size_t elementSize) {
+    if (count > *capacity) {
+        igMemFree(*data);
+        *data = igMemAlloc((size_t)count * elementSize);
+        *capacity = count;
+    }
+    if (count > 0) SDL_memcpy(*data, src, (size_t)count * elementSize);
+    *size = count;
+}
+
+// ImGui reuses its draw lists on the next igNewFrame, so the packet keeps its own copies. The packet's
+// lists live as long as the packet and only reallocate when a frame outgrows them
+void vsdl_cimgui_end_frame(VSDL_FramePacket* packet) {
     igRender();
-    ImDrawData* draw_data = igGetDrawData();
-    ImGui_ImplVulkan_RenderDrawData(draw_data, commandBuffer, VK_NULL_HANDLE);
+    ImDrawData* src = igGetDrawData();
+    if (!packet->drawData) packet->drawData = ImDrawData_ImDrawData();
+    vsdl_cimgui_release_packet(packet);
+
+    if (src->CmdListsCount > packet->drawListCount) {
+        ImDrawList** lists = (ImDrawList**)SDL_realloc(packet->drawLists, (size_t)src->CmdListsCount * sizeof(*lists));
+        if (!lists) return;
+        for (int i = packet->drawListCount; i < src->CmdListsCount; i++) {
+            lists[i] = ImDrawList_ImDrawList(src->CmdLists.Data[i]->_Data);
+        }
+        packet->drawLists = lists;
+        packet->drawListCount = src->CmdListsCount;
+    }
+
+    ImDrawData* dst = packet->drawData;
+    dst->DisplayPos = src->DisplayPos;
+    dst->DisplaySize = src->DisplaySize;
+    dst->FramebufferScale = src->FramebufferScale;
+    for (int i = 0; i < src->CmdListsCount; i++) {
+        const ImDrawList* from = src->CmdLists.Data[i];
+        ImDrawList* to = packet->drawLists[i];
+        copy_vector((void**)&to->CmdBuffer.Data, &to->CmdBuffer.Size, &to->CmdBuffer.Capacity,
+                    from->CmdBuffer.Data, from->CmdBuffer.Size, sizeof(ImDrawCmd));
+        copy_vector((void**)&to->IdxBuffer.Data, &to->IdxBuffer.Size, &to->IdxBuffer.Capacity,
+                    from->IdxBuffer.Data, from->IdxBuffer.Size, sizeof(ImDrawIdx));
+        copy_vector((void**)&to->VtxBuffer.Data, &to->VtxBuffer.Size, &to->VtxBuffer.Capacity,
+                    from->VtxBuffer.Data, from->VtxBuffer.Size, sizeof(ImDrawVert));
+        to->Flags = from->Flags;
+        ImDrawData_AddDrawList(dst, to);
+    }
+    dst->Valid = src->Valid;
+}
+
+void vsdl_cimgui_render(VSDL_Context* ctx, const VSDL_FramePacket* packet, VkCommandBuffer commandBuffer) {
+    if (!packet->drawData || !packet->drawData->Valid) return;
+    ImGui_ImplVulkan_RenderDrawData(packet->drawData, commandBuffer, VK_NULL_HANDLE);
+}
+
+void vsdl_cimgui_release_packet(VSDL_FramePacket* packet) {
+    if (packet->drawData) ImDrawData_Clear(packet->drawData);
+}
+
+void vsdl_cimgui_destroy_packet(VSDL_FramePacket* packet) {
+    if (packet->drawData) {
+        vsdl_cimgui_release_packet(packet);
+        ImDrawData_destroy(packet->drawData);
+        packet->drawData = NULL;
+    }
+    for (int i = 0; i < packet->drawListCount; i++) ImDrawList_destroy(packet->drawLists[i]);
+    SDL_free(packet->drawLists);
+    packet->drawLists = NULL;
+    packet->drawListCount = 0;
 }
 
 void vsdl_cimgui_shutdown(VSDL_Context* ctx) {
     SDL_Log("Shutting down ImGui");
-    if (ctx->device != VK_NULL_HANDLE && ctx->frameFence != VK_NULL_HANDLE) {
-        vkWaitForFences(ctx->device, 1, &ctx->frameFence, VK_TRUE, UINT64_MAX);
-        vkResetFences(ctx->device, 1, &ctx->frameFence);
+    if (ctx->device != VK_NULL_HANDLE && ctx->sync.lock) {
+        vsdl_sync_wait(ctx, ctx->frameValue);
     }
     ImGui_ImplVulkan_Shutdown();
     ImGui_ImplSDL3_Shutdown();
     igDestroyContext(NULL);
+    if (ctx->imguiDescriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(ctx->device, ctx->imguiDescriptorPool, NULL);
+        ctx->imguiDescriptorPool = VK_NULL_HANDLE;
+    }
 }
\ No newline at end of file
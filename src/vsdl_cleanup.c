@@ -5,6 +5,27 @@
 #include <cimgui.h>
 #include <cimgui_impl.h>
 #include "vsdl_cimgui.h"
+#include "vsdl_gpu_cull.h"
+#include "vsdl_workers.h"
+#include "vsdl_texture.h"
+#include "vsdl_upload.h"
+#include "vsdl_pack.h"
+#include "vsdl_memory.h"
+#include "vsdl_arena.h"
+#include "vsdl_glyph_raster.h"
+#include "vsdl_shape.h"
+#include "vsdl_render_thread.h"
+#include "vsdl_record.h"
+#include "vsdl_graph.h"
+#include "vsdl_sprite.h"
+#include "vsdl_debug.h"
+#include "vsdl_bindless.h"
+#include "vsdl_descriptor.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_sync.h"
+#include "vsdl_scale.h"
+#include "vsdl_text_object.h"
+#include "vsdl_text_view.h"
 
 static void destroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT debugMessenger, const VkAllocationCallbacks* pAllocator) {
   PFN_vkDestroyDebugUtilsMessengerEXT func = 
@@ -18,6 +39,10 @@ static void destroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMesse
 void vsdl_cleanup(VSDL_Context* ctx) {
   SDL_Log("init cleanup");
 
+  // Finish queued frames and stop the render thread before tearing anything down
+  SDL_Log("Stopping render thread");
+  vsdl_render_thread_shutdown(ctx);
+
   // Shut down ImGui via module and ensure all device operations are complete
   vsdl_cimgui_shutdown(ctx);
 
@@ -26,12 +51,9 @@ void vsdl_cleanup(VSDL_Context* ctx) {
       vkQueueWaitIdle(ctx->graphicsQueue);
   }
 
-  // Destroy synchronization objects
-  SDL_Log("Destroying frame fence");
-  if (ctx->frameFence != VK_NULL_HANDLE) {
-      vkDestroyFence(ctx->device, ctx->frameFence, NULL);
-      ctx->frameFence = VK_NULL_HANDLE;
-  }
+  // Destroy synchronization objects; deferred deletions still pending go first
+  SDL_Log("Destroying timeline and deferred objects");
+  vsdl_sync_shutdown(ctx);
   SDL_Log("Destroying render finished semaphore");
   if (ctx->renderFinishedSemaphore != VK_NULL_HANDLE) {
       vkDestroySemaphore(ctx->device, ctx->renderFinishedSemaphore, NULL);
@@ -50,17 +72,54 @@ void vsdl_cleanup(VSDL_Context* ctx) {
       ctx->commandBuffer = VK_NULL_HANDLE;
   }
 
+  // Stop workers before releasing anything they may still be decoding into
+  SDL_Log("Stopping worker threads");
+  vsdl_workers_shutdown(ctx);
+
+  SDL_Log("Destroying recording command pools");
+  vsdl_record_shutdown(ctx);
+
+  SDL_Log("Destroying textures");
+  vsdl_textures_shutdown(ctx);
+
+  SDL_Log("Destroying upload staging");
+  vsdl_upload_shutdown(ctx);
+
+  SDL_Log("Destroying sprite batcher");
+  vsdl_sprite_shutdown(ctx);
+
+  SDL_Log("Destroying debug draw buffers");
+  vsdl_debug_shutdown(ctx);
+
+  SDL_Log("Destroying dynamic resolution resources");
+  vsdl_scale_shutdown(ctx);
+
+  SDL_Log("Destroying bindless texture table");
+  vsdl_bindless_shutdown(ctx);
+
+  // Destroy GPU-driven rendering resources
+  SDL_Log("Destroying GPU cull resources");
+  vsdl_gpu_cull_shutdown(ctx);
+
+  SDL_Log("Destroying retained text");
+  vsdl_text_objects_shutdown(ctx);
+
+  SDL_Log("Destroying text views");
+  vsdl_text_views_shutdown(ctx);
+
   // Destroy buffers
   SDL_Log("Destroying text vertex buffer");
   if (ctx->textVertexBuffer != VK_NULL_HANDLE) {
-      vmaDestroyBuffer(ctx->allocator, ctx->textVertexBuffer, ctx->textVertexBufferAllocation);
+      vsdl_memory_destroy_buffer(ctx, ctx->textVertexBuffer, ctx->textVertexBufferAllocation);
       ctx->textVertexBuffer = VK_NULL_HANDLE;
+      ctx->textVertices = NULL;
   }
   SDL_Log("Destroying vertex buffer");
-  if (ctx->vertexBuffer != VK_NULL_HANDLE) {
-      vmaDestroyBuffer(ctx->allocator, ctx->vertexBuffer, ctx->vertexBufferAllocation);
-      ctx->vertexBuffer = VK_NULL_HANDLE;
-  }
+  vsdl_memory_destroy_movable_buffer(ctx, &ctx->vertexBuffer);
+
+  // Workers are stopped, so any glyph batches still pending will not run
+  SDL_Log("Releasing glyph rasterizer");
+  vsdl_glyph_raster_end(&ctx->glyphRaster);
 
   // Destroy font atlas resources
   SDL_Log("Destroying font sampler");
@@ -75,7 +134,7 @@ void vsdl_cleanup(VSDL_Context* ctx) {
   }
   SDL_Log("Destroying font texture");
   if (ctx->fontAtlas.texture != VK_NULL_HANDLE) {
-      vmaDestroyImage(ctx->allocator, ctx->fontAtlas.texture, ctx->fontAtlas.textureAllocation);
+      vsdl_memory_destroy_image(ctx, ctx->fontAtlas.texture, ctx->fontAtlas.textureAllocation);
       ctx->fontAtlas.texture = VK_NULL_HANDLE;
   }
   SDL_Log("Freeing font atlas pixels");
@@ -83,68 +142,42 @@ void vsdl_cleanup(VSDL_Context* ctx) {
       free(ctx->fontAtlas.pixels);
       ctx->fontAtlas.pixels = NULL;
   }
+  // Shaped runs are keyed by face pointer, so drop them with the face
+  SDL_Log("Freeing shape cache");
+  vsdl_shape_shutdown(ctx);
   SDL_Log("Destroying FreeType face");
   if (ctx->ftFace) {
       FT_Done_Face(ctx->ftFace);
       ctx->ftFace = NULL;
   }
+  vsdl_asset_release(&ctx->fontAsset);
   SDL_Log("Destroying FreeType library");
   if (ctx->ftLibrary) {
       FT_Done_FreeType(ctx->ftLibrary);
       ctx->ftLibrary = NULL;
   }
 
-  // Destroy pipelines and layouts
-  SDL_Log("Destroying text pipeline");
-  if (ctx->textPipeline != VK_NULL_HANDLE) {
-      vkDestroyPipeline(ctx->device, ctx->textPipeline, NULL);
-      ctx->textPipeline = VK_NULL_HANDLE;
-  }
-  SDL_Log("Destroying graphics pipeline");
-  if (ctx->graphicsPipeline != VK_NULL_HANDLE) {
-      vkDestroyPipeline(ctx->device, ctx->graphicsPipeline, NULL);
-      ctx->graphicsPipeline = VK_NULL_HANDLE;
-  }
-  SDL_Log("Destroying text pipeline layout");
-  if (ctx->textPipelineLayout != VK_NULL_HANDLE) {
-      vkDestroyPipelineLayout(ctx->device, ctx->textPipelineLayout, NULL);
-      ctx->textPipelineLayout = VK_NULL_HANDLE;
-  }
-  SDL_Log("Destroying pipeline layout");
-  if (ctx->pipelineLayout != VK_NULL_HANDLE) {
-      vkDestroyPipelineLayout(ctx->device, ctx->pipelineLayout, NULL);
-      ctx->pipelineLayout = VK_NULL_HANDLE;
-  }
+  // Every pipeline, pipeline layout and shader module is owned by the registry
+  SDL_Log("Destroying pipeline registry");
+  vsdl_pipeline_registry_shutdown(ctx);
+  ctx->textPipeline = VK_NULL_HANDLE;
+  ctx->graphicsPipeline = VK_NULL_HANDLE;
+  ctx->textPipelineLayout = VK_NULL_HANDLE;
+  ctx->pipelineLayout = VK_NULL_HANDLE;
   SDL_Log("Destroying descriptor set layout");
   if (ctx->descriptorSetLayout != VK_NULL_HANDLE) {
       vkDestroyDescriptorSetLayout(ctx->device, ctx->descriptorSetLayout, NULL);
       ctx->descriptorSetLayout = VK_NULL_HANDLE;
   }
 
-  // Destroy descriptor pool
-  SDL_Log("Destroying descriptor pool");
-  if (ctx->descriptorPool != VK_NULL_HANDLE) {
-      vkDestroyDescriptorPool(ctx->device, ctx->descriptorPool, NULL);
-      ctx->descriptorPool = VK_NULL_HANDLE;
-  }
+  // Render graph framebuffers, render passes and transient images; before the descriptor
+  // cache, which transient views are dropped from
+  SDL_Log("Destroying render graph resources");
+  vsdl_graph_shutdown(ctx);
 
-  // Destroy framebuffers
-  SDL_Log("Destroying framebuffers");
-  SDL_Log("Framebuffer pointer: %p, count: %u", (void*)ctx->framebuffers, ctx->framebufferCount);
-  if (ctx->framebuffers && ctx->framebufferCount > 0) {
-      for (uint32_t i = 0; i < ctx->framebufferCount; i++) {
-          if (ctx->framebuffers[i] != VK_NULL_HANDLE) {
-              SDL_Log("Destroying framebuffer %u", i);
-              vkDestroyFramebuffer(ctx->device, ctx->framebuffers[i], NULL);
-              ctx->framebuffers[i] = VK_NULL_HANDLE;
-          }
-      }
-      free(ctx->framebuffers);
-      ctx->framebuffers = NULL;
-      ctx->framebufferCount = 0;
-  } else {
-      SDL_Log("No framebuffers to destroy");
-  }
+  // Destroy descriptor pools and the set cache
+  SDL_Log("Destroying descriptor pools");
+  vsdl_descriptors_shutdown(ctx);
 
   // Destroy render pass
   SDL_Log("Destroying render pass");
@@ -185,6 +218,10 @@ void vsdl_cleanup(VSDL_Context* ctx) {
       ctx->commandPool = VK_NULL_HANDLE;
   }
 
+  // Release the movable pool and tracking before the allocator
+  SDL_Log("Shutting down memory tracking");
+  vsdl_memory_shutdown(ctx);
+
   // Destroy allocator
   SDL_Log("Destroying VMA allocator");
   if (ctx->allocator != VK_NULL_HANDLE) {
@@ -224,6 +261,13 @@ void vsdl_cleanup(VSDL_Context* ctx) {
       ctx->instance = VK_NULL_HANDLE;
   }
 
+  SDL_Log("Freeing frame arena");
+  vsdl_frame_arena_shutdown(ctx);
+
+  // Unmap the asset pack once nothing references its data
+  SDL_Log("Closing asset pack");
+  vsdl_pack_close(ctx);
+
   // Destroy window and quit SDL
   SDL_Log("Destroying window");
   if (ctx->window) {
@@ -0,0 +1,314 @@
+// #define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+// #include <volk.h>
+#include <vk_mem_alloc.h>
+#include <SDL3/SDL.h>
+#include <string.h>
+#include "vsdl_debug.h"
+#include "vsdl_types.h"
+#include "vsdl_memory.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_sync.h"
+
+typedef struct {
+  float pixelToNdc[2];
+} DebugPushConstants;
+
+// Per thread: the chunk it is filling in each region of the packet being built
+typedef struct {
+  const VSDL_DebugFrame* frame;
+  uint64_t frameNumber;
+  uint32_t next[VSDL_DEBUG_PRIMITIVE_COUNT];
+  uint32_t end[VSDL_DEBUG_PRIMITIVE_COUNT];
+  int full[VSDL_DEBUG_PRIMITIVE_COUNT];   // The region ran out this frame; stop claiming
+} DebugThread;
+
+static SDL_TLSID threadState;
+
+static VSDL_DebugFrame* packet_frame(VSDL_Context* ctx, const VSDL_FramePacket* packet) {
+  return &ctx->debugDraw.frames[packet - ctx->renderThread.packets];
+}
+
+static void destroy_buffer(VSDL_Context* ctx, VSDL_DebugFrame* frame) {
+  if (frame->buffer != VK_NULL_HANDLE) vsdl_memory_destroy_buffer(ctx, frame->buffer, frame->allocation);
+  frame->buffer = VK_NULL_HANDLE;
+  frame->allocation = NULL;
+  frame->vertices = NULL;
+}
+
+// Lines first, then triangles, in one buffer
+static int create_buffer(VSDL_Context* ctx, VSDL_DebugFrame* frame, const uint32_t* capacities) {
+  uint32_t total = 0;
+  for (uint32_t type = 0; type < VSDL_DEBUG_PRIMITIVE_COUNT; type++) {
+      VSDL_DebugRegion* region = &frame->regions[type];
+      uint32_t chunks = capacities[type] / VSDL_DEBUG_CHUNK_VERTICES;
+      uint32_t* chunkFill = (uint32_t*)SDL_realloc(region->chunkFill, chunks * sizeof(uint32_t));
+      if (!chunkFill) return 0;
+      memset(chunkFill, 0, chunks * sizeof(uint32_t));
+      region->chunkFill = chunkFill;
+      region->offset = total;
+      region->capacity = 0;
+      total += capacities[type];
+  }
+
+  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  bufferInfo.size = (VkDeviceSize)total * sizeof(VSDL_DebugVertex);
+  bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  VmaAllocationCreateInfo allocInfo = {0};
+  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  VmaAllocationInfo info;
+  if (!vsdl_memory_create_buffer(ctx, VSDL_MEMORY_TAG_DEBUG, &bufferInfo, &allocInfo, &frame->buffer,
+                                 &frame->allocation, &info)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create debug vertex buffer (%u vertices)", total);
+      frame->buffer = VK_NULL_HANDLE;
+      return 0;
+  }
+  frame->vertices = (VSDL_DebugVertex*)info.pMappedData;
+  for (uint32_t type = 0; type < VSDL_DEBUG_PRIMITIVE_COUNT; type++) frame->regions[type].capacity = capacities[type];
+  return 1;
+}
+
+int vsdl_debug_init(VSDL_Context* ctx) {
+  VSDL_DebugDraw* debug = &ctx->debugDraw;
+  for (uint32_t i = 0; i <= VSDL_DEBUG_CIRCLE_SEGMENTS; i++) {
+      float angle = 2.0f * SDL_PI_F * (float)i / (float)VSDL_DEBUG_CIRCLE_SEGMENTS;
+      debug->circle[i][0] = SDL_cosf(angle);
+      debug->circle[i][1] = SDL_sinf(angle);
+  }
+
+  VkPushConstantRange pushRange = {VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(DebugPushConstants)};
+  debug->pipelineLayout = vsdl_pipeline_layout(ctx, NULL, 0, &pushRange);
+  if (debug->pipelineLayout == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create debug pipeline layout");
+      return 0;
+  }
+
+  VSDL_PipelineKey key = {0};
+  key.vertexShader = vsdl_pipeline_shader(ctx, "shaders/debug.vert.spv");
+  key.fragmentShader = vsdl_pipeline_shader(ctx, "shaders/debug.frag.spv");
+  if (key.vertexShader == VK_NULL_HANDLE || key.fragmentShader == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load debug shaders");
+      return 0;
+  }
+  key.layout = debug->pipelineLayout;
+  key.vertexStride = sizeof(VSDL_DebugVertex);
+  key.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+  key.attributeCount = 2;
+  key.attributes[0] = (VSDL_VertexAttribute){0, VK_FORMAT_R32G32_SFLOAT, offsetof(VSDL_DebugVertex, pos)};
+  key.attributes[1] = (VSDL_VertexAttribute){1, VK_FORMAT_R8G8B8A8_UNORM, offsetof(VSDL_DebugVertex, color)};
+  key.cullMode = VK_CULL_MODE_NONE;
+  key.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+  // Padding vertices have zero alpha
+  key.blend = VSDL_BLEND_ALPHA;
+  key.topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+  debug->pipelines[VSDL_DEBUG_LINES] = vsdl_pipeline_get(ctx, &key);
+  key.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+  debug->pipelines[VSDL_DEBUG_TRIANGLES] = vsdl_pipeline_get(ctx, &key);
+  if (debug->pipelines[VSDL_DEBUG_LINES] == VK_NULL_HANDLE || debug->pipelines[VSDL_DEBUG_TRIANGLES] == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create debug pipelines");
+      return 0;
+  }
+
+  const uint32_t capacities[VSDL_DEBUG_PRIMITIVE_COUNT] = {64 * VSDL_DEBUG_CHUNK_VERTICES, 32 * VSDL_DEBUG_CHUNK_VERTICES};
+  for (uint32_t i = 0; i < VSDL_FRAME_PACKETS; i++) {
+      if (!create_buffer(ctx, &debug->frames[i], capacities)) return 0;
+  }
+  SDL_Log("Debug draw initialized");
+  return 1;
+}
+
+void vsdl_debug_begin(VSDL_Context* ctx, VSDL_FramePacket* packet) {
+  VSDL_DebugFrame* frame = packet_frame(ctx, packet);
+  if (frame->buffer == VK_NULL_HANDLE) return;
+  // Usually reached already: the render thread waited for this frame before recording the next one
+  vsdl_sync_wait(ctx, frame->retireValue);
+  for (uint32_t type = 0; type < VSDL_DEBUG_PRIMITIVE_COUNT; type++) {
+      VSDL_DebugRegion* region = &frame->regions[type];
+      uint32_t reserved = (uint32_t)SDL_GetAtomicInt(&region->reserved);
+      uint32_t used = reserved < region->capacity ? reserved : region->capacity;
+      memset(region->chunkFill, 0, (used / VSDL_DEBUG_CHUNK_VERTICES) * sizeof(uint32_t));
+      SDL_SetAtomicInt(&region->reserved, 0);
+  }
+}
+
+static DebugThread* thread_state(const VSDL_DebugFrame* frame, uint64_t frameNumber) {
+  DebugThread* thread = (DebugThread*)SDL_GetTLS(&threadState);
+  if (!thread) {
+      thread = (DebugThread*)SDL_calloc(1, sizeof(DebugThread));
+      if (!thread) return NULL;
+      if (!SDL_SetTLS(&threadState, thread, SDL_free)) {
+          SDL_free(thread);
+          return NULL;
+      }
+  }
+  // First shape this thread adds to this packet
+  if (thread->frame != frame || thread->frameNumber != frameNumber) {
+      SDL_memset(thread, 0, sizeof(*thread));
+      thread->frame = frame;
+      thread->frameNumber = frameNumber;
+  }
+  return thread;
+}
+
+// Lock-free: one atomic add claims a chunk, which only this thread then writes. count divides
+// into whole primitives of the region's type and never exceeds a chunk
+static VSDL_DebugVertex* reserve_vertices(VSDL_Context* ctx, VSDL_DebugPrimitive type, uint32_t count) {
+  const VSDL_FramePacket* packet = ctx->renderThread.building;
+  if (!packet) return NULL;
+  VSDL_DebugFrame* frame = packet_frame(ctx, packet);
+  if (!frame->vertices) return NULL;
+  DebugThread* thread = thread_state(frame, packet->frameNumber);
+  if (!thread) return NULL;
+
+  VSDL_DebugRegion* region = &frame->regions[type];
+  if (thread->end[type] - thread->next[type] < count) {
+      // The rest of the old chunk is padded when the frame is recorded
+      if (thread->full[type]) return NULL;
+      uint32_t start = (uint32_t)SDL_AddAtomicInt(&region->reserved, VSDL_DEBUG_CHUNK_VERTICES);
+      if (start + VSDL_DEBUG_CHUNK_VERTICES > region->capacity) {
+          thread->full[type] = 1;
+          return NULL;
+      }
+      thread->next[type] = start;
+      thread->end[type] = start + VSDL_DEBUG_CHUNK_VERTICES;
+  }
+  uint32_t first = thread->next[type];
+  thread->next[type] += count;
+  uint32_t chunk = first / VSDL_DEBUG_CHUNK_VERTICES;
+  region->chunkFill[chunk] = thread->next[type] - chunk * VSDL_DEBUG_CHUNK_VERTICES;
+  return frame->vertices + region->offset + first;
+}
+
+void vsdl_debug_line(VSDL_Context* ctx, float x0, float y0, float x1, float y1, uint32_t color) {
+  VSDL_DebugVertex* out = reserve_vertices(ctx, VSDL_DEBUG_LINES, 2);
+  if (!out) return;
+  out[0] = (VSDL_DebugVertex){{x0, y0}, color};
+  out[1] = (VSDL_DebugVertex){{x1, y1}, color};
+}
+
+void vsdl_debug_box(VSDL_Context* ctx, float x, float y, float width, float height, uint32_t color) {
+  VSDL_DebugVertex* out = reserve_vertices(ctx, VSDL_DEBUG_LINES, 8);
+  if (!out) return;
+  const float corners[5][2] = {{x, y}, {x + width, y}, {x + width, y + height}, {x, y + height}, {x, y}};
+  for (int i = 0; i < 4; i++) {
+      out[2 * i] = (VSDL_DebugVertex){{corners[i][0], corners[i][1]}, color};
+      out[2 * i + 1] = (VSDL_DebugVertex){{corners[i + 1][0], corners[i + 1][1]}, color};
+  }
+}
+
+void vsdl_debug_circle(VSDL_Context* ctx, float x, float y, float radius, uint32_t color) {
+  VSDL_DebugVertex* out = reserve_vertices(ctx, VSDL_DEBUG_LINES, 2 * VSDL_DEBUG_CIRCLE_SEGMENTS);
+  if (!out) return;
+  const VSDL_DebugDraw* debug = &ctx->debugDraw;
+  for (uint32_t i = 0; i < VSDL_DEBUG_CIRCLE_SEGMENTS; i++) {
+      out[2 * i] = (VSDL_DebugVertex){{x + radius * debug->circle[i][0], y + radius * debug->circle[i][1]}, color};
+      out[2 * i + 1] = (VSDL_DebugVertex){{x + radius * debug->circle[i + 1][0], y + radius * debug->circle[i + 1][1]}, color};
+  }
+}
+
+void vsdl_debug_triangle(VSDL_Context* ctx, float x0, float y0, float x1, float y1, float x2, float y2,
+                         uint32_t color) {
+  VSDL_DebugVertex* out = reserve_vertices(ctx, VSDL_DEBUG_TRIANGLES, 3);
+  if (!out) return;
+  out[0] = (VSDL_DebugVertex){{x0, y0}, color};
+  out[1] = (VSDL_DebugVertex){{x1, y1}, color};
+  out[2] = (VSDL_DebugVertex){{x2, y2}, color};
+}
+
+void vsdl_debug_fill_box(VSDL_Context* ctx, float x, float y, float width, float height, uint32_t color) {
+  VSDL_DebugVertex* out = reserve_vertices(ctx, VSDL_DEBUG_TRIANGLES, 6);
+  if (!out) return;
+  out[0] = (VSDL_DebugVertex){{x, y}, color};
+  out[1] = (VSDL_DebugVertex){{x + width, y}, color};
+  out[2] = (VSDL_DebugVertex){{x + width, y + height}, color};
+  out[3] = (VSDL_DebugVertex){{x, y}, color};
+  out[4] = (VSDL_DebugVertex){{x + width, y + height}, color};
+  out[5] = (VSDL_DebugVertex){{x, y + height}, color};
+}
+
+void vsdl_debug_fill_circle(VSDL_Context* ctx, float x, float y, float radius, uint32_t color) {
+  VSDL_DebugVertex* out = reserve_vertices(ctx, VSDL_DEBUG_TRIANGLES, 3 * VSDL_DEBUG_CIRCLE_SEGMENTS);
+  if (!out) return;
+  const VSDL_DebugDraw* debug = &ctx->debugDraw;
+  for (uint32_t i = 0; i < VSDL_DEBUG_CIRCLE_SEGMENTS; i++) {
+      out[3 * i] = (VSDL_DebugVertex){{x, y}, color};
+      out[3 * i + 1] = (VSDL_DebugVertex){{x + radius * debug->circle[i][0], y + radius * debug->circle[i][1]}, color};
+      out[3 * i + 2] = (VSDL_DebugVertex){{x + radius * debug->circle[i + 1][0], y + radius * debug->circle[i + 1][1]}, color};
+  }
+}
+
+void vsdl_debug_record(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_FramePacket* packet) {
+  VSDL_DebugDraw* debug = &ctx->debugDraw;
+  VSDL_DebugFrame* frame = packet_frame(ctx, packet);
+  if (frame->buffer == VK_NULL_HANDLE || debug->pipelineLayout == VK_NULL_HANDLE) return;
+
+  // The threads that filled the chunks finished before the packet was submitted. Whatever they left
+  // of a chunk becomes zero-alpha padding, so each region stays one contiguous draw
+  const VSDL_DebugVertex padding = {{0.0f, 0.0f}, 0};
+  uint32_t counts[VSDL_DEBUG_PRIMITIVE_COUNT];
+  uint32_t total = 0;
+  for (uint32_t type = 0; type < VSDL_DEBUG_PRIMITIVE_COUNT; type++) {
+      VSDL_DebugRegion* region = &frame->regions[type];
+      uint32_t reserved = (uint32_t)SDL_GetAtomicInt(&region->reserved);
+      uint32_t count = reserved < region->capacity ? reserved : region->capacity;
+      VSDL_DebugVertex* out = frame->vertices + region->offset;
+      for (uint32_t chunk = 0; chunk < count / VSDL_DEBUG_CHUNK_VERTICES; chunk++) {
+          uint32_t base = chunk * VSDL_DEBUG_CHUNK_VERTICES;
+          for (uint32_t v = region->chunkFill[chunk]; v < VSDL_DEBUG_CHUNK_VERTICES; v++) out[base + v] = padding;
+      }
+      counts[type] = count;
+      total += count;
+  }
+  if (total == 0) return;
+
+  DebugPushConstants push = {{2.0f / (float)ctx->swapchainExtent.width, 2.0f / (float)ctx->swapchainExtent.height}};
+  vkCmdPushConstants(commandBuffer, debug->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(push), &push);
+  VkDeviceSize offset = 0;
+  vkCmdBindVertexBuffers(commandBuffer, 0, 1, &frame->buffer, &offset);
+  for (uint32_t type = 0; type < VSDL_DEBUG_PRIMITIVE_COUNT; type++) {
+      if (counts[type] == 0) continue;
+      vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline_resolve(ctx, debug->pipelines[type]));
+      vkCmdDraw(commandBuffer, counts[type], 1, frame->regions[type].offset, 0);
+  }
+}
+
+void vsdl_debug_end_frame(VSDL_Context* ctx, const VSDL_FramePacket* packet) {
+  VSDL_DebugFrame* frame = packet_frame(ctx, packet);
+  if (frame->buffer == VK_NULL_HANDLE) return;
+  frame->retireValue = ctx->frameValue;
+
+  // Claims past the end were dropped; size the buffer for them before the packet comes back
+  uint32_t capacities[VSDL_DEBUG_PRIMITIVE_COUNT];
+  int grow = 0;
+  for (uint32_t type = 0; type < VSDL_DEBUG_PRIMITIVE_COUNT; type++) {
+      const VSDL_DebugRegion* region = &frame->regions[type];
+      uint32_t reserved = (uint32_t)SDL_GetAtomicInt(&region->reserved);
+      capacities[type] = region->capacity;
+      while (capacities[type] < reserved) capacities[type] *= 2;
+      grow |= capacities[type] != region->capacity;
+  }
+  if (!grow) return;
+  vsdl_sync_defer_buffer(ctx, frame->buffer, frame->allocation);
+  frame->buffer = VK_NULL_HANDLE;
+  frame->allocation = NULL;
+  frame->vertices = NULL;
+  if (create_buffer(ctx, frame, capacities)) {
+      SDL_Log("Debug vertex buffer grown to %u lines, %u triangles", capacities[VSDL_DEBUG_LINES] / 2,
+              capacities[VSDL_DEBUG_TRIANGLES] / 3);
+  }
+}
+
+void vsdl_debug_shutdown(VSDL_Context* ctx) {
+  VSDL_DebugDraw* debug = &ctx->debugDraw;
+  if (ctx->device == VK_NULL_HANDLE) return;
+  for (uint32_t i = 0; i < VSDL_FRAME_PACKETS; i++) {
+      VSDL_DebugFrame* frame = &debug->frames[i];
+      destroy_buffer(ctx, frame);
+      for (uint32_t type = 0; type < VSDL_DEBUG_PRIMITIVE_COUNT; type++) SDL_free(frame->regions[type].chunkFill);
+  }
+  // Pipelines and layout belong to the pipeline registry
+  SDL_memset(debug, 0, sizeof(*debug));
+}
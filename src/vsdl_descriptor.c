@@ -0,0 +1,388 @@
+// #define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+// #include <volk.h>
+#include <SDL3/SDL.h>
+#include "vsdl_descriptor.h"
+#include "vsdl_types.h"
+#include "vsdl_sync.h"
+
+#define FIRST_POOL_SETS 64
+#define MAX_POOL_SETS 4096
+
+// Descriptors per set each pool is sized for; sets that need more just fill a pool sooner
+static const struct {
+  VkDescriptorType type;
+  float perSet;
+} poolRatios[] = {
+  {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f},
+  {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0f},
+  {VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f},
+  {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.0f},
+  {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f},
+  {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 0.5f},
+};
+
+static VkDescriptorPool create_pool(VSDL_Context* ctx, uint32_t sets, VkDescriptorPoolCreateFlags flags) {
+  VkDescriptorPoolSize sizes[SDL_arraysize(poolRatios)];
+  for (uint32_t i = 0; i < SDL_arraysize(poolRatios); i++) {
+      sizes[i].type = poolRatios[i].type;
+      sizes[i].descriptorCount = SDL_max((uint32_t)(poolRatios[i].perSet * (float)sets), 1u);
+  }
+  VkDescriptorPoolCreateInfo poolInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+  poolInfo.flags = flags;
+  poolInfo.maxSets = sets;
+  poolInfo.poolSizeCount = SDL_arraysize(sizes);
+  poolInfo.pPoolSizes = sizes;
+  VkDescriptorPool pool = VK_NULL_HANDLE;
+  if (vkCreateDescriptorPool(ctx->device, &poolInfo, NULL, &pool) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create descriptor pool (%u sets)", sets);
+      return VK_NULL_HANDLE;
+  }
+  return pool;
+}
+
+static int push_pool(VkDescriptorPool** pools, uint32_t* count, uint32_t* capacity, VkDescriptorPool pool) {
+  if (*count == *capacity) {
+      uint32_t grown = *capacity ? *capacity * 2 : 4;
+      VkDescriptorPool* items = (VkDescriptorPool*)SDL_realloc(*pools, grown * sizeof(VkDescriptorPool));
+      if (!items) return 0;
+      *pools = items;
+      *capacity = grown;
+  }
+  (*pools)[(*count)++] = pool;
+  return 1;
+}
+
+// The last ready pool is the one being allocated from; full pools wait for the next reset or a freed set
+static VkDescriptorSet allocate(VSDL_Context* ctx, VSDL_DescriptorAllocator* allocator, VkDescriptorSetLayout layout,
+                                VkDescriptorPool* outPool) {
+  for (;;) {
+      int created = allocator->readyCount == 0;
+      if (created) {
+          VkDescriptorPool pool = create_pool(ctx, allocator->setsPerPool, allocator->poolFlags);
+          if (pool == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+          if (!push_pool(&allocator->ready, &allocator->readyCount, &allocator->readyCapacity, pool)) {
+              vkDestroyDescriptorPool(ctx->device, pool, NULL);
+              return VK_NULL_HANDLE;
+          }
+          allocator->setsPerPool = SDL_min(allocator->setsPerPool + allocator->setsPerPool / 2, (uint32_t)MAX_POOL_SETS);
+      }
+
+      VkDescriptorPool pool = allocator->ready[allocator->readyCount - 1];
+      VkDescriptorSetAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+      allocInfo.descriptorPool = pool;
+      allocInfo.descriptorSetCount = 1;
+      allocInfo.pSetLayouts = &layout;
+      VkDescriptorSet set = VK_NULL_HANDLE;
+      VkResult result = vkAllocateDescriptorSets(ctx->device, &allocInfo, &set);
+      if (result == VK_SUCCESS) {
+          if (outPool) *outPool = pool;
+          return set;
+      }
+      // A fresh pool that cannot hold the set will not do better on a retry
+      if (created || (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)) break;
+
+      allocator->readyCount--;
+      if (!push_pool(&allocator->full, &allocator->fullCount, &allocator->fullCapacity, pool)) {
+          vkDestroyDescriptorPool(ctx->device, pool, NULL);
+      }
+  }
+  SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate descriptor set");
+  return VK_NULL_HANDLE;
+}
+
+static void reset_allocator(VSDL_Context* ctx, VSDL_DescriptorAllocator* allocator) {
+  for (uint32_t i = 0; i < allocator->readyCount; i++) {
+      vkResetDescriptorPool(ctx->device, allocator->ready[i], 0);
+  }
+  for (uint32_t i = 0; i < allocator->fullCount; i++) {
+      vkResetDescriptorPool(ctx->device, allocator->full[i], 0);
+      // Untracked pools would only be destroyed at shutdown; an empty one is cheap to recreate
+      if (!push_pool(&allocator->ready, &allocator->readyCount, &allocator->readyCapacity, allocator->full[i])) {
+          vkDestroyDescriptorPool(ctx->device, allocator->full[i], NULL);
+      }
+  }
+  allocator->fullCount = 0;
+}
+
+// A freed set makes room again, so its pool goes back to ready, ahead of the one being allocated from
+static void free_set(VSDL_Context* ctx, VSDL_DescriptorAllocator* allocator, VkDescriptorPool pool, VkDescriptorSet set) {
+  vkFreeDescriptorSets(ctx->device, pool, 1, &set);
+  for (uint32_t i = 0; i < allocator->fullCount; i++) {
+      if (allocator->full[i] != pool) continue;
+      if (!push_pool(&allocator->ready, &allocator->readyCount, &allocator->readyCapacity, pool)) return;
+      SDL_memmove(allocator->ready + 1, allocator->ready, (allocator->readyCount - 1) * sizeof(VkDescriptorPool));
+      allocator->ready[0] = pool;
+      allocator->full[i] = allocator->full[--allocator->fullCount];
+      return;
+  }
+}
+
+static void destroy_allocator(VSDL_Context* ctx, VSDL_DescriptorAllocator* allocator) {
+  for (uint32_t i = 0; i < allocator->readyCount; i++) vkDestroyDescriptorPool(ctx->device, allocator->ready[i], NULL);
+  for (uint32_t i = 0; i < allocator->fullCount; i++) vkDestroyDescriptorPool(ctx->device, allocator->full[i], NULL);
+  SDL_free(allocator->ready);
+  SDL_free(allocator->full);
+  SDL_memset(allocator, 0, sizeof(*allocator));
+}
+
+// FNV-1a over the fields that identify a binding, not the struct bytes, so padding never matters
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t size) {
+  const unsigned char* bytes = (const unsigned char*)data;
+  for (size_t i = 0; i < size; i++) {
+      hash ^= bytes[i];
+      hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+static uint64_t hash_bindings(VkDescriptorSetLayout layout, const VSDL_DescriptorBinding* bindings, uint32_t count) {
+  uint64_t hash = 14695981039346656037ull;
+  hash = hash_bytes(hash, &layout, sizeof(layout));
+  for (uint32_t i = 0; i < count; i++) {
+      const VSDL_DescriptorBinding* b = &bindings[i];
+      hash = hash_bytes(hash, &b->binding, sizeof(b->binding));
+      hash = hash_bytes(hash, &b->type, sizeof(b->type));
+      hash = hash_bytes(hash, &b->sampler, sizeof(b->sampler));
+      hash = hash_bytes(hash, &b->imageView, sizeof(b->imageView));
+      hash = hash_bytes(hash, &b->imageLayout, sizeof(b->imageLayout));
+      hash = hash_bytes(hash, &b->buffer, sizeof(b->buffer));
+      hash = hash_bytes(hash, &b->offset, sizeof(b->offset));
+      hash = hash_bytes(hash, &b->range, sizeof(b->range));
+  }
+  return hash ? hash : 1;  // 0 marks an empty cache slot
+}
+
+static int same_bindings(const VSDL_DescriptorBinding* a, const VSDL_DescriptorBinding* b, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+      if (a[i].binding != b[i].binding || a[i].type != b[i].type || a[i].sampler != b[i].sampler ||
+          a[i].imageView != b[i].imageView || a[i].imageLayout != b[i].imageLayout ||
+          a[i].buffer != b[i].buffer || a[i].offset != b[i].offset || a[i].range != b[i].range) {
+          return 0;
+      }
+  }
+  return 1;
+}
+
+static VSDL_DescriptorCacheEntry* find_slot(VSDL_DescriptorCacheEntry* entries, uint32_t capacity, uint64_t hash,
+                                            VkDescriptorSetLayout layout, const VSDL_DescriptorBinding* bindings,
+                                            uint32_t count) {
+  uint32_t mask = capacity - 1;
+  for (uint32_t i = (uint32_t)hash & mask;; i = (i + 1) & mask) {
+      VSDL_DescriptorCacheEntry* entry = &entries[i];
+      if (entry->hash == 0) return entry;
+      if (entry->hash == hash && entry->layout == layout && entry->bindingCount == count &&
+          same_bindings(entry->bindings, bindings, count)) {
+          return entry;
+      }
+  }
+}
+
+// Keeps the load under 70% so probes stay short
+static int grow_cache(VSDL_Descriptors* descriptors) {
+  uint32_t capacity = descriptors->entryCapacity ? descriptors->entryCapacity * 2 : 64;
+  VSDL_DescriptorCacheEntry* entries = (VSDL_DescriptorCacheEntry*)SDL_calloc(capacity, sizeof(VSDL_DescriptorCacheEntry));
+  if (!entries) return 0;
+  for (uint32_t i = 0; i < descriptors->entryCapacity; i++) {
+      const VSDL_DescriptorCacheEntry* old = &descriptors->entries[i];
+      if (old->hash == 0) continue;
+      *find_slot(entries, capacity, old->hash, old->layout, old->bindings, old->bindingCount) = *old;
+  }
+  SDL_free(descriptors->entries);
+  descriptors->entries = entries;
+  descriptors->entryCapacity = capacity;
+  return 1;
+}
+
+static void write_bindings(VSDL_Context* ctx, VkDescriptorSet set, const VSDL_DescriptorBinding* bindings, uint32_t count) {
+  VkDescriptorImageInfo imageInfos[VSDL_DESCRIPTOR_MAX_BINDINGS];
+  VkDescriptorBufferInfo bufferInfos[VSDL_DESCRIPTOR_MAX_BINDINGS];
+  VkWriteDescriptorSet writes[VSDL_DESCRIPTOR_MAX_BINDINGS];
+  for (uint32_t i = 0; i < count; i++) {
+      const VSDL_DescriptorBinding* b = &bindings[i];
+      VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+      write.dstSet = set;
+      write.dstBinding = b->binding;
+      write.descriptorCount = 1;
+      write.descriptorType = b->type;
+      if (b->buffer != VK_NULL_HANDLE) {
+          bufferInfos[i] = (VkDescriptorBufferInfo){b->buffer, b->offset, b->range};
+          write.pBufferInfo = &bufferInfos[i];
+      } else {
+          imageInfos[i] = (VkDescriptorImageInfo){b->sampler, b->imageView, b->imageLayout};
+          write.pImageInfo = &imageInfos[i];
+      }
+      writes[i] = write;
+  }
+  vkUpdateDescriptorSets(ctx->device, count, writes, 0, NULL);
+}
+
+int vsdl_descriptors_init(VSDL_Context* ctx) {
+  VSDL_Descriptors* descriptors = &ctx->descriptors;
+  descriptors->lock = SDL_CreateMutex();
+  if (!descriptors->lock) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create descriptor mutex: %s", SDL_GetError());
+      return 0;
+  }
+  descriptors->persistent.setsPerPool = FIRST_POOL_SETS;
+  descriptors->persistent.poolFlags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+  descriptors->frame.setsPerPool = FIRST_POOL_SETS;
+  if (!grow_cache(descriptors)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate descriptor cache");
+      return 0;
+  }
+  SDL_Log("Descriptor allocator initialized");
+  return 1;
+}
+
+VkDescriptorSet vsdl_descriptor_alloc(VSDL_Context* ctx, VkDescriptorSetLayout layout) {
+  VSDL_Descriptors* descriptors = &ctx->descriptors;
+  SDL_LockMutex(descriptors->lock);
+  VkDescriptorSet set = allocate(ctx, &descriptors->persistent, layout, NULL);
+  SDL_UnlockMutex(descriptors->lock);
+  return set;
+}
+
+VkDescriptorSet vsdl_descriptor_alloc_frame(VSDL_Context* ctx, VkDescriptorSetLayout layout,
+                                            const VSDL_DescriptorBinding* bindings, uint32_t count) {
+  VSDL_Descriptors* descriptors = &ctx->descriptors;
+  if (count > VSDL_DESCRIPTOR_MAX_BINDINGS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Too many descriptor bindings (%u)", count);
+      return VK_NULL_HANDLE;
+  }
+  SDL_LockMutex(descriptors->lock);
+  VkDescriptorSet set = allocate(ctx, &descriptors->frame, layout, NULL);
+  SDL_UnlockMutex(descriptors->lock);
+  if (set != VK_NULL_HANDLE) write_bindings(ctx, set, bindings, count);
+  return set;
+}
+
+VkDescriptorSet vsdl_descriptor_get(VSDL_Context* ctx, VkDescriptorSetLayout layout,
+                                    const VSDL_DescriptorBinding* bindings, uint32_t count) {
+  VSDL_Descriptors* descriptors = &ctx->descriptors;
+  if (count > VSDL_DESCRIPTOR_MAX_BINDINGS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Too many descriptor bindings (%u)", count);
+      return VK_NULL_HANDLE;
+  }
+  uint64_t hash = hash_bindings(layout, bindings, count);
+
+  SDL_LockMutex(descriptors->lock);
+  VSDL_DescriptorCacheEntry* entry = find_slot(descriptors->entries, descriptors->entryCapacity, hash, layout, bindings, count);
+  if (entry->hash != 0) {
+      descriptors->hits++;
+      VkDescriptorSet set = entry->set;
+      SDL_UnlockMutex(descriptors->lock);
+      return set;
+  }
+
+  VkDescriptorPool pool = VK_NULL_HANDLE;
+  VkDescriptorSet set = allocate(ctx, &descriptors->persistent, layout, &pool);
+  if (set != VK_NULL_HANDLE) {
+      write_bindings(ctx, set, bindings, count);
+      if ((descriptors->entryCount + 1) * 10 > descriptors->entryCapacity * 7) {
+          if (grow_cache(descriptors)) {
+              entry = find_slot(descriptors->entries, descriptors->entryCapacity, hash, layout, bindings, count);
+          } else {
+              entry = NULL;  // Still usable, just not cached
+          }
+      }
+      if (entry) {
+          entry->hash = hash;
+          entry->layout = layout;
+          SDL_memcpy(entry->bindings, bindings, count * sizeof(VSDL_DescriptorBinding));
+          entry->bindingCount = count;
+          entry->set = set;
+          entry->pool = pool;
+          descriptors->entryCount++;
+      }
+      descriptors->misses++;
+  }
+  SDL_UnlockMutex(descriptors->lock);
+  return set;
+}
+
+static void retire_set(VSDL_Descriptors* descriptors, const VSDL_DescriptorCacheEntry* entry, uint64_t value) {
+  if (descriptors->retiredCount == descriptors->retiredCapacity) {
+      uint32_t grown = descriptors->retiredCapacity ? descriptors->retiredCapacity * 2 : 16;
+      VSDL_RetiredDescriptorSet* items = (VSDL_RetiredDescriptorSet*)SDL_realloc(descriptors->retired,
+                                                                                 grown * sizeof(VSDL_RetiredDescriptorSet));
+      if (!items) return;  // Stays in its pool until shutdown
+      descriptors->retired = items;
+      descriptors->retiredCapacity = grown;
+  }
+  VSDL_RetiredDescriptorSet* retired = &descriptors->retired[descriptors->retiredCount++];
+  retired->set = entry->set;
+  retired->pool = entry->pool;
+  retired->value = value;
+}
+
+static int uses_view(const VSDL_DescriptorCacheEntry* entry, VkImageView view) {
+  for (uint32_t b = 0; b < entry->bindingCount; b++) {
+      if (entry->bindings[b].imageView == view) return 1;
+  }
+  return 0;
+}
+
+// Linear probing: later entries of the same run shift back into the hole so no probe chain breaks
+static void remove_slot(VSDL_DescriptorCacheEntry* entries, uint32_t capacity, uint32_t hole) {
+  uint32_t mask = capacity - 1;
+  for (uint32_t i = (hole + 1) & mask; entries[i].hash != 0; i = (i + 1) & mask) {
+      uint32_t home = (uint32_t)entries[i].hash & mask;
+      // Entries whose home lies between the hole and their slot stay where they are
+      if (((i - home) & mask) >= ((i - hole) & mask)) {
+          entries[hole] = entries[i];
+          hole = i;
+      }
+  }
+  SDL_memset(&entries[hole], 0, sizeof(entries[hole]));
+}
+
+// Rare (a texture view being replaced). Entries are removed one at a time in place, so nothing has
+// to be allocated and the sets that do not use the view stay cached for the callers holding them
+void vsdl_descriptor_forget_view(VSDL_Context* ctx, VkImageView view) {
+  VSDL_Descriptors* descriptors = &ctx->descriptors;
+  // Frames already submitted may still bind the sets; anything recorded later looks the view up again
+  uint64_t value = vsdl_sync_submitted(ctx);
+  SDL_LockMutex(descriptors->lock);
+  for (uint32_t i = 0; i < descriptors->entryCapacity;) {
+      const VSDL_DescriptorCacheEntry* entry = &descriptors->entries[i];
+      if (entry->hash == 0 || !uses_view(entry, view)) {
+          i++;
+          continue;
+      }
+      retire_set(descriptors, entry, value);
+      // The slot now holds a shifted entry (or nothing), so it is looked at again
+      remove_slot(descriptors->entries, descriptors->entryCapacity, i);
+      descriptors->entryCount--;
+  }
+  SDL_UnlockMutex(descriptors->lock);
+}
+
+void vsdl_descriptor_begin_frame(VSDL_Context* ctx) {
+  VSDL_Descriptors* descriptors = &ctx->descriptors;
+  SDL_LockMutex(descriptors->lock);
+  reset_allocator(ctx, &descriptors->frame);
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < descriptors->retiredCount; i++) {
+      VSDL_RetiredDescriptorSet* retired = &descriptors->retired[i];
+      if (vsdl_sync_reached(ctx, retired->value)) {
+          free_set(ctx, &descriptors->persistent, retired->pool, retired->set);
+      } else {
+          descriptors->retired[kept++] = *retired;
+      }
+  }
+  descriptors->retiredCount = kept;
+  SDL_UnlockMutex(descriptors->lock);
+}
+
+void vsdl_descriptors_shutdown(VSDL_Context* ctx) {
+  VSDL_Descriptors* descriptors = &ctx->descriptors;
+  if (ctx->device != VK_NULL_HANDLE) {
+      destroy_allocator(ctx, &descriptors->frame);
+      destroy_allocator(ctx, &descriptors->persistent);
+  }
+  SDL_free(descriptors->entries);
+  SDL_free(descriptors->retired);
+  if (descriptors->lock) SDL_DestroyMutex(descriptors->lock);
+  SDL_memset(descriptors, 0, sizeof(*descriptors));
+}
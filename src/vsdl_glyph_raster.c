@@ -0,0 +1,151 @@
+#include <SDL3/SDL.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include "vsdl_glyph_raster.h"
+#include "vsdl_types.h"
+#include "vsdl_workers.h"
+#include "vsdl_idle.h"
+
+// FreeType objects are not thread-safe, so each thread opens its own face over the shared font data
+static FT_Face thread_face(VSDL_GlyphRaster* raster) {
+  uint32_t slot = vsdl_workers_thread_slot();
+  if (raster->faces[slot]) return raster->faces[slot];
+
+  if (FT_Init_FreeType(&raster->libraries[slot])) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to initialize FreeType on worker %u", slot);
+      raster->libraries[slot] = NULL;
+      return NULL;
+  }
+  if (FT_New_Memory_Face(raster->libraries[slot], (const FT_Byte*)raster->fontData, (FT_Long)raster->fontSize, 0,
+                         &raster->faces[slot])) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to open font face on worker %u", slot);
+      FT_Done_FreeType(raster->libraries[slot]);
+      raster->libraries[slot] = NULL;
+      raster->faces[slot] = NULL;
+      return NULL;
+  }
+  FT_Set_Pixel_Sizes(raster->faces[slot], 0, raster->pixelHeight);
+  return raster->faces[slot];
+}
+
+static void rasterize_batch(void* data) {
+  VSDL_GlyphBatch* batch = (VSDL_GlyphBatch*)data;
+  VSDL_GlyphRaster* raster = batch->raster;
+  // Held from opening the face to the last glyph, so two non-worker threads never share it at once
+  int shared = vsdl_workers_thread_slot() == VSDL_MAX_WORKERS;
+  if (shared) SDL_LockMutex(raster->sharedFaceLock);
+  FT_Face face = thread_face(raster);
+
+  for (uint32_t i = 0; face && i < batch->count; i++) {
+      VSDL_RasterGlyph* glyph = &batch->glyphs[i];
+      if (FT_Load_Char(face, glyph->codepoint, FT_LOAD_RENDER)) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load glyph U+%04X", glyph->codepoint);
+          continue;
+      }
+      FT_GlyphSlot slot = face->glyph;
+      glyph->advance = (float)(slot->advance.x >> 6);
+      if (!slot->bitmap.buffer || slot->bitmap.width == 0 || slot->bitmap.rows == 0) continue;
+
+      glyph->bitmap = (unsigned char*)SDL_malloc((size_t)slot->bitmap.width * slot->bitmap.rows);
+      if (!glyph->bitmap) continue;
+      glyph->width = slot->bitmap.width;
+      glyph->rows = slot->bitmap.rows;
+      glyph->left = slot->bitmap_left;
+      glyph->top = slot->bitmap_top;
+      // Rows can be padded past the width, so copy by pitch
+      for (uint32_t row = 0; row < glyph->rows; row++) {
+          const unsigned char* src = slot->bitmap.buffer + (ptrdiff_t)row * slot->bitmap.pitch;
+          SDL_memcpy(glyph->bitmap + (size_t)row * glyph->width, src, glyph->width);
+      }
+  }
+  if (shared) SDL_UnlockMutex(raster->sharedFaceLock);
+  SDL_LockMutex(raster->doneLock);
+  SDL_SetAtomicInt(&batch->done, 1);
+  SDL_BroadcastCondition(raster->batchDone);
+  SDL_UnlockMutex(raster->doneLock);
+  vsdl_idle_wake();
+}
+
+static void destroy_locks(VSDL_GlyphRaster* raster) {
+  if (raster->batchDone) SDL_DestroyCondition(raster->batchDone);
+  if (raster->doneLock) SDL_DestroyMutex(raster->doneLock);
+  if (raster->sharedFaceLock) SDL_DestroyMutex(raster->sharedFaceLock);
+  raster->batchDone = NULL;
+  raster->doneLock = NULL;
+  raster->sharedFaceLock = NULL;
+}
+
+int vsdl_glyph_raster_begin(VSDL_Context* ctx, VSDL_GlyphRaster* raster, const void* fontData, size_t fontSize,
+                            uint32_t pixelHeight, uint32_t first, uint32_t last) {
+  SDL_memset(raster, 0, sizeof(*raster));
+  raster->fontData = fontData;
+  raster->fontSize = fontSize;
+  raster->pixelHeight = pixelHeight;
+  raster->sharedFaceLock = SDL_CreateMutex();
+  raster->doneLock = SDL_CreateMutex();
+  raster->batchDone = SDL_CreateCondition();
+  if (!raster->sharedFaceLock || !raster->doneLock || !raster->batchDone) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create glyph raster locks: %s", SDL_GetError());
+      destroy_locks(raster);
+      return 0;
+  }
+
+  uint32_t glyphCount = last - first + 1;
+  raster->batchCount = (glyphCount + VSDL_GLYPH_BATCH_SIZE - 1) / VSDL_GLYPH_BATCH_SIZE;
+  raster->batches = (VSDL_GlyphBatch*)SDL_calloc(raster->batchCount, sizeof(VSDL_GlyphBatch));
+  if (!raster->batches) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate glyph batches");
+      raster->batchCount = 0;
+      destroy_locks(raster);
+      return 0;
+  }
+
+  for (uint32_t b = 0; b < raster->batchCount; b++) {
+      VSDL_GlyphBatch* batch = &raster->batches[b];
+      batch->raster = raster;
+      batch->firstCodepoint = first + b * VSDL_GLYPH_BATCH_SIZE;
+      batch->count = SDL_min(VSDL_GLYPH_BATCH_SIZE, last + 1 - batch->firstCodepoint);
+      for (uint32_t i = 0; i < batch->count; i++) {
+          batch->glyphs[i].codepoint = batch->firstCodepoint + i;
+      }
+  }
+  // Queue after every batch is initialized; workers may start on the first one immediately
+  for (uint32_t b = 0; b < raster->batchCount; b++) {
+      if (!vsdl_workers_submit(ctx, rasterize_batch, &raster->batches[b])) {
+          rasterize_batch(&raster->batches[b]);
+      }
+  }
+  return 1;
+}
+
+const VSDL_GlyphBatch* vsdl_glyph_raster_next(VSDL_GlyphRaster* raster, int wait) {
+  if (raster->nextBatch >= raster->batchCount) return NULL;
+  VSDL_GlyphBatch* batch = &raster->batches[raster->nextBatch];
+  if (!SDL_GetAtomicInt(&batch->done)) {
+      if (!wait) return NULL;
+      SDL_LockMutex(raster->doneLock);
+      while (!SDL_GetAtomicInt(&batch->done)) SDL_WaitCondition(raster->batchDone, raster->doneLock);
+      SDL_UnlockMutex(raster->doneLock);
+  }
+  raster->nextBatch++;
+  return batch;
+}
+
+int vsdl_glyph_raster_finished(const VSDL_GlyphRaster* raster) {
+  return raster->nextBatch >= raster->batchCount;
+}
+
+void vsdl_glyph_raster_end(VSDL_GlyphRaster* raster) {
+  for (uint32_t b = 0; b < raster->batchCount; b++) {
+      for (uint32_t i = 0; i < raster->batches[b].count; i++) {
+          SDL_free(raster->batches[b].glyphs[i].bitmap);
+      }
+  }
+  SDL_free(raster->batches);
+  for (uint32_t slot = 0; slot <= VSDL_MAX_WORKERS; slot++) {
+      if (raster->faces[slot]) FT_Done_Face(raster->faces[slot]);
+      if (raster->libraries[slot]) FT_Done_FreeType(raster->libraries[slot]);
+  }
+  destroy_locks(raster);
+  SDL_memset(raster, 0, sizeof(*raster));
+}
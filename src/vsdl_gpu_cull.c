@@ -0,0 +1,383 @@
+// #define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+// #include <volk.h>
+#include <vk_mem_alloc.h>
+#include <SDL3/SDL_log.h>
+#include <string.h>
+#include "vsdl_gpu_cull.h"
+#include "vsdl_memory.h"
+#include "vsdl_types.h"
+#include "vsdl_graph.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_descriptor.h"
+#include "vsdl_upload.h"
+#include "vsdl_idle.h"
+
+typedef struct {
+  float planes[6][4];
+  uint32_t objectCount;
+  uint32_t compact;
+} CullPushConstants;
+
+static int create_buffer(VSDL_Context* ctx, VkDeviceSize size, VkBufferUsageFlags usage, int hostVisible,
+                         VkBuffer* buffer, VmaAllocation* allocation, void** mapped) {
+  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  bufferInfo.size = size;
+  bufferInfo.usage = usage;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  VmaAllocationCreateInfo allocInfo = {0};
+  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  if (hostVisible) {
+      allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  }
+
+  VmaAllocationInfo info;
+  if (!vsdl_memory_create_buffer(ctx, VSDL_MEMORY_TAG_MESH, &bufferInfo, &allocInfo, buffer, allocation, &info)) {
+      return 0;
+  }
+  if (mapped) *mapped = info.pMappedData;
+  return 1;
+}
+
+static int create_descriptors(VSDL_Context* ctx) {
+  VSDL_GpuCull* cull = &ctx->gpuCull;
+
+  VkDescriptorSetLayoutBinding bindings[5];
+  for (uint32_t i = 0; i < 5; i++) {
+      bindings[i].binding = i;
+      bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+      bindings[i].descriptorCount = 1;
+      bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+      bindings[i].pImmutableSamplers = NULL;
+  }
+  bindings[0].stageFlags |= VK_SHADER_STAGE_VERTEX_BIT;  // objects
+  bindings[4].stageFlags |= VK_SHADER_STAGE_VERTEX_BIT;  // visible ids
+
+  VkDescriptorSetLayoutCreateInfo layoutInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+  layoutInfo.bindingCount = 5;
+  layoutInfo.pBindings = bindings;
+  if (vkCreateDescriptorSetLayout(ctx->device, &layoutInfo, NULL, &cull->descriptorSetLayout) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create GPU cull descriptor set layout");
+      return 0;
+  }
+
+  VkBuffer buffers[5] = {cull->objectBuffer, cull->meshBuffer, cull->commandBuffer, cull->countBuffer, cull->visibleBuffer};
+  VSDL_DescriptorBinding descriptorBindings[5] = {0};
+  for (uint32_t i = 0; i < 5; i++) {
+      descriptorBindings[i].binding = i;
+      descriptorBindings[i].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+      descriptorBindings[i].buffer = buffers[i];
+      descriptorBindings[i].range = VK_WHOLE_SIZE;
+  }
+  cull->descriptorSet = vsdl_descriptor_get(ctx, cull->descriptorSetLayout, descriptorBindings, 5);
+  if (cull->descriptorSet == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate GPU cull descriptor set");
+      return 0;
+  }
+
+  VkPushConstantRange pushRange = {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullPushConstants)};
+  cull->pipelineLayout = vsdl_pipeline_layout(ctx, &cull->descriptorSetLayout, 1, &pushRange);
+  if (cull->pipelineLayout == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create GPU cull pipeline layout");
+      return 0;
+  }
+  return 1;
+}
+
+static int create_cull_pipeline(VSDL_Context* ctx) {
+  VkShaderModule compModule = vsdl_pipeline_shader(ctx, "shaders/cull.comp.spv");
+  if (compModule == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load cull compute shader");
+      return 0;
+  }
+
+  VkComputePipelineCreateInfo pipelineInfo = {VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
+  pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+  pipelineInfo.stage.module = compModule;
+  pipelineInfo.stage.pName = "main";
+  pipelineInfo.layout = ctx->gpuCull.pipelineLayout;
+
+  VkResult result = vkCreateComputePipelines(ctx->device, VK_NULL_HANDLE, 1, &pipelineInfo, NULL, &ctx->gpuCull.cullPipeline);
+  if (result != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create cull compute pipeline");
+      return 0;
+  }
+  return 1;
+}
+
+static int create_draw_pipeline(VSDL_Context* ctx) {
+  VSDL_PipelineKey key = {0};
+  key.vertexShader = vsdl_pipeline_shader(ctx, "shaders/cull_draw.vert.spv");
+  key.fragmentShader = vsdl_pipeline_shader(ctx, "shaders/shader2d.frag.spv");
+  if (key.vertexShader == VK_NULL_HANDLE || key.fragmentShader == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load GPU-driven draw shaders");
+      return 0;
+  }
+  key.layout = ctx->gpuCull.pipelineLayout;
+  key.vertexStride = sizeof(Vertex);
+  key.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+  key.attributeCount = 2;
+  key.attributes[0] = (VSDL_VertexAttribute){0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, pos)};
+  key.attributes[1] = (VSDL_VertexAttribute){1, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color)};
+  key.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+  key.cullMode = VK_CULL_MODE_NONE;
+  key.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+  key.blend = VSDL_BLEND_NONE;
+
+  ctx->gpuCull.drawPipeline = vsdl_pipeline_get(ctx, &key);
+  if (ctx->gpuCull.drawPipeline == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create GPU-driven draw pipeline");
+      return 0;
+  }
+  return 1;
+}
+
+int vsdl_init_gpu_cull(VSDL_Context* ctx, uint32_t maxObjects, uint32_t maxVertices, uint32_t maxIndices) {
+  VSDL_GpuCull* cull = &ctx->gpuCull;
+
+  // Compacted commands start at firstInstance = slot, which the vertex shader maps back to an object
+  if (!ctx->features.drawIndirectFirstInstance) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "GPU-driven rendering requires drawIndirectFirstInstance");
+      return 0;
+  }
+
+  cull->maxObjects = maxObjects;
+  // Whole-screen NDC box; near/far planes always pass for the 2D scene
+  const float ndcPlanes[6][4] = {
+      { 1.0f,  0.0f, 0.0f, 1.0f},
+      {-1.0f,  0.0f, 0.0f, 1.0f},
+      { 0.0f,  1.0f, 0.0f, 1.0f},
+      { 0.0f, -1.0f, 0.0f, 1.0f},
+      { 0.0f,  0.0f, 0.0f, 1.0f},
+      { 0.0f,  0.0f, 0.0f, 1.0f}
+  };
+  memcpy(cull->planes, ndcPlanes, sizeof(ndcPlanes));
+
+  // Objects change while earlier frames still cull from them, so they are staged rather than mapped
+  cull->objects = (GpuObject*)SDL_calloc(maxObjects, sizeof(GpuObject));
+  if (!cull->objects ||
+      !create_buffer(ctx, maxObjects * sizeof(GpuObject), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0,
+                     &cull->objectBuffer, &cull->objectAllocation, NULL) ||
+      !create_buffer(ctx, maxObjects * sizeof(GpuMesh), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 1,
+                     &cull->meshBuffer, &cull->meshAllocation, (void**)&cull->meshes) ||
+      !create_buffer(ctx, maxVertices * sizeof(Vertex), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 1,
+                     &cull->vertexBuffer, &cull->vertexAllocation, (void**)&cull->vertices) ||
+      !create_buffer(ctx, maxIndices * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 1,
+                     &cull->indexBuffer, &cull->indexAllocation, (void**)&cull->indices) ||
+      !create_buffer(ctx, maxObjects * sizeof(VkDrawIndexedIndirectCommand),
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, 0,
+                     &cull->commandBuffer, &cull->commandAllocation, NULL) ||
+      !create_buffer(ctx, sizeof(uint32_t),
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0,
+                     &cull->countBuffer, &cull->countAllocation, NULL) ||
+      !create_buffer(ctx, maxObjects * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0,
+                     &cull->visibleBuffer, &cull->visibleAllocation, NULL)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create GPU cull buffers");
+      vsdl_gpu_cull_shutdown(ctx);
+      return 0;
+  }
+
+  if (!create_descriptors(ctx) || !create_cull_pipeline(ctx) || !create_draw_pipeline(ctx)) {
+      vsdl_gpu_cull_shutdown(ctx);
+      return 0;
+  }
+
+  if (ctx->features.drawIndirectCount) {
+      cull->cmdDrawIndexedIndirectCount = (PFN_vkCmdDrawIndexedIndirectCountKHR)
+          vkGetDeviceProcAddr(ctx->device, "vkCmdDrawIndexedIndirectCountKHR");
+  }
+
+  SDL_Log("GPU cull initialized (max objects: %u, indirect count: %s)", maxObjects,
+          cull->cmdDrawIndexedIndirectCount ? "yes" : "no");
+  return 1;
+}
+
+uint32_t vsdl_gpu_cull_add_mesh(VSDL_Context* ctx, const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount) {
+  VSDL_GpuCull* cull = &ctx->gpuCull;
+  VmaAllocationInfo vertexInfo, indexInfo;
+  vmaGetAllocationInfo(ctx->allocator, cull->vertexAllocation, &vertexInfo);
+  vmaGetAllocationInfo(ctx->allocator, cull->indexAllocation, &indexInfo);
+  if ((cull->vertexCount + vertexCount) * sizeof(Vertex) > vertexInfo.size ||
+      (cull->indexCount + indexCount) * sizeof(uint32_t) > indexInfo.size ||
+      cull->meshCount >= cull->maxObjects) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "GPU cull mesh storage full");
+      return UINT32_MAX;
+  }
+
+  memcpy(cull->vertices + cull->vertexCount, vertices, vertexCount * sizeof(Vertex));
+  memcpy(cull->indices + cull->indexCount, indices, indexCount * sizeof(uint32_t));
+
+  GpuMesh mesh = {0};
+  mesh.indexCount = indexCount;
+  mesh.firstIndex = cull->indexCount;
+  mesh.vertexOffset = (int32_t)cull->vertexCount;
+  cull->meshes[cull->meshCount] = mesh;
+
+  cull->vertexCount += vertexCount;
+  cull->indexCount += indexCount;
+  return cull->meshCount++;
+}
+
+static void mark_dirty(VSDL_GpuCull* cull, uint32_t id) {
+  if (cull->dirtyFirst == cull->dirtyEnd) {
+      cull->dirtyFirst = id;
+      cull->dirtyEnd = id + 1;
+      return;
+  }
+  if (id < cull->dirtyFirst) cull->dirtyFirst = id;
+  if (id >= cull->dirtyEnd) cull->dirtyEnd = id + 1;
+}
+
+uint32_t vsdl_gpu_cull_add_object(VSDL_Context* ctx, const GpuObject* object) {
+  VSDL_GpuCull* cull = &ctx->gpuCull;
+  if (cull->objectCount >= cull->maxObjects) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "GPU cull object storage full");
+      return UINT32_MAX;
+  }
+  cull->objects[cull->objectCount] = *object;
+  mark_dirty(cull, cull->objectCount);
+  return cull->objectCount++;
+}
+
+void vsdl_gpu_cull_set_object(VSDL_Context* ctx, uint32_t id, const GpuObject* object) {
+  if (id < ctx->gpuCull.objectCount) {
+      ctx->gpuCull.objects[id] = *object;
+      mark_dirty(&ctx->gpuCull, id);
+  }
+}
+
+void vsdl_gpu_cull_set_frustum(VSDL_Context* ctx, const float planes[6][4]) {
+  memcpy(ctx->gpuCull.planes, planes, sizeof(ctx->gpuCull.planes));
+}
+
+void vsdl_gpu_cull_update(VSDL_Context* ctx) {
+  VSDL_GpuCull* cull = &ctx->gpuCull;
+  if (cull->dirtyFirst == cull->dirtyEnd) return;
+  VkDeviceSize size = (VkDeviceSize)(cull->dirtyEnd - cull->dirtyFirst) * sizeof(GpuObject);
+  VkCommandBuffer cmd = vsdl_upload_command_buffer(ctx);
+  if (cmd == VK_NULL_HANDLE || vsdl_upload_available(ctx) < size + 16) {
+      vsdl_request_redraw(ctx);  // Retry with the next batch
+      return;
+  }
+
+  // Culling and draws of frames submitted earlier may still read the objects being replaced
+  vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 0, NULL);
+  if (!vsdl_upload_buffer(ctx, cull->objectBuffer, (VkDeviceSize)cull->dirtyFirst * sizeof(GpuObject),
+                          cull->objects + cull->dirtyFirst, size)) {
+      vsdl_request_redraw(ctx);
+      return;
+  }
+  VkMemoryBarrier barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                       0, 1, &barrier, 0, NULL, 0, NULL);
+  cull->dirtyFirst = 0;
+  cull->dirtyEnd = 0;
+}
+
+void vsdl_gpu_cull_dispatch(VSDL_Context* ctx, VkCommandBuffer commandBuffer) {
+  VSDL_GpuCull* cull = &ctx->gpuCull;
+  if (cull->cullPipeline == VK_NULL_HANDLE || cull->objectCount == 0) return;
+
+  CullPushConstants push;
+  memcpy(push.planes, cull->planes, sizeof(push.planes));
+  push.objectCount = cull->objectCount;
+  push.compact = cull->cmdDrawIndexedIndirectCount ? 1u : 0u;
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cull->cullPipeline);
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cull->pipelineLayout, 0, 1, &cull->descriptorSet, 0, NULL);
+  vkCmdPushConstants(commandBuffer, cull->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push), &push);
+  vkCmdDispatch(commandBuffer, (cull->objectCount + 63) / 64, 1, 1);
+  // The render graph orders these writes before the draws that read them
+}
+
+static void execute_clear_pass(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_GraphPass* pass, void* data) {
+  (void)pass;
+  (void)data;
+  vkCmdFillBuffer(commandBuffer, ctx->gpuCull.countBuffer, 0, sizeof(uint32_t), 0);
+}
+
+static void execute_cull_pass(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_GraphPass* pass, void* data) {
+  (void)pass;
+  (void)data;
+  vsdl_gpu_cull_dispatch(ctx, commandBuffer);
+}
+
+void vsdl_gpu_cull_add_pass(VSDL_Context* ctx) {
+  VSDL_GpuCull* cull = &ctx->gpuCull;
+  cull->graphCommands = VSDL_GRAPH_NONE;
+  cull->graphCount = VSDL_GRAPH_NONE;
+  cull->graphVisible = VSDL_GRAPH_NONE;
+  if (cull->cullPipeline == VK_NULL_HANDLE || cull->objectCount == 0) return;
+
+  // The previous frame's draws may still read the results when this frame starts rewriting them
+  VkPipelineStageFlags drawStages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+  cull->graphCommands = vsdl_graph_import_buffer(ctx, "cull commands", cull->commandBuffer, drawStages, 0);
+  cull->graphCount = vsdl_graph_import_buffer(ctx, "cull count", cull->countBuffer, drawStages, 0);
+  cull->graphVisible = vsdl_graph_import_buffer(ctx, "cull visible", cull->visibleBuffer, drawStages, 0);
+  // Transfer commands are fine outside a render pass, which is all a compute pass gives them
+  uint32_t clear = vsdl_graph_add_pass(ctx, "cull count clear", VSDL_GRAPH_PASS_COMPUTE, execute_clear_pass, NULL);
+  vsdl_graph_use(ctx, clear, cull->graphCount, VSDL_GRAPH_TRANSFER_DST);
+  uint32_t pass = vsdl_graph_add_pass(ctx, "gpu cull", VSDL_GRAPH_PASS_COMPUTE, execute_cull_pass, NULL);
+  vsdl_graph_use(ctx, pass, cull->graphCommands, VSDL_GRAPH_STORAGE_WRITE);
+  vsdl_graph_use(ctx, pass, cull->graphCount, VSDL_GRAPH_STORAGE_WRITE);
+  vsdl_graph_use(ctx, pass, cull->graphVisible, VSDL_GRAPH_STORAGE_WRITE);
+}
+
+void vsdl_gpu_cull_read_draws(VSDL_Context* ctx, uint32_t pass) {
+  VSDL_GpuCull* cull = &ctx->gpuCull;
+  if (cull->graphCommands == VSDL_GRAPH_NONE) return;
+  vsdl_graph_use(ctx, pass, cull->graphCommands, VSDL_GRAPH_INDIRECT);
+  vsdl_graph_use(ctx, pass, cull->graphCount, VSDL_GRAPH_INDIRECT);
+  vsdl_graph_use(ctx, pass, cull->graphVisible, VSDL_GRAPH_STORAGE_READ);
+}
+
+void vsdl_gpu_cull_draw(VSDL_Context* ctx, VkCommandBuffer commandBuffer) {
+  VSDL_GpuCull* cull = &ctx->gpuCull;
+  if (cull->drawPipeline == VK_NULL_HANDLE || cull->objectCount == 0) return;
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline_resolve(ctx, cull->drawPipeline));
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, cull->pipelineLayout, 0, 1, &cull->descriptorSet, 0, NULL);
+  VkDeviceSize offset = 0;
+  vkCmdBindVertexBuffers(commandBuffer, 0, 1, &cull->vertexBuffer, &offset);
+  vkCmdBindIndexBuffer(commandBuffer, cull->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+  const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+  if (cull->cmdDrawIndexedIndirectCount) {
+      cull->cmdDrawIndexedIndirectCount(commandBuffer, cull->commandBuffer, 0, cull->countBuffer, 0, cull->objectCount, stride);
+  } else if (ctx->features.multiDrawIndirect) {
+      // Uncompacted: culled objects carry instanceCount = 0
+      vkCmdDrawIndexedIndirect(commandBuffer, cull->commandBuffer, 0, cull->objectCount, stride);
+  } else {
+      for (uint32_t i = 0; i < cull->objectCount; i++) {
+          vkCmdDrawIndexedIndirect(commandBuffer, cull->commandBuffer, (VkDeviceSize)i * stride, 1, stride);
+      }
+  }
+}
+
+void vsdl_gpu_cull_shutdown(VSDL_Context* ctx) {
+  VSDL_GpuCull* cull = &ctx->gpuCull;
+  if (ctx->device == VK_NULL_HANDLE) return;
+
+  // The draw pipeline and the shared layout belong to the pipeline registry
+  if (cull->cullPipeline != VK_NULL_HANDLE) vkDestroyPipeline(ctx->device, cull->cullPipeline, NULL);
+  if (cull->descriptorSetLayout != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(ctx->device, cull->descriptorSetLayout, NULL);
+
+  VkBuffer* buffers[] = {&cull->objectBuffer, &cull->meshBuffer, &cull->vertexBuffer, &cull->indexBuffer,
+                         &cull->commandBuffer, &cull->countBuffer, &cull->visibleBuffer};
+  VmaAllocation* allocations[] = {&cull->objectAllocation, &cull->meshAllocation, &cull->vertexAllocation, &cull->indexAllocation,
+                                  &cull->commandAllocation, &cull->countAllocation, &cull->visibleAllocation};
+  for (uint32_t i = 0; i < sizeof(buffers) / sizeof(buffers[0]); i++) {
+      if (*buffers[i] != VK_NULL_HANDLE) {
+          vsdl_memory_destroy_buffer(ctx, *buffers[i], *allocations[i]);
+      }
+  }
+
+  SDL_free(cull->objects);
+  memset(cull, 0, sizeof(*cull));
+}
@@ -0,0 +1,718 @@
+#include <SDL3/SDL.h>
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+#include "vsdl_graph.h"
+#include "vsdl_types.h"
+#include "vsdl_memory.h"
+#include "vsdl_descriptor.h"
+
+#define WRITE_ACCESS (VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT)
+
+typedef struct {
+  VkPipelineStageFlags stage;
+  VkAccessFlags access;
+  VkImageLayout layout;
+  VkImageUsageFlags imageUsage;
+  int write;
+} UsageInfo;
+
+static UsageInfo usage_info(const VSDL_GraphPass* pass, VSDL_GraphUsage usage) {
+  VkPipelineStageFlags shaders = pass->type == VSDL_GRAPH_PASS_COMPUTE
+      ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+      : VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+  UsageInfo info = {0};
+  switch (usage) {
+  case VSDL_GRAPH_COLOR_ATTACHMENT:
+      info.stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+      info.access = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | (pass->clear ? 0 : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT);
+      info.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+      info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+      info.write = 1;
+      break;
+  case VSDL_GRAPH_SAMPLED:
+      info.stage = shaders;
+      info.access = VK_ACCESS_SHADER_READ_BIT;
+      info.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+      info.imageUsage = VK_IMAGE_USAGE_SAMPLED_BIT;
+      break;
+  case VSDL_GRAPH_STORAGE_READ:
+      info.stage = shaders;
+      info.access = VK_ACCESS_SHADER_READ_BIT;
+      info.layout = VK_IMAGE_LAYOUT_GENERAL;
+      info.imageUsage = VK_IMAGE_USAGE_STORAGE_BIT;
+      break;
+  case VSDL_GRAPH_STORAGE_WRITE:
+      info.stage = shaders;
+      info.access = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+      info.layout = VK_IMAGE_LAYOUT_GENERAL;
+      info.imageUsage = VK_IMAGE_USAGE_STORAGE_BIT;
+      info.write = 1;
+      break;
+  case VSDL_GRAPH_INDIRECT:
+      info.stage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+      info.access = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+      break;
+  case VSDL_GRAPH_TRANSFER_SRC:
+      info.stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+      info.access = VK_ACCESS_TRANSFER_READ_BIT;
+      info.layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+      info.imageUsage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+      break;
+  case VSDL_GRAPH_TRANSFER_DST:
+      info.stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+      info.access = VK_ACCESS_TRANSFER_WRITE_BIT;
+      info.layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+      info.imageUsage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+      info.write = 1;
+      break;
+  }
+  return info;
+}
+
+static VSDL_GraphResource* add_resource(VSDL_Graph* graph, const char* name, uint32_t* outIndex) {
+  if (graph->resourceCount == VSDL_GRAPH_MAX_RESOURCES) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Render graph resource limit reached (%s)", name);
+      *outIndex = VSDL_GRAPH_NONE;
+      return NULL;
+  }
+  *outIndex = graph->resourceCount;
+  VSDL_GraphResource* resource = &graph->resources[graph->resourceCount++];
+  SDL_memset(resource, 0, sizeof(*resource));
+  resource->name = name;
+  resource->firstPass = VSDL_GRAPH_NONE;
+  resource->lastPass = VSDL_GRAPH_NONE;
+  resource->memory = VSDL_GRAPH_NONE;
+  return resource;
+}
+
+void vsdl_graph_begin(VSDL_Context* ctx) {
+  VSDL_Graph* graph = &ctx->graph;
+  graph->passCount = 0;
+  graph->resourceCount = 0;
+  for (uint32_t i = 0; i < graph->imageCount; i++) graph->images[i].used = 0;
+  // Nothing recorded last frame is still in flight, so a full cache can start over here
+  if (graph->framebufferCount == VSDL_GRAPH_MAX_CACHED) vsdl_graph_invalidate(ctx);
+}
+
+uint32_t vsdl_graph_import_image(VSDL_Context* ctx, const char* name, VkImage image, VkImageView view, VkFormat format,
+                                 VkExtent2D extent, VkImageLayout initialLayout, VkPipelineStageFlags initialStage,
+                                 VkImageLayout finalLayout) {
+  uint32_t index;
+  VSDL_GraphResource* resource = add_resource(&ctx->graph, name, &index);
+  if (!resource) return index;
+  resource->image = 1;
+  resource->imported = 1;
+  resource->output = finalLayout != VK_IMAGE_LAYOUT_UNDEFINED;
+  resource->handle = image;
+  resource->view = view;
+  resource->format = format;
+  resource->extent = extent;
+  resource->finalLayout = finalLayout;
+  resource->layout = initialLayout;
+  resource->writeStage = initialStage;
+  return index;
+}
+
+uint32_t vsdl_graph_import_buffer(VSDL_Context* ctx, const char* name, VkBuffer buffer, VkPipelineStageFlags initialStage,
+                                  int output) {
+  uint32_t index;
+  VSDL_GraphResource* resource = add_resource(&ctx->graph, name, &index);
+  if (!resource) return index;
+  resource->imported = 1;
+  resource->output = output;
+  resource->buffer = buffer;
+  resource->readStages = initialStage;
+  return index;
+}
+
+uint32_t vsdl_graph_create_image(VSDL_Context* ctx, const char* name, VkFormat format, VkExtent2D extent) {
+  uint32_t index;
+  VSDL_GraphResource* resource = add_resource(&ctx->graph, name, &index);
+  if (!resource) return index;
+  resource->image = 1;
+  resource->format = format;
+  resource->extent = extent;
+  resource->layout = VK_IMAGE_LAYOUT_UNDEFINED;
+  return index;
+}
+
+uint32_t vsdl_graph_add_pass(VSDL_Context* ctx, const char* name, VSDL_GraphPassType type,
+                             VSDL_GraphExecuteFn execute, void* data) {
+  VSDL_Graph* graph = &ctx->graph;
+  if (graph->passCount == VSDL_GRAPH_MAX_PASSES) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Render graph pass limit reached (%s)", name);
+      return VSDL_GRAPH_NONE;
+  }
+  VSDL_GraphPass* pass = &graph->passes[graph->passCount];
+  SDL_memset(pass, 0, sizeof(*pass));
+  pass->name = name;
+  pass->type = type;
+  pass->execute = execute;
+  pass->data = data;
+  return graph->passCount++;
+}
+
+void vsdl_graph_use(VSDL_Context* ctx, uint32_t pass, uint32_t resource, VSDL_GraphUsage usage) {
+  VSDL_Graph* graph = &ctx->graph;
+  if (pass >= graph->passCount || resource >= graph->resourceCount) return;
+  VSDL_GraphPass* p = &graph->passes[pass];
+  for (uint32_t i = 0; i < p->useCount; i++) {
+      if (p->uses[i].resource == resource) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Pass %s uses %s twice", p->name, graph->resources[resource].name);
+          return;
+      }
+  }
+  if (p->useCount == VSDL_GRAPH_MAX_USES) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Pass %s has too many resources", p->name);
+      return;
+  }
+  p->uses[p->useCount++] = (VSDL_GraphUse){resource, usage};
+  VSDL_GraphResource* r = &graph->resources[resource];
+  if (r->image && !r->imported) r->usage |= usage_info(p, usage).imageUsage;
+}
+
+void vsdl_graph_clear(VSDL_Context* ctx, uint32_t pass, const float color[4]) {
+  if (pass >= ctx->graph.passCount) return;
+  VSDL_GraphPass* p = &ctx->graph.passes[pass];
+  p->clear = 1;
+  SDL_memcpy(p->clearColor.float32, color, sizeof(p->clearColor.float32));
+}
+
+VkImageView vsdl_graph_image_view(VSDL_Context* ctx, uint32_t resource) {
+  return resource < ctx->graph.resourceCount ? ctx->graph.resources[resource].view : VK_NULL_HANDLE;
+}
+
+// Walk backwards from the outputs; a pass lives if it writes something a later live pass needs
+static void cull_passes(VSDL_Graph* graph) {
+  int needed[VSDL_GRAPH_MAX_RESOURCES];
+  for (uint32_t r = 0; r < graph->resourceCount; r++) needed[r] = graph->resources[r].output;
+
+  graph->culledPasses = 0;
+  for (uint32_t p = graph->passCount; p-- > 0;) {
+      VSDL_GraphPass* pass = &graph->passes[p];
+      pass->alive = 0;
+      for (uint32_t u = 0; u < pass->useCount; u++) {
+          if (usage_info(pass, pass->uses[u].usage).write && needed[pass->uses[u].resource]) pass->alive = 1;
+      }
+      if (!pass->alive) {
+          graph->culledPasses++;
+          continue;
+      }
+      for (uint32_t u = 0; u < pass->useCount; u++) {
+          const VSDL_GraphUse* use = &pass->uses[u];
+          // A cleared attachment does not depend on whoever wrote it before
+          if (use->usage == VSDL_GRAPH_COLOR_ATTACHMENT && pass->clear) {
+              needed[use->resource] = 0;
+          } else {
+              needed[use->resource] = 1;
+          }
+      }
+  }
+
+  for (uint32_t p = 0; p < graph->passCount; p++) {
+      const VSDL_GraphPass* pass = &graph->passes[p];
+      if (!pass->alive) continue;
+      for (uint32_t u = 0; u < pass->useCount; u++) {
+          VSDL_GraphResource* resource = &graph->resources[pass->uses[u].resource];
+          if (resource->firstPass == VSDL_GRAPH_NONE) resource->firstPass = p;
+          resource->lastPass = p;
+      }
+  }
+}
+
+static void destroy_framebuffers_using(VSDL_Context* ctx, VkImageView view) {
+  VSDL_Graph* graph = &ctx->graph;
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < graph->framebufferCount; i++) {
+      if (view == VK_NULL_HANDLE || graph->framebuffers[i].view == view) {
+          vkDestroyFramebuffer(ctx->device, graph->framebuffers[i].framebuffer, NULL);
+      } else {
+          graph->framebuffers[kept++] = graph->framebuffers[i];
+      }
+  }
+  graph->framebufferCount = kept;
+}
+
+static void destroy_image(VSDL_Context* ctx, VSDL_GraphImage* image) {
+  if (image->view != VK_NULL_HANDLE) {
+      destroy_framebuffers_using(ctx, image->view);
+      // Sampled transients are bound through the descriptor set cache
+      vsdl_descriptor_forget_view(ctx, image->view);
+      vkDestroyImageView(ctx->device, image->view, NULL);
+      image->view = VK_NULL_HANDLE;
+  }
+  if (image->image != VK_NULL_HANDLE) vkDestroyImage(ctx->device, image->image, NULL);
+  image->image = VK_NULL_HANDLE;
+}
+
+static int create_image(VSDL_Context* ctx, VSDL_GraphImage* image) {
+  VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+  imageInfo.imageType = VK_IMAGE_TYPE_2D;
+  imageInfo.format = image->format;
+  imageInfo.extent.width = image->extent.width;
+  imageInfo.extent.height = image->extent.height;
+  imageInfo.extent.depth = 1;
+  imageInfo.mipLevels = 1;
+  imageInfo.arrayLayers = 1;
+  imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+  imageInfo.usage = image->usage;
+  imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  if (vkCreateImage(ctx->device, &imageInfo, NULL, &image->image) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create transient image");
+      image->image = VK_NULL_HANDLE;
+      return 0;
+  }
+  return 1;
+}
+
+// Cached image with the same description and aliasing slot, or a new unbound one
+static VSDL_GraphImage* claim_image(VSDL_Context* ctx, const VSDL_GraphResource* resource) {
+  VSDL_Graph* graph = &ctx->graph;
+  for (uint32_t i = 0; i < graph->imageCount; i++) {
+      VSDL_GraphImage* image = &graph->images[i];
+      if (!image->used && image->format == resource->format && image->usage == resource->usage &&
+          image->memory == resource->memory && image->extent.width == resource->extent.width &&
+          image->extent.height == resource->extent.height) {
+          image->used = 1;
+          return image;
+      }
+  }
+  if (graph->imageCount == VSDL_GRAPH_MAX_CACHED) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Render graph transient image limit reached");
+      return NULL;
+  }
+  VSDL_GraphImage* image = &graph->images[graph->imageCount];
+  SDL_memset(image, 0, sizeof(*image));
+  image->format = resource->format;
+  image->extent = resource->extent;
+  image->usage = resource->usage;
+  image->memory = resource->memory;
+  if (!create_image(ctx, image)) return NULL;
+  image->used = 1;
+  graph->imageCount++;
+  return image;
+}
+
+// Sizes each slot for everything aliased into it, then binds images that need memory
+static int bind_slot(VSDL_Context* ctx, uint32_t slot) {
+  VSDL_Graph* graph = &ctx->graph;
+  VSDL_GraphMemory* memory = &graph->memory[slot];
+  VkMemoryRequirements needed = {0, 1, ~0u};
+  for (uint32_t i = 0; i < graph->imageCount; i++) {
+      const VSDL_GraphImage* image = &graph->images[i];
+      if (!image->used || image->memory != slot) continue;
+      VkMemoryRequirements requirements;
+      vkGetImageMemoryRequirements(ctx->device, image->image, &requirements);
+      if (requirements.size > needed.size) needed.size = requirements.size;
+      if (requirements.alignment > needed.alignment) needed.alignment = requirements.alignment;
+      needed.memoryTypeBits &= requirements.memoryTypeBits;
+  }
+  if (needed.size == 0) return 1;
+  if (needed.memoryTypeBits == 0) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Transient images in slot %u share no memory type", slot);
+      return 0;
+  }
+
+  int fits = 0;
+  if (memory->allocation) {
+      VmaAllocationInfo info;
+      vmaGetAllocationInfo(ctx->allocator, memory->allocation, &info);
+      fits = info.size >= needed.size && info.offset % needed.alignment == 0 &&
+             (needed.memoryTypeBits & (1u << info.memoryType)) != 0;
+  }
+  if (!fits) {
+      // Images bound to the old block go with it; the ones used this frame come back unbound
+      for (uint32_t i = 0; i < graph->imageCount; i++) {
+          VSDL_GraphImage* image = &graph->images[i];
+          if (image->memory != slot || image->view == VK_NULL_HANDLE) continue;
+          destroy_image(ctx, image);
+          if (image->used && !create_image(ctx, image)) return 0;
+      }
+      vsdl_memory_free(ctx, memory->allocation);
+      memory->allocation = NULL;
+      VmaAllocationCreateInfo allocInfo = {0};
+      allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+      if (!vsdl_memory_allocate(ctx, VSDL_MEMORY_TAG_TRANSIENT, &needed, &allocInfo, &memory->allocation)) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate transient memory (%llu bytes)",
+                       (unsigned long long)needed.size);
+          return 0;
+      }
+      memory->size = needed.size;
+  }
+
+  for (uint32_t i = 0; i < graph->imageCount; i++) {
+      VSDL_GraphImage* image = &graph->images[i];
+      if (!image->used || image->memory != slot || image->view != VK_NULL_HANDLE) continue;
+      if (vmaBindImageMemory(ctx->allocator, memory->allocation, image->image) != VK_SUCCESS) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to bind transient image memory");
+          return 0;
+      }
+      VkImageViewCreateInfo viewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+      viewInfo.image = image->image;
+      viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+      viewInfo.format = image->format;
+      viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      viewInfo.subresourceRange.levelCount = 1;
+      viewInfo.subresourceRange.layerCount = 1;
+      if (vkCreateImageView(ctx->device, &viewInfo, NULL, &image->view) != VK_SUCCESS) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create transient image view");
+          image->view = VK_NULL_HANDLE;
+          return 0;
+      }
+  }
+  return 1;
+}
+
+// Transients whose lifetimes do not overlap share a slot, first fit in order of first use
+static int allocate_transients(VSDL_Context* ctx) {
+  VSDL_Graph* graph = &ctx->graph;
+  uint32_t slotLast[VSDL_GRAPH_MAX_CACHED];
+  uint32_t slotCount = 0;
+  for (uint32_t p = 0; p < graph->passCount; p++) {
+      for (uint32_t r = 0; r < graph->resourceCount; r++) {
+          VSDL_GraphResource* resource = &graph->resources[r];
+          if (!resource->image || resource->imported || resource->firstPass != p) continue;
+          uint32_t slot = 0;
+          while (slot < slotCount && slotLast[slot] >= p) slot++;
+          if (slot == VSDL_GRAPH_MAX_CACHED) {
+              SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Too many overlapping transient images");
+              return 0;
+          }
+          if (slot == slotCount) slotCount++;
+          slotLast[slot] = resource->lastPass;
+          resource->memory = slot;
+      }
+  }
+
+  VSDL_GraphImage* claimed[VSDL_GRAPH_MAX_RESOURCES] = {0};
+  for (uint32_t r = 0; r < graph->resourceCount; r++) {
+      VSDL_GraphResource* resource = &graph->resources[r];
+      if (resource->memory == VSDL_GRAPH_NONE) continue;
+      claimed[r] = claim_image(ctx, resource);
+      if (!claimed[r]) return 0;
+  }
+
+  // Images nobody asked for this frame are released with their framebuffers
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < graph->imageCount; i++) {
+      if (!graph->images[i].used) {
+          destroy_image(ctx, &graph->images[i]);
+          continue;
+      }
+      for (uint32_t r = 0; r < graph->resourceCount; r++) {
+          if (claimed[r] == &graph->images[i]) claimed[r] = &graph->images[kept];
+      }
+      graph->images[kept++] = graph->images[i];
+  }
+  graph->imageCount = kept;
+
+  for (uint32_t slot = 0; slot < graph->memoryCount; slot++) {
+      if (slot >= slotCount) {
+          vsdl_memory_free(ctx, graph->memory[slot].allocation);
+          graph->memory[slot].allocation = NULL;
+      }
+  }
+  if (slotCount > graph->memoryCount) {
+      SDL_memset(&graph->memory[graph->memoryCount], 0, (slotCount - graph->memoryCount) * sizeof(VSDL_GraphMemory));
+  }
+  graph->memoryCount = slotCount;
+  for (uint32_t slot = 0; slot < slotCount; slot++) {
+      graph->memory[slot].stages = 0;
+      graph->memory[slot].writeAccess = 0;
+      if (!bind_slot(ctx, slot)) return 0;
+  }
+
+  for (uint32_t r = 0; r < graph->resourceCount; r++) {
+      if (!claimed[r]) continue;
+      graph->resources[r].handle = claimed[r]->image;
+      graph->resources[r].view = claimed[r]->view;
+  }
+  return 1;
+}
+
+typedef struct {
+  VkImageMemoryBarrier images[VSDL_GRAPH_MAX_USES + VSDL_GRAPH_MAX_RESOURCES];
+  uint32_t imageCount;
+  VkBufferMemoryBarrier buffers[VSDL_GRAPH_MAX_USES];
+  uint32_t bufferCount;
+  VkPipelineStageFlags srcStages;
+  VkPipelineStageFlags dstStages;
+} BarrierBatch;
+
+static void push_image_barrier(BarrierBatch* batch, const VSDL_GraphResource* resource, VkAccessFlags srcAccess,
+                               VkAccessFlags dstAccess, VkImageLayout newLayout) {
+  VkImageMemoryBarrier* barrier = &batch->images[batch->imageCount++];
+  *barrier = (VkImageMemoryBarrier){VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+  barrier->srcAccessMask = srcAccess;
+  barrier->dstAccessMask = dstAccess;
+  barrier->oldLayout = resource->layout;
+  barrier->newLayout = newLayout;
+  barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier->image = resource->handle;
+  barrier->subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  barrier->subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+  barrier->subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+}
+
+// Adds whatever barrier the use needs given everything that touched the resource before
+static void track_use(VSDL_Graph* graph, BarrierBatch* batch, VSDL_GraphResource* resource, const UsageInfo* use,
+                      uint32_t pass) {
+  if (resource->memory != VSDL_GRAPH_NONE && resource->firstPass == pass) {
+      // Aliased memory: wait for the slot's previous occupant
+      const VSDL_GraphMemory* memory = &graph->memory[resource->memory];
+      resource->writeStage = memory->stages;
+      resource->writeAccess = memory->writeAccess;
+  }
+
+  VkImageLayout layout = resource->image ? use->layout : VK_IMAGE_LAYOUT_UNDEFINED;
+  int transition = resource->image && resource->layout != layout;
+  VkPipelineStageFlags src;
+  int needed;
+  if (use->write || transition) {
+      // Write-after-read needs only execution order; write-after-write and transitions need memory too
+      src = resource->writeStage | resource->readStages | resource->visibleStages;
+      needed = src != 0 || transition;
+  } else {
+      src = resource->writeStage | resource->visibleStages;
+      needed = resource->writeAccess != 0 &&
+               ((use->stage & ~resource->visibleStages) != 0 || (use->access & ~resource->visibleAccess) != 0);
+  }
+
+  if (needed) {
+      batch->srcStages |= src ? src : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+      batch->dstStages |= use->stage;
+      if (resource->image) {
+          push_image_barrier(batch, resource, resource->writeAccess, use->access, layout);
+      } else if (resource->writeAccess) {
+          VkBufferMemoryBarrier* barrier = &batch->buffers[batch->bufferCount++];
+          *barrier = (VkBufferMemoryBarrier){VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+          barrier->srcAccessMask = resource->writeAccess;
+          barrier->dstAccessMask = use->access;
+          barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+          barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+          barrier->buffer = resource->buffer;
+          barrier->size = VK_WHOLE_SIZE;
+      }
+  }
+
+  if (use->write) {
+      resource->writeStage = use->stage;
+      resource->writeAccess = use->access & WRITE_ACCESS;
+      resource->readStages = 0;
+      resource->visibleStages = 0;
+      resource->visibleAccess = 0;
+  } else {
+      resource->readStages |= use->stage;
+      if (needed) {
+          resource->visibleStages |= use->stage;
+          resource->visibleAccess |= use->access;
+      }
+  }
+  resource->layout = layout;
+
+  if (resource->memory != VSDL_GRAPH_NONE && resource->lastPass == pass) {
+      VSDL_GraphMemory* memory = &graph->memory[resource->memory];
+      memory->stages = resource->writeStage | resource->readStages | resource->visibleStages;
+      memory->writeAccess = resource->writeAccess;
+  }
+}
+
+static void flush_barriers(VSDL_Graph* graph, VkCommandBuffer commandBuffer, BarrierBatch* batch) {
+  if (batch->srcStages == 0) return;
+  vkCmdPipelineBarrier(commandBuffer, batch->srcStages, batch->dstStages, 0, 0, NULL,
+                       batch->bufferCount, batch->buffers, batch->imageCount, batch->images);
+  graph->barriers++;
+  SDL_memset(batch, 0, sizeof(*batch));
+}
+
+// Render pass fallback. Attachments stay in COLOR_ATTACHMENT_OPTIMAL across the pass; the graph does every transition.
+// Pipelines built against ctx->renderPass stay compatible since only load op and layouts differ
+static VkRenderPass get_render_pass(VSDL_Context* ctx, VkFormat format, int clear) {
+  VSDL_Graph* graph = &ctx->graph;
+  for (uint32_t i = 0; i < graph->renderPassCount; i++) {
+      if (graph->renderPasses[i].format == format && graph->renderPasses[i].clear == clear) {
+          return graph->renderPasses[i].renderPass;
+      }
+  }
+  if (graph->renderPassCount == VSDL_GRAPH_MAX_CACHED) return VK_NULL_HANDLE;
+
+  VkAttachmentDescription colorAttachment = {0};
+  colorAttachment.format = format;
+  colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+  colorAttachment.loadOp = clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+  colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+  colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+  VkAttachmentReference colorAttachmentRef = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+  VkSubpassDescription subpass = {0};
+  subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  subpass.colorAttachmentCount = 1;
+  subpass.pColorAttachments = &colorAttachmentRef;
+
+  VkRenderPassCreateInfo renderPassInfo = {VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO};
+  renderPassInfo.attachmentCount = 1;
+  renderPassInfo.pAttachments = &colorAttachment;
+  renderPassInfo.subpassCount = 1;
+  renderPassInfo.pSubpasses = &subpass;
+
+  VSDL_GraphRenderPass* cached = &graph->renderPasses[graph->renderPassCount];
+  if (vkCreateRenderPass(ctx->device, &renderPassInfo, NULL, &cached->renderPass) != VK_SUCCESS) {
+      return VK_NULL_HANDLE;
+  }
+  cached->format = format;
+  cached->clear = clear;
+  graph->renderPassCount++;
+  return cached->renderPass;
+}
+
+static VkFramebuffer get_framebuffer(VSDL_Context* ctx, VkRenderPass renderPass, VkImageView view, VkExtent2D extent) {
+  VSDL_Graph* graph = &ctx->graph;
+  for (uint32_t i = 0; i < graph->framebufferCount; i++) {
+      const VSDL_GraphFramebuffer* cached = &graph->framebuffers[i];
+      if (cached->renderPass == renderPass && cached->view == view &&
+          cached->extent.width == extent.width && cached->extent.height == extent.height) {
+          return cached->framebuffer;
+      }
+  }
+  // Entries may be in this frame's commands, so a full cache waits for vsdl_graph_begin
+  if (graph->framebufferCount == VSDL_GRAPH_MAX_CACHED) return VK_NULL_HANDLE;
+
+  VkFramebufferCreateInfo fbInfo = {VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
+  fbInfo.renderPass = renderPass;
+  fbInfo.attachmentCount = 1;
+  fbInfo.pAttachments = &view;
+  fbInfo.width = extent.width;
+  fbInfo.height = extent.height;
+  fbInfo.layers = 1;
+  VSDL_GraphFramebuffer* cached = &graph->framebuffers[graph->framebufferCount];
+  if (vkCreateFramebuffer(ctx->device, &fbInfo, NULL, &cached->framebuffer) != VK_SUCCESS) {
+      return VK_NULL_HANDLE;
+  }
+  cached->renderPass = renderPass;
+  cached->view = view;
+  cached->extent = extent;
+  graph->framebufferCount++;
+  return cached->framebuffer;
+}
+
+static int run_graphics_pass(VSDL_Context* ctx, VkCommandBuffer commandBuffer, VSDL_GraphPass* pass) {
+  const VSDL_GraphResource* target = NULL;
+  for (uint32_t u = 0; u < pass->useCount; u++) {
+      if (pass->uses[u].usage == VSDL_GRAPH_COLOR_ATTACHMENT) target = &ctx->graph.resources[pass->uses[u].resource];
+  }
+  if (!target) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Graphics pass %s has no color attachment", pass->name);
+      return 0;
+  }
+  pass->format = target->format;
+  pass->extent = target->extent;
+  pass->renderPass = VK_NULL_HANDLE;
+  pass->framebuffer = VK_NULL_HANDLE;
+
+  if (ctx->features.dynamicRendering) {
+      VkRenderingAttachmentInfo colorAttachment = {VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
+      colorAttachment.imageView = target->view;
+      colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+      colorAttachment.loadOp = pass->clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+      colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+      colorAttachment.clearValue.color = pass->clearColor;
+      VkRenderingInfo renderingInfo = {VK_STRUCTURE_TYPE_RENDERING_INFO};
+      renderingInfo.renderArea.extent = pass->extent;
+      renderingInfo.layerCount = 1;
+      renderingInfo.colorAttachmentCount = 1;
+      renderingInfo.pColorAttachments = &colorAttachment;
+      if (pass->type == VSDL_GRAPH_PASS_GRAPHICS_SECONDARY) {
+          renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+      }
+      ctx->graph.cmdBeginRendering(commandBuffer, &renderingInfo);
+      pass->execute(ctx, commandBuffer, pass, pass->data);
+      ctx->graph.cmdEndRendering(commandBuffer);
+      return 1;
+  }
+
+  pass->renderPass = get_render_pass(ctx, target->format, pass->clear);
+  pass->framebuffer = pass->renderPass ? get_framebuffer(ctx, pass->renderPass, target->view, target->extent) : VK_NULL_HANDLE;
+  if (pass->framebuffer == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to get render pass or framebuffer for %s", pass->name);
+      return 0;
+  }
+
+  VkRenderPassBeginInfo renderPassInfo = {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+  renderPassInfo.renderPass = pass->renderPass;
+  renderPassInfo.framebuffer = pass->framebuffer;
+  renderPassInfo.renderArea.extent = pass->extent;
+  VkClearValue clearValue;
+  clearValue.color = pass->clearColor;
+  renderPassInfo.clearValueCount = pass->clear ? 1 : 0;
+  renderPassInfo.pClearValues = pass->clear ? &clearValue : NULL;
+  vkCmdBeginRenderPass(commandBuffer, &renderPassInfo,
+                       pass->type == VSDL_GRAPH_PASS_GRAPHICS_SECONDARY ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+                                                                        : VK_SUBPASS_CONTENTS_INLINE);
+  pass->execute(ctx, commandBuffer, pass, pass->data);
+  vkCmdEndRenderPass(commandBuffer);
+  return 1;
+}
+
+int vsdl_graph_execute(VSDL_Context* ctx, VkCommandBuffer commandBuffer) {
+  VSDL_Graph* graph = &ctx->graph;
+  cull_passes(graph);
+  if (!allocate_transients(ctx)) return 0;
+
+  graph->barriers = 0;
+  BarrierBatch batch;
+  SDL_memset(&batch, 0, sizeof(batch));
+  int ok = 1;
+  for (uint32_t p = 0; p < graph->passCount; p++) {
+      VSDL_GraphPass* pass = &graph->passes[p];
+      if (!pass->alive) continue;
+      for (uint32_t u = 0; u < pass->useCount; u++) {
+          UsageInfo info = usage_info(pass, pass->uses[u].usage);
+          track_use(graph, &batch, &graph->resources[pass->uses[u].resource], &info, p);
+      }
+      flush_barriers(graph, commandBuffer, &batch);
+
+      if (pass->type == VSDL_GRAPH_PASS_COMPUTE) {
+          pass->execute(ctx, commandBuffer, pass, pass->data);
+      } else if (!run_graphics_pass(ctx, commandBuffer, pass)) {
+          ok = 0;
+      }
+  }
+
+  // Leave outputs where their next owner expects them (e.g. PRESENT_SRC for the swapchain)
+  for (uint32_t r = 0; r < graph->resourceCount; r++) {
+      VSDL_GraphResource* resource = &graph->resources[r];
+      if (!resource->image || resource->finalLayout == VK_IMAGE_LAYOUT_UNDEFINED ||
+          resource->finalLayout == resource->layout) {
+          continue;
+      }
+      batch.srcStages |= resource->writeStage | resource->readStages | resource->visibleStages;
+      if (batch.srcStages == 0) batch.srcStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+      batch.dstStages |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+      push_image_barrier(&batch, resource, resource->writeAccess, 0, resource->finalLayout);
+      resource->layout = resource->finalLayout;
+  }
+  flush_barriers(graph, commandBuffer, &batch);
+  return ok;
+}
+
+void vsdl_graph_invalidate(VSDL_Context* ctx) {
+  destroy_framebuffers_using(ctx, VK_NULL_HANDLE);
+}
+
+void vsdl_graph_shutdown(VSDL_Context* ctx) {
+  VSDL_Graph* graph = &ctx->graph;
+  if (ctx->device == VK_NULL_HANDLE) return;
+  vsdl_graph_invalidate(ctx);
+  for (uint32_t i = 0; i < graph->imageCount; i++) destroy_image(ctx, &graph->images[i]);
+  for (uint32_t i = 0; i < graph->memoryCount; i++) vsdl_memory_free(ctx, graph->memory[i].allocation);
+  for (uint32_t i = 0; i < graph->renderPassCount; i++) {
+      vkDestroyRenderPass(ctx->device, graph->renderPasses[i].renderPass, NULL);
+  }
+  SDL_memset(graph, 0, sizeof(*graph));
+}
@@ -0,0 +1,118 @@
+#include <SDL3/SDL.h>
+#include "vsdl_idle.h"
+#include "vsdl_types.h"
+
+static Uint32 wakeEvent;
+static SDL_AtomicInt wakePending;
+
+// Only the main thread lowers the count, so raising it never loses a request
+static void owe_frames(VSDL_Idle* idle, int frames) {
+  int current = SDL_GetAtomicInt(&idle->dirtyFrames);
+  while (current < frames && !SDL_CompareAndSwapAtomicInt(&idle->dirtyFrames, current, frames)) {
+      current = SDL_GetAtomicInt(&idle->dirtyFrames);
+  }
+}
+
+int vsdl_idle_init(VSDL_Context* ctx, int enabled, uint32_t maxIdleMS) {
+  VSDL_Idle* idle = &ctx->idle;
+  SDL_memset(idle, 0, sizeof(*idle));
+  idle->enabled = enabled;
+  idle->maxIdleMS = maxIdleMS;
+  SDL_SetAtomicInt(&idle->dirtyFrames, VSDL_IDLE_INPUT_FRAMES);
+
+  wakeEvent = SDL_RegisterEvents(1);
+  if (wakeEvent == 0) {
+      // Still correct, background work just waits for the next input or maxIdleMS
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to register idle wake event: %s", SDL_GetError());
+  }
+  SDL_Log("Idle mode %s (max idle %u ms)", enabled ? "on" : "off", maxIdleMS);
+  return 1;
+}
+
+void vsdl_request_redraw(VSDL_Context* ctx) {
+  owe_frames(&ctx->idle, 1);
+  // Render-thread modules ask for frames too; the main loop may be asleep
+  if (!SDL_IsMainThread()) vsdl_idle_wake();
+}
+
+void vsdl_request_animation(VSDL_Context* ctx, uint32_t durationMS) {
+  uint64_t until = SDL_GetTicksNS() + SDL_MS_TO_NS((uint64_t)durationMS);
+  if (until > ctx->idle.animateUntilNS) ctx->idle.animateUntilNS = until;
+  vsdl_request_redraw(ctx);
+}
+
+void vsdl_idle_wake(void) {
+  if (wakeEvent == 0) return;
+  // One queued wake is enough no matter how many jobs finish before the loop runs
+  if (!SDL_CompareAndSwapAtomicInt(&wakePending, 0, 1)) return;
+  SDL_Event event;
+  SDL_zero(event);
+  event.type = wakeEvent;
+  SDL_PushEvent(&event);
+}
+
+int vsdl_idle_should_draw(VSDL_Context* ctx) {
+  VSDL_Idle* idle = &ctx->idle;
+  if (!idle->enabled || SDL_GetAtomicInt(&idle->dirtyFrames) > 0) return 1;
+  uint64_t now = SDL_GetTicksNS();
+  if (now < idle->animateUntilNS) return 1;
+  return idle->maxIdleMS > 0 && now - idle->lastFrameNS >= SDL_MS_TO_NS((uint64_t)idle->maxIdleMS);
+}
+
+int vsdl_idle_wait_event(VSDL_Context* ctx, SDL_Event* event) {
+  VSDL_Idle* idle = &ctx->idle;
+  if (vsdl_idle_should_draw(ctx)) return SDL_PollEvent(event);
+
+  Sint32 timeoutMS = -1;
+  if (idle->maxIdleMS > 0) {
+      uint64_t deadline = idle->lastFrameNS + SDL_MS_TO_NS((uint64_t)idle->maxIdleMS);
+      uint64_t now = SDL_GetTicksNS();
+      // Round up so the wait does not end just short of the deadline and spin
+      timeoutMS = deadline > now ? (Sint32)SDL_NS_TO_MS(deadline - now + SDL_NS_PER_MS - 1) : 0;
+  }
+  if (SDL_WaitEventTimeout(event, timeoutMS)) return 1;
+  if (!vsdl_idle_should_draw(ctx)) idle->wakeups++;
+  return 0;
+}
+
+void vsdl_idle_handle_event(VSDL_Context* ctx, const SDL_Event* event) {
+  VSDL_Idle* idle = &ctx->idle;
+  if (wakeEvent != 0 && event->type == wakeEvent) {
+      SDL_SetAtomicInt(&wakePending, 0);
+      owe_frames(idle, 1);
+      return;
+  }
+
+  switch (event->type) {
+  case SDL_EVENT_MOUSE_MOTION:
+  case SDL_EVENT_MOUSE_BUTTON_DOWN:
+  case SDL_EVENT_MOUSE_BUTTON_UP:
+  case SDL_EVENT_MOUSE_WHEEL:
+  case SDL_EVENT_KEY_DOWN:
+  case SDL_EVENT_KEY_UP:
+  case SDL_EVENT_TEXT_INPUT:
+  case SDL_EVENT_TEXT_EDITING:
+  case SDL_EVENT_WINDOW_SHOWN:
+  case SDL_EVENT_WINDOW_EXPOSED:
+  case SDL_EVENT_WINDOW_RESIZED:
+  case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
+  case SDL_EVENT_WINDOW_RESTORED:
+  case SDL_EVENT_WINDOW_MAXIMIZED:
+  case SDL_EVENT_WINDOW_MOUSE_ENTER:
+  case SDL_EVENT_WINDOW_MOUSE_LEAVE:
+  case SDL_EVENT_WINDOW_FOCUS_GAINED:
+  case SDL_EVENT_WINDOW_FOCUS_LOST:
+  case SDL_EVENT_WINDOW_DISPLAY_SCALE_CHANGED:
+      owe_frames(idle, VSDL_IDLE_INPUT_FRAMES);
+      break;
+  default:
+      break;
+  }
+}
+
+void vsdl_idle_frame_begin(VSDL_Context* ctx) {
+  VSDL_Idle* idle = &ctx->idle;
+  if (SDL_GetAtomicInt(&idle->dirtyFrames) > 0) SDL_AddAtomicInt(&idle->dirtyFrames, -1);
+  idle->lastFrameNS = SDL_GetTicksNS();
+  idle->framesDrawn++;
+}
@@ -5,6 +5,17 @@
 #include "vsdl_types.h"
 #include "vsdl_pipeline.h"
 #include "vsdl_text.h"
+#include "vsdl_upload.h"
+#include "vsdl_workers.h"
+#include "vsdl_texture.h"
+#include "vsdl_bindless.h"
+#include "vsdl_descriptor.h"
+#include "vsdl_sync.h"
+#include "vsdl_pack.h"
+#include "vsdl_memory.h"
+#include "vsdl_arena.h"
+#include "vsdl_idle.h"
+#include "vsdl_render_thread.h"
 #include <cimgui.h>
 #include <cimgui_impl.h>
 #include "vsdl_cimgui.h"  // Add this
@@ -38,6 +49,23 @@ static VkResult createDebugUtilsMessengerEXT(VkInstance instance,
     return VK_ERROR_EXTENSION_NOT_PRESENT;
 }
 
+static int has_device_extension(VkPhysicalDevice physicalDevice, const char* name) {
+    uint32_t count = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, NULL, &count, NULL);
+    VkExtensionProperties* props = (VkExtensionProperties*)SDL_calloc(count, sizeof(VkExtensionProperties));
+    if (!props) return 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, NULL, &count, props);
+    int found = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (SDL_strcmp(props[i].extensionName, name) == 0) {
+            found = 1;
+            break;
+        }
+    }
+    SDL_free(props);
+    return found;
+}
+
 static void checkVkResult(VkResult err) {
     if (err != VK_SUCCESS) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Vulkan error: %d", err);
@@ -59,12 +87,35 @@ int vsdl_init(VSDL_Context* ctx) {
     }
     //SDL_SetWindowResizable(ctx->window, 1);
 
+    // On-demand rendering unless VSDL_CONTINUOUS_RENDERING=1; VSDL_MAX_IDLE_MS bounds the gap between frames
+    const char* maxIdle = SDL_GetHint("VSDL_MAX_IDLE_MS");
+    vsdl_idle_init(ctx, !SDL_GetHintBoolean("VSDL_CONTINUOUS_RENDERING", false),
+                   maxIdle ? (uint32_t)SDL_atoi(maxIdle) : 1000);
+
+    if (!vsdl_frame_arena_init(ctx, 4 * 1024 * 1024)) {
+        return 0;
+    }
+    if (!vsdl_render_thread_init(ctx)) {
+        return 0;
+    }
+
+    // Optional: assets fall back to loose files when no pack is present
+    vsdl_pack_open(ctx, "assets.pak");
+
     VkApplicationInfo appInfo = {VK_STRUCTURE_TYPE_APPLICATION_INFO};
     appInfo.pApplicationName = "Vulkan SDL3";
     appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.pEngineName = "No Engine";
     appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    // Use up to 1.3 when the loader has it: 1.1 for properties2 queries (VK_EXT_memory_budget),
+    // 1.3 for core dynamic rendering
+    uint32_t instanceVersion = VK_API_VERSION_1_0;
+    PFN_vkEnumerateInstanceVersion enumerateInstanceVersion =
+        (PFN_vkEnumerateInstanceVersion)vkGetInstanceProcAddr(NULL, "vkEnumerateInstanceVersion");
+    if (enumerateInstanceVersion) enumerateInstanceVersion(&instanceVersion);
+    instanceVersion = VK_MAKE_API_VERSION(0, VK_API_VERSION_MAJOR(instanceVersion), VK_API_VERSION_MINOR(instanceVersion), 0);
+    appInfo.apiVersion = instanceVersion >= VK_API_VERSION_1_3 ? VK_API_VERSION_1_3 : instanceVersion;
+    ctx->apiVersion = appInfo.apiVersion;
 
     Uint32 extensionCount = 0;
     const char *const *baseExtensionNames = SDL_Vulkan_GetInstanceExtensions(&extensionCount);
@@ -141,6 +192,14 @@ int vsdl_init(VSDL_Context* ctx) {
     SDL_free(devices);
     SDL_Log("Physical device selected");
 
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(ctx->physicalDevice, &deviceProperties);
+    uint32_t deviceVersion = VK_MAKE_API_VERSION(0, VK_API_VERSION_MAJOR(deviceProperties.apiVersion),
+                                                 VK_API_VERSION_MINOR(deviceProperties.apiVersion), 0);
+    if (deviceVersion < ctx->apiVersion) ctx->apiVersion = deviceVersion;
+    SDL_Log("Using Vulkan %u.%u on %s", VK_API_VERSION_MAJOR(ctx->apiVersion), VK_API_VERSION_MINOR(ctx->apiVersion),
+            deviceProperties.deviceName);
+
     uint32_t queueFamilyCount = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(ctx->physicalDevice, &queueFamilyCount, NULL);
     VkQueueFamilyProperties* queueFamilies = (VkQueueFamilyProperties*)SDL_calloc(queueFamilyCount, sizeof(VkQueueFamilyProperties));
@@ -170,12 +229,149 @@ int vsdl_init(VSDL_Context* ctx) {
     queueCreateInfo.queueCount = 1;
     queueCreateInfo.pQueuePriorities = &queuePriority;
 
-    const char* deviceExtensions[] = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+    const char* deviceExtensions[12];
+    uint32_t deviceExtensionCount = 0;
+    deviceExtensions[deviceExtensionCount++] = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+    if (has_device_extension(ctx->physicalDevice, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME)) {
+        deviceExtensions[deviceExtensionCount++] = VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME;
+        ctx->features.drawIndirectCount = VK_TRUE;
+    }
+    if (ctx->apiVersion >= VK_API_VERSION_1_1 &&
+        has_device_extension(ctx->physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+        deviceExtensions[deviceExtensionCount++] = VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+        ctx->memory.budgetExtension = VK_TRUE;
+    }
+    // Dynamic rendering: core in 1.3, otherwise the KHR extension and the ones it depends on
+    int dynamicRenderingExtension = 0;
+    if (ctx->apiVersion < VK_API_VERSION_1_3 && ctx->apiVersion >= VK_API_VERSION_1_1 &&
+        has_device_extension(ctx->physicalDevice, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) &&
+        has_device_extension(ctx->physicalDevice, VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME) &&
+        has_device_extension(ctx->physicalDevice, VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME)) {
+        dynamicRenderingExtension = 1;
+    }
+    VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES};
+    if (ctx->apiVersion >= VK_API_VERSION_1_3 || dynamicRenderingExtension) {
+        VkPhysicalDeviceFeatures2 features2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+        features2.pNext = &dynamicRenderingFeatures;
+        vkGetPhysicalDeviceFeatures2(ctx->physicalDevice, &features2);
+        ctx->features.dynamicRendering = dynamicRenderingFeatures.dynamicRendering;
+    }
+    if (ctx->features.dynamicRendering && dynamicRenderingExtension) {
+        deviceExtensions[deviceExtensionCount++] = VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME;
+        deviceExtensions[deviceExtensionCount++] = VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME;
+        deviceExtensions[deviceExtensionCount++] = VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME;
+    }
+
+    // Descriptor indexing for the bindless texture table: core in 1.2, otherwise the EXT on 1.1
+    int descriptorIndexingExtension = ctx->apiVersion < VK_API_VERSION_1_2 && ctx->apiVersion >= VK_API_VERSION_1_1 &&
+        has_device_extension(ctx->physicalDevice, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+    if (ctx->apiVersion >= VK_API_VERSION_1_2 || descriptorIndexingExtension) {
+        VkPhysicalDeviceDescriptorIndexingFeatures supportedIndexing = {
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES};
+        VkPhysicalDeviceFeatures2 features2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+        features2.pNext = &supportedIndexing;
+        vkGetPhysicalDeviceFeatures2(ctx->physicalDevice, &features2);
+        ctx->features.descriptorIndexing = supportedIndexing.runtimeDescriptorArray &&
+                                           supportedIndexing.descriptorBindingPartiallyBound &&
+                                           supportedIndexing.descriptorBindingSampledImageUpdateAfterBind &&
+                                           supportedIndexing.shaderSampledImageArrayNonUniformIndexing;
+    }
+    // Enable only what the table uses
+    VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES};
+    if (ctx->features.descriptorIndexing) {
+        if (descriptorIndexingExtension) {
+            deviceExtensions[deviceExtensionCount++] = VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME;
+        }
+        indexingFeatures.runtimeDescriptorArray = VK_TRUE;
+        indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+        indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        indexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    }
+
+    // Timeline semaphore for frame and upload tracking: core in 1.2, otherwise the KHR extension on 1.1
+    int timelineExtension = ctx->apiVersion < VK_API_VERSION_1_2 && ctx->apiVersion >= VK_API_VERSION_1_1 &&
+        has_device_extension(ctx->physicalDevice, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES};
+    if (ctx->apiVersion >= VK_API_VERSION_1_2 || timelineExtension) {
+        VkPhysicalDeviceFeatures2 features2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+        features2.pNext = &timelineFeatures;
+        vkGetPhysicalDeviceFeatures2(ctx->physicalDevice, &features2);
+        ctx->features.timelineSemaphore = timelineFeatures.timelineSemaphore;
+    }
+    if (ctx->features.timelineSemaphore && timelineExtension) {
+        deviceExtensions[deviceExtensionCount++] = VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME;
+    }
+
+    // Graphics pipeline library: new pipeline variants fast-link from prebuilt parts instead of compiling
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT libraryFeatures = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT};
+    if (ctx->apiVersion >= VK_API_VERSION_1_1 &&
+        has_device_extension(ctx->physicalDevice, VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+        has_device_extension(ctx->physicalDevice, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME)) {
+        VkPhysicalDeviceFeatures2 features2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+        features2.pNext = &libraryFeatures;
+        vkGetPhysicalDeviceFeatures2(ctx->physicalDevice, &features2);
+        VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT libraryProperties = {
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT};
+        VkPhysicalDeviceProperties2 properties2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+        properties2.pNext = &libraryProperties;
+        vkGetPhysicalDeviceProperties2(ctx->physicalDevice, &properties2);
+        // Without fast linking a link costs about as much as a full compile, so there is nothing to gain
+        ctx->features.graphicsPipelineLibrary = libraryFeatures.graphicsPipelineLibrary &&
+                                                libraryProperties.graphicsPipelineLibraryFastLinking;
+    }
+    if (ctx->features.graphicsPipelineLibrary) {
+        deviceExtensions[deviceExtensionCount++] = VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME;
+        deviceExtensions[deviceExtensionCount++] = VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME;
+        libraryFeatures = (VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT){
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT};
+        libraryFeatures.graphicsPipelineLibrary = VK_TRUE;
+    }
+
+    // Optional features used by the GPU-driven path
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(ctx->physicalDevice, &supportedFeatures);
+    VkPhysicalDeviceFeatures enabledFeatures = {0};
+    enabledFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+    enabledFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+    ctx->features.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+    ctx->features.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+    SDL_Log("Device features: drawIndirectCount=%u drawIndirectFirstInstance=%u multiDrawIndirect=%u dynamicRendering=%u "
+            "descriptorIndexing=%u timelineSemaphore=%u graphicsPipelineLibrary=%u",
+            ctx->features.drawIndirectCount, ctx->features.drawIndirectFirstInstance, ctx->features.multiDrawIndirect,
+            ctx->features.dynamicRendering, ctx->features.descriptorIndexing, ctx->features.timelineSemaphore,
+            ctx->features.graphicsPipelineLibrary);
+
     VkDeviceCreateInfo deviceCreateInfo = {VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
     deviceCreateInfo.queueCreateInfoCount = 1;
     deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
-    deviceCreateInfo.enabledExtensionCount = 1;
+    deviceCreateInfo.enabledExtensionCount = deviceExtensionCount;
     deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions;
+    deviceCreateInfo.pEnabledFeatures = &enabledFeatures;
+    void* featureChain = NULL;
+    if (ctx->features.descriptorIndexing) {
+        indexingFeatures.pNext = featureChain;
+        featureChain = &indexingFeatures;
+    }
+    if (ctx->features.dynamicRendering) {
+        dynamicRenderingFeatures.pNext = featureChain;
+        featureChain = &dynamicRenderingFeatures;
+    }
+    if (ctx->features.timelineSemaphore) {
+        timelineFeatures = (VkPhysicalDeviceTimelineSemaphoreFeatures){
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES};
+        timelineFeatures.timelineSemaphore = VK_TRUE;
+        timelineFeatures.pNext = featureChain;
+        featureChain = &timelineFeatures;
+    }
+    if (ctx->features.graphicsPipelineLibrary) {
+        libraryFeatures.pNext = featureChain;
+        featureChain = &libraryFeatures;
+    }
+    deviceCreateInfo.pNext = featureChain;
 
     if (vkCreateDevice(ctx->physicalDevice, &deviceCreateInfo, NULL, &ctx->device) != VK_SUCCESS) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create Vulkan device");
@@ -183,10 +379,23 @@ int vsdl_init(VSDL_Context* ctx) {
     }
     SDL_Log("Vulkan device created");
 
+    if (ctx->features.dynamicRendering) {
+        const int core = ctx->apiVersion >= VK_API_VERSION_1_3;
+        ctx->graph.cmdBeginRendering = (PFN_vkCmdBeginRenderingKHR)
+            vkGetDeviceProcAddr(ctx->device, core ? "vkCmdBeginRendering" : "vkCmdBeginRenderingKHR");
+        ctx->graph.cmdEndRendering = (PFN_vkCmdEndRenderingKHR)
+            vkGetDeviceProcAddr(ctx->device, core ? "vkCmdEndRendering" : "vkCmdEndRenderingKHR");
+        if (!ctx->graph.cmdBeginRendering || !ctx->graph.cmdEndRendering) ctx->features.dynamicRendering = VK_FALSE;
+    }
+
     vkGetDeviceQueue(ctx->device, graphicsFamily, 0, &ctx->graphicsQueue);
     ctx->graphicsFamily = graphicsFamily;
     SDL_Log("Graphics queue retrieved");
 
+    if (!vsdl_sync_init(ctx)) {
+        return 0;
+    }
+
     // Create command pool
     VkCommandPoolCreateInfo poolInfo = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
     poolInfo.queueFamilyIndex = graphicsFamily;
@@ -204,7 +413,10 @@ int vsdl_init(VSDL_Context* ctx) {
     allocatorInfo.physicalDevice = ctx->physicalDevice;
     allocatorInfo.device = ctx->device;
     allocatorInfo.instance = ctx->instance;
-    allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_0;
+    allocatorInfo.vulkanApiVersion = ctx->apiVersion;
+    if (ctx->memory.budgetExtension) {
+        allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
     allocatorInfo.pVulkanFunctions = &vulkanFunctions;
 
     if (vmaCreateAllocator(&allocatorInfo, &ctx->allocator) != VK_SUCCESS) {
@@ -213,6 +425,32 @@ int vsdl_init(VSDL_Context* ctx) {
     }
     SDL_Log("VMA allocator created");
 
+    if (!vsdl_memory_init(ctx)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to initialize memory tracking");
+        return 0;
+    }
+
+    if (!vsdl_workers_init(ctx, 0)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to start worker threads");
+        return 0;
+    }
+
+    if (!vsdl_upload_init(ctx, 8 * 1024 * 1024)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to initialize upload staging");
+        return 0;
+    }
+
+    if (!vsdl_init_textures(ctx)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to initialize textures");
+        return 0;
+    }
+
+    // Needs the texture sampler; on failure textures keep using per-texture sets
+    if (!vsdl_bindless_init(ctx)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create bindless texture table, continuing without it");
+        ctx->features.descriptorIndexing = VK_FALSE;
+    }
+
     VkSwapchainCreateInfoKHR swapchainInfo = {VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR};
     swapchainInfo.surface = ctx->surface;
     swapchainInfo.minImageCount = 2;
@@ -236,6 +474,7 @@ int vsdl_init(VSDL_Context* ctx) {
     vkGetSwapchainImagesKHR(ctx->device, ctx->swapchain, &ctx->swapchainImageCount, NULL);
     ctx->swapchainImages = (VkImage*)malloc(ctx->swapchainImageCount * sizeof(VkImage));
     vkGetSwapchainImagesKHR(ctx->device, ctx->swapchain, &ctx->swapchainImageCount, ctx->swapchainImages);
+    ctx->swapchainImageFormat = swapchainInfo.imageFormat;
     ctx->swapchainExtent = swapchainInfo.imageExtent;
     ctx->swapchainImageViews = (VkImageView*)malloc(ctx->swapchainImageCount * sizeof(VkImageView));
     for (uint32_t i = 0; i < ctx->swapchainImageCount; i++) {
@@ -256,67 +495,53 @@ int vsdl_init(VSDL_Context* ctx) {
     ctx->swapchainImageViewCount = ctx->swapchainImageCount; // Add this line
     SDL_Log("Swapchain image views created (count: %u)", ctx->swapchainImageCount);
 
-    VkAttachmentDescription colorAttachment = {0};
-    colorAttachment.format = VK_FORMAT_B8G8R8A8_UNORM;
-    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-    VkAttachmentReference colorAttachmentRef = {0};
-    colorAttachmentRef.attachment = 0;
-    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-    VkSubpassDescription subpass = {0};
-    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass.colorAttachmentCount = 1;
-    subpass.pColorAttachments = &colorAttachmentRef;
-
-    VkRenderPassCreateInfo renderPassInfo = {VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO};
-    renderPassInfo.attachmentCount = 1;
-    renderPassInfo.pAttachments = &colorAttachment;
-    renderPassInfo.subpassCount = 1;
-    renderPassInfo.pSubpasses = &subpass;
-
-    if (vkCreateRenderPass(ctx->device, &renderPassInfo, NULL, &ctx->renderPass) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create render pass");
+    // Fallback when dynamic rendering is unavailable: pipelines and the graph's
+    // render passes must be compatible with this one
+    if (!ctx->features.dynamicRendering) {
+        VkAttachmentDescription colorAttachment = {0};
+        colorAttachment.format = VK_FORMAT_B8G8R8A8_UNORM;
+        colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+        VkAttachmentReference colorAttachmentRef = {0};
+        colorAttachmentRef.attachment = 0;
+        colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass = {0};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &colorAttachmentRef;
+
+        VkRenderPassCreateInfo renderPassInfo = {VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO};
+        renderPassInfo.attachmentCount = 1;
+        renderPassInfo.pAttachments = &colorAttachment;
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.pSubpasses = &subpass;
+
+        if (vkCreateRenderPass(ctx->device, &renderPassInfo, NULL, &ctx->renderPass) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create render pass");
+            return 0;
+        }
+        SDL_Log("Render pass created");
+    }
+
+    if (!vsdl_descriptors_init(ctx)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to initialize descriptor allocator");
         return 0;
     }
-    SDL_Log("Render pass created");
-
-    VkDescriptorPoolSize poolSizes[] = {
-        {VK_DESCRIPTOR_TYPE_SAMPLER, 1000},
-        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1000},
-        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1000},
-        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1000},
-        {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1000},
-        {VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1000},
-        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1000},
-        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1000},
-        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1000},
-        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1000},
-        {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1000}
-    };
-    VkDescriptorPoolCreateInfo poolInfoDesc = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
-    poolInfoDesc.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    poolInfoDesc.maxSets = 1000 * 11;
-    poolInfoDesc.poolSizeCount = 11;
-    poolInfoDesc.pPoolSizes = poolSizes;
-
-    if (vkCreateDescriptorPool(ctx->device, &poolInfoDesc, NULL, &ctx->descriptorPool) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create descriptor pool");
+
+    if (!vsdl_pipeline_registry_init(ctx)) {
         return 0;
     }
-    SDL_Log("Descriptor pool created");
 
      // Initialize ImGui via module
      if (!vsdl_cimgui_init(ctx)) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to initialize ImGui module");
-      vkDestroyDescriptorPool(ctx->device, ctx->descriptorPool, NULL);
-      // ... (rest of cleanup on failure)
       return 0;
     }
 
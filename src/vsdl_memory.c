@@ -0,0 +1,477 @@
+// #define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+// #include <volk.h>
+#include <vk_mem_alloc.h>
+#include <SDL3/SDL.h>
+#include <cimgui.h>
+#include "vsdl_memory.h"
+#include "vsdl_types.h"
+#include "vsdl_upload.h"
+#include "vsdl_idle.h"
+#include "vsdl_sync.h"
+
+#define MOVABLE_USAGE (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | \
+                       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | \
+                       VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | \
+                       VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+
+static const char* tagNames[VSDL_MEMORY_TAG_COUNT] = {"other", "text", "mesh", "texture", "sprite", "debug", "staging", "transient", "imgui"};
+
+static void account(VSDL_Memory* memory, VSDL_MemoryTag tag, VkDeviceSize size, int add) {
+  SDL_LockMutex(memory->lock);
+  if (add) {
+      memory->tagBytes[tag] += size;
+      memory->tagAllocations[tag]++;
+  } else {
+      memory->tagBytes[tag] -= size;
+      memory->tagAllocations[tag]--;
+  }
+  SDL_UnlockMutex(memory->lock);
+}
+
+int vsdl_memory_init(VSDL_Context* ctx) {
+  VSDL_Memory* memory = &ctx->memory;
+  memory->lock = SDL_CreateMutex();
+  if (!memory->lock) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create memory mutex: %s", SDL_GetError());
+      return 0;
+  }
+  memory->defragInterval = 120;
+  memory->defragBytesPerPass = 4 * 1024 * 1024;
+
+  // All movable buffers share one device-local memory type so a single pool can be compacted
+  VkBufferCreateInfo sampleInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  sampleInfo.size = 65536;
+  sampleInfo.usage = MOVABLE_USAGE;
+  VmaAllocationCreateInfo sampleAlloc = {0};
+  sampleAlloc.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+  uint32_t memoryTypeIndex;
+  if (vmaFindMemoryTypeIndexForBufferInfo(ctx->allocator, &sampleInfo, &sampleAlloc, &memoryTypeIndex) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No memory type for movable buffers");
+      return 0;
+  }
+  VmaPoolCreateInfo poolInfo = {0};
+  poolInfo.memoryTypeIndex = memoryTypeIndex;
+  if (vmaCreatePool(ctx->allocator, &poolInfo, &memory->movablePool) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create movable buffer pool");
+      return 0;
+  }
+  vmaSetPoolName(ctx->allocator, memory->movablePool, "movable");
+
+  SDL_Log("Memory tracking initialized (budget: %s)", memory->budgetExtension ? "VK_EXT_memory_budget" : "estimated");
+  return 1;
+}
+
+int vsdl_memory_create_buffer(VSDL_Context* ctx, VSDL_MemoryTag tag, const VkBufferCreateInfo* bufferInfo,
+                              const VmaAllocationCreateInfo* allocInfo, VkBuffer* buffer, VmaAllocation* allocation,
+                              VmaAllocationInfo* outInfo) {
+  VmaAllocationCreateInfo taggedInfo = *allocInfo;
+  taggedInfo.pUserData = (void*)(uintptr_t)tag;
+  VmaAllocationInfo info;
+  if (vmaCreateBuffer(ctx->allocator, bufferInfo, &taggedInfo, buffer, allocation, &info) != VK_SUCCESS) {
+      return 0;
+  }
+  account(&ctx->memory, tag, info.size, 1);
+  if (outInfo) *outInfo = info;
+  return 1;
+}
+
+int vsdl_memory_create_image(VSDL_Context* ctx, VSDL_MemoryTag tag, const VkImageCreateInfo* imageInfo,
+                             const VmaAllocationCreateInfo* allocInfo, VkImage* image, VmaAllocation* allocation,
+                             VmaAllocationInfo* outInfo) {
+  VmaAllocationCreateInfo taggedInfo = *allocInfo;
+  taggedInfo.pUserData = (void*)(uintptr_t)tag;
+  VmaAllocationInfo info;
+  if (vmaCreateImage(ctx->allocator, imageInfo, &taggedInfo, image, allocation, &info) != VK_SUCCESS) {
+      return 0;
+  }
+  account(&ctx->memory, tag, info.size, 1);
+  if (outInfo) *outInfo = info;
+  return 1;
+}
+
+void vsdl_memory_destroy_buffer(VSDL_Context* ctx, VkBuffer buffer, VmaAllocation allocation) {
+  if (!allocation) {
+      // A bare handle, e.g. the old one of a relocated movable buffer; VMA owns its memory
+      if (buffer != VK_NULL_HANDLE) vkDestroyBuffer(ctx->device, buffer, NULL);
+      return;
+  }
+  VmaAllocationInfo info;
+  vmaGetAllocationInfo(ctx->allocator, allocation, &info);
+  account(&ctx->memory, (VSDL_MemoryTag)(uintptr_t)info.pUserData, info.size, 0);
+  vmaDestroyBuffer(ctx->allocator, buffer, allocation);
+}
+
+void vsdl_memory_destroy_image(VSDL_Context* ctx, VkImage image, VmaAllocation allocation) {
+  if (!allocation) return;
+  VmaAllocationInfo info;
+  vmaGetAllocationInfo(ctx->allocator, allocation, &info);
+  account(&ctx->memory, (VSDL_MemoryTag)(uintptr_t)info.pUserData, info.size, 0);
+  vmaDestroyImage(ctx->allocator, image, allocation);
+}
+
+int vsdl_memory_allocate(VSDL_Context* ctx, VSDL_MemoryTag tag, const VkMemoryRequirements* requirements,
+                         const VmaAllocationCreateInfo* allocInfo, VmaAllocation* allocation) {
+  VmaAllocationCreateInfo taggedInfo = *allocInfo;
+  taggedInfo.pUserData = (void*)(uintptr_t)tag;
+  VmaAllocationInfo info;
+  if (vmaAllocateMemory(ctx->allocator, requirements, &taggedInfo, allocation, &info) != VK_SUCCESS) {
+      return 0;
+  }
+  account(&ctx->memory, tag, info.size, 1);
+  return 1;
+}
+
+void vsdl_memory_free(VSDL_Context* ctx, VmaAllocation allocation) {
+  if (!allocation) return;
+  VmaAllocationInfo info;
+  vmaGetAllocationInfo(ctx->allocator, allocation, &info);
+  account(&ctx->memory, (VSDL_MemoryTag)(uintptr_t)info.pUserData, info.size, 0);
+  vmaFreeMemory(ctx->allocator, allocation);
+}
+
+static void end_defragmentation(VSDL_Context* ctx) {
+  VSDL_Memory* memory = &ctx->memory;
+  VmaDefragmentationStats stats = {0};
+  vmaEndDefragmentation(ctx->allocator, memory->defrag, &stats);
+  memory->defrag = NULL;
+  memory->defragBytesMoved += stats.bytesMoved;
+  if (stats.allocationsMoved > 0) {
+      SDL_Log("Defragmentation moved %u buffers (%llu bytes), released %u blocks",
+              stats.allocationsMoved, (unsigned long long)stats.bytesMoved, stats.deviceMemoryBlocksFreed);
+  }
+}
+
+int vsdl_memory_create_movable_buffer(VSDL_Context* ctx, VSDL_MemoryTag tag, VkDeviceSize size,
+                                      VkBufferUsageFlags usage, VSDL_MovableBuffer* buffer) {
+  VSDL_Memory* memory = &ctx->memory;
+  if ((usage & ~MOVABLE_USAGE) != 0 || memory->movableCount >= VSDL_MAX_MOVABLE_BUFFERS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Cannot create movable buffer (usage 0x%x)", usage);
+      return 0;
+  }
+  if (memory->defrag && !memory->passActive) end_defragmentation(ctx);
+
+  SDL_memset(buffer, 0, sizeof(*buffer));
+  buffer->size = size;
+  buffer->usage = usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  buffer->tag = tag;
+
+  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  bufferInfo.size = size;
+  bufferInfo.usage = buffer->usage;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  VmaAllocationCreateInfo allocInfo = {0};
+  allocInfo.pool = memory->movablePool;
+  allocInfo.pUserData = buffer;
+  VmaAllocationInfo info;
+  if (vmaCreateBuffer(ctx->allocator, &bufferInfo, &allocInfo, &buffer->buffer, &buffer->allocation, &info) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create movable buffer (%llu bytes)", (unsigned long long)size);
+      return 0;
+  }
+  account(memory, tag, info.size, 1);
+  memory->movables[memory->movableCount++] = buffer;
+  return 1;
+}
+
+void vsdl_memory_destroy_movable_buffer(VSDL_Context* ctx, VSDL_MovableBuffer* buffer) {
+  VSDL_Memory* memory = &ctx->memory;
+  if (!buffer->allocation) return;
+
+  for (uint32_t i = 0; i < memory->movableCount; i++) {
+      if (memory->movables[i] == buffer) {
+          memory->movables[i] = memory->movables[--memory->movableCount];
+          break;
+      }
+  }
+
+  VmaAllocationInfo info;
+  vmaGetAllocationInfo(ctx->allocator, buffer->allocation, &info);
+  account(memory, buffer->tag, info.size, 0);
+
+  // An allocation inside the pending pass is released by VMA when the pass ends, and its handle
+  // once the batch holding the copy has finished with it
+  int inPass = 0;
+  if (memory->passActive) {
+      for (uint32_t i = 0; i < memory->pass.moveCount; i++) {
+          if (memory->pass.pMoves[i].srcAllocation == buffer->allocation) {
+              memory->pass.pMoves[i].operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_DESTROY;
+              memory->passSources[i] = buffer->buffer;
+              inPass = 1;
+          }
+      }
+  } else if (memory->defrag) {
+      end_defragmentation(ctx);
+  }
+
+  if (!inPass) {
+      vmaDestroyBuffer(ctx->allocator, buffer->buffer, buffer->allocation);
+  }
+  SDL_memset(buffer, 0, sizeof(*buffer));
+}
+
+int vsdl_memory_move_pending(VSDL_Context* ctx, const VSDL_MovableBuffer* buffer) {
+  VSDL_Memory* memory = &ctx->memory;
+  if (!memory->passActive || !buffer->allocation) return 0;
+  for (uint32_t i = 0; i < memory->pass.moveCount; i++) {
+      const VmaDefragmentationMove* move = &memory->pass.pMoves[i];
+      if (move->srcAllocation == buffer->allocation && move->operation == VMA_DEFRAGMENTATION_MOVE_OPERATION_COPY) {
+          return 1;
+      }
+  }
+  return 0;
+}
+
+void vsdl_memory_buffer_written(VSDL_Context* ctx, VkBuffer buffer) {
+  VSDL_Memory* memory = &ctx->memory;
+  if (!memory->passActive) return;
+  for (uint32_t i = 0; i < memory->pass.moveCount; i++) {
+      VmaDefragmentationMove* move = &memory->pass.pMoves[i];
+      if (move->operation != VMA_DEFRAGMENTATION_MOVE_OPERATION_COPY) continue;
+      VmaAllocationInfo info;
+      vmaGetAllocationInfo(ctx->allocator, move->srcAllocation, &info);
+      const VSDL_MovableBuffer* movable = (const VSDL_MovableBuffer*)info.pUserData;
+      // The copy was recorded before this write; finish_pass drops the stale destination
+      if (movable->buffer == buffer) move->operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+  }
+}
+
+// Swaps in the buffers copied by the pending pass; returns 0 while the copies are still in flight
+static int finish_pass(VSDL_Context* ctx, int force) {
+  VSDL_Memory* memory = &ctx->memory;
+  if (!force && !vsdl_sync_reached(ctx, ctx->upload.submitValue)) {
+      return 0;
+  }
+
+  for (uint32_t i = 0; i < memory->pass.moveCount; i++) {
+      VmaDefragmentationMove* move = &memory->pass.pMoves[i];
+      VkBuffer newBuffer = memory->passBuffers[i];
+      if (move->operation == VMA_DEFRAGMENTATION_MOVE_OPERATION_COPY && !force) {
+          VmaAllocationInfo info;
+          vmaGetAllocationInfo(ctx->allocator, move->srcAllocation, &info);
+          VSDL_MovableBuffer* buffer = (VSDL_MovableBuffer*)info.pUserData;
+          // Frames recorded before this one may still name the old handle
+          vsdl_sync_defer_buffer(ctx, buffer->buffer, VK_NULL_HANDLE);
+          buffer->buffer = newBuffer;
+          buffer->version++;
+      } else {
+          if (move->operation == VMA_DEFRAGMENTATION_MOVE_OPERATION_COPY) {
+              move->operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+          }
+          if (newBuffer != VK_NULL_HANDLE) vkDestroyBuffer(ctx->device, newBuffer, NULL);
+      }
+      // The copy batch has completed (or the device is idle when forced)
+      if (memory->passSources[i] != VK_NULL_HANDLE) vkDestroyBuffer(ctx->device, memory->passSources[i], NULL);
+      memory->passBuffers[i] = VK_NULL_HANDLE;
+      memory->passSources[i] = VK_NULL_HANDLE;
+  }
+
+  VkResult result = vmaEndDefragmentationPass(ctx->allocator, memory->defrag, &memory->pass);
+  memory->passActive = 0;
+  memory->defragPasses++;
+  if (result == VK_SUCCESS || force) end_defragmentation(ctx);
+  return 1;
+}
+
+static void begin_pass(VSDL_Context* ctx) {
+  VSDL_Memory* memory = &ctx->memory;
+  VkResult result = vmaBeginDefragmentationPass(ctx->allocator, memory->defrag, &memory->pass);
+  if (result == VK_SUCCESS) {
+      end_defragmentation(ctx);  // Nothing left to move
+      return;
+  }
+  if (result != VK_INCOMPLETE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to begin defragmentation pass: %d", result);
+      end_defragmentation(ctx);
+      return;
+  }
+  memory->passActive = 1;
+
+  VkCommandBuffer cmd = vsdl_upload_command_buffer(ctx);
+  VkMemoryBarrier barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  if (cmd != VK_NULL_HANDLE) {
+      // Earlier uploads in this batch must land before their buffers are copied
+      barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+      vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                           1, &barrier, 0, NULL, 0, NULL);
+  }
+
+  for (uint32_t i = 0; i < memory->pass.moveCount; i++) {
+      VmaDefragmentationMove* move = &memory->pass.pMoves[i];
+      VmaAllocationInfo info;
+      vmaGetAllocationInfo(ctx->allocator, move->srcAllocation, &info);
+      VSDL_MovableBuffer* buffer = (VSDL_MovableBuffer*)info.pUserData;
+
+      VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+      bufferInfo.size = buffer->size;
+      bufferInfo.usage = buffer->usage;
+      bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+      VkBuffer newBuffer = VK_NULL_HANDLE;
+      if (cmd == VK_NULL_HANDLE ||
+          vkCreateBuffer(ctx->device, &bufferInfo, NULL, &newBuffer) != VK_SUCCESS ||
+          vmaBindBufferMemory(ctx->allocator, move->dstTmpAllocation, newBuffer) != VK_SUCCESS) {
+          if (newBuffer != VK_NULL_HANDLE) vkDestroyBuffer(ctx->device, newBuffer, NULL);
+          move->operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+          memory->passBuffers[i] = VK_NULL_HANDLE;
+          continue;
+      }
+      memory->passBuffers[i] = newBuffer;
+
+      VkBufferCopy region = {0, 0, buffer->size};
+      vkCmdCopyBuffer(cmd, buffer->buffer, newBuffer, 1, &region);
+  }
+
+  if (cmd != VK_NULL_HANDLE) {
+      barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                              VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT |
+                              VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+      vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+                           1, &barrier, 0, NULL, 0, NULL);
+  }
+}
+
+static void check_budget(VSDL_Context* ctx) {
+  VSDL_Memory* memory = &ctx->memory;
+  const VkPhysicalDeviceMemoryProperties* properties;
+  vmaGetMemoryProperties(ctx->allocator, &properties);
+  VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+  vmaGetHeapBudgets(ctx->allocator, budgets);
+
+  for (uint32_t i = 0; i < properties->memoryHeapCount; i++) {
+      uint32_t bit = 1u << i;
+      int over = budgets[i].budget > 0 && budgets[i].usage > budgets[i].budget / 10 * 9;
+      if (over && !(memory->overBudgetHeaps & bit)) {
+          SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Memory heap %u above 90%% of budget (%llu / %llu MB)", i,
+                      (unsigned long long)(budgets[i].usage >> 20), (unsigned long long)(budgets[i].budget >> 20));
+      }
+      memory->overBudgetHeaps = over ? (memory->overBudgetHeaps | bit) : (memory->overBudgetHeaps & ~bit);
+  }
+}
+
+void vsdl_memory_update(VSDL_Context* ctx) {
+  VSDL_Memory* memory = &ctx->memory;
+  memory->frameIndex++;
+  vmaSetCurrentFrameIndex(ctx->allocator, (uint32_t)memory->frameIndex);
+  if (memory->frameIndex % 60 == 0) check_budget(ctx);
+
+  // A started defragmentation needs further frames to finish its passes
+  if (memory->defrag) vsdl_request_redraw(ctx);
+  if (memory->passActive && !finish_pass(ctx, 0)) return;
+
+  if (!memory->defrag) {
+      if (memory->frameIndex % memory->defragInterval != 0) return;
+      VmaStatistics stats;
+      vmaGetPoolStatistics(ctx->allocator, memory->movablePool, &stats);
+      // Compaction only pays off when it can release a block
+      VkDeviceSize slack = stats.blockBytes - stats.allocationBytes;
+      if (stats.blockCount < 2 || slack * 4 < stats.blockBytes) return;
+
+      VmaDefragmentationInfo info = {0};
+      info.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+      info.pool = memory->movablePool;
+      info.maxBytesPerPass = memory->defragBytesPerPass;
+      info.maxAllocationsPerPass = VSDL_DEFRAG_MAX_MOVES;
+      if (vmaBeginDefragmentation(ctx->allocator, &info, &memory->defrag) != VK_SUCCESS) {
+          memory->defrag = NULL;
+          return;
+      }
+  }
+  begin_pass(ctx);
+  vsdl_request_redraw(ctx);
+}
+
+void vsdl_memory_snapshot(VSDL_Context* ctx) {
+  VSDL_Memory* memory = &ctx->memory;
+  VSDL_MemoryStats stats = {0};
+  stats.movableCount = memory->movableCount;
+  stats.defragRunning = memory->defrag != NULL;
+  stats.defragPasses = memory->defragPasses;
+  stats.defragBytesMoved = memory->defragBytesMoved;
+  stats.frameArenaUsed = ctx->frameArena.used;
+  stats.frameArenaPeak = ctx->frameArena.highWater;
+  stats.frameArenaCapacity = ctx->frameArena.capacity;
+  // The recording tasks have finished, so the worker arenas are quiet
+  stats.workerArenaCount = ctx->workers.threadCount;
+  for (uint32_t i = 0; i < ctx->workers.threadCount; i++) {
+      stats.workerArenaPeak = SDL_max(stats.workerArenaPeak, ctx->workers.arenas[i].highWater);
+      stats.workerArenaCapacity += ctx->workers.arenas[i].capacity;
+  }
+  SDL_LockMutex(memory->lock);
+  memory->stats = stats;
+  SDL_UnlockMutex(memory->lock);
+}
+
+void vsdl_memory_draw_panel(VSDL_Context* ctx) {
+  VSDL_Memory* memory = &ctx->memory;
+  if (!igBegin("Memory", NULL, 0)) {
+      igEnd();
+      return;
+  }
+
+  const VkPhysicalDeviceMemoryProperties* properties;
+  vmaGetMemoryProperties(ctx->allocator, &properties);
+  VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+  vmaGetHeapBudgets(ctx->allocator, budgets);
+
+  igText("Budget: %s", memory->budgetExtension ? "VK_EXT_memory_budget" : "estimated (80%% of heap)");
+  VkDeviceSize externalBytes = 0;
+  for (uint32_t i = 0; i < properties->memoryHeapCount; i++) {
+      const VmaBudget* budget = &budgets[i];
+      int deviceLocal = (properties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+      igText("Heap %u (%s)", i, deviceLocal ? "device" : "host");
+      char overlay[64];
+      SDL_snprintf(overlay, sizeof(overlay), "%.1f / %.1f MB", budget->usage / 1048576.0, budget->budget / 1048576.0);
+      float fraction = budget->budget ? (float)((double)budget->usage / (double)budget->budget) : 0.0f;
+      igProgressBar(fraction, (ImVec2){-1.0f, 0.0f}, overlay);
+      igText("  VMA: %u blocks %.1f MB, %u allocations %.1f MB",
+             budget->statistics.blockCount, budget->statistics.blockBytes / 1048576.0,
+             budget->statistics.allocationCount, budget->statistics.allocationBytes / 1048576.0);
+      if (budget->usage > budget->statistics.blockBytes) externalBytes += budget->usage - budget->statistics.blockBytes;
+  }
+
+  igSeparator();
+  SDL_LockMutex(memory->lock);
+  for (uint32_t tag = 0; tag < VSDL_MEMORY_TAG_COUNT; tag++) {
+      if (tag == VSDL_MEMORY_TAG_IMGUI) continue;
+      igText("%-8s %5u allocs %8.2f MB", tagNames[tag], memory->tagAllocations[tag], memory->tagBytes[tag] / 1048576.0);
+  }
+  VSDL_MemoryStats stats = memory->stats;
+  SDL_UnlockMutex(memory->lock);
+  // The ImGui backend allocates through vkAllocateMemory directly; only the budget sees it
+  if (memory->budgetExtension) {
+      igText("%-8s %8.2f MB outside VMA (ImGui, swapchain, driver)", tagNames[VSDL_MEMORY_TAG_IMGUI], externalBytes / 1048576.0);
+  } else {
+      igText("%-8s n/a without VK_EXT_memory_budget", tagNames[VSDL_MEMORY_TAG_IMGUI]);
+  }
+
+  igSeparator();
+  VmaStatistics poolStats;
+  vmaGetPoolStatistics(ctx->allocator, memory->movablePool, &poolStats);
+  igText("Movable pool: %u buffers, %u blocks, %.2f / %.2f MB used", stats.movableCount, poolStats.blockCount,
+         poolStats.allocationBytes / 1048576.0, poolStats.blockBytes / 1048576.0);
+  igText("Defrag: %s, %u passes, %.2f MB moved", stats.defragRunning ? "running" : "idle", stats.defragPasses,
+         stats.defragBytesMoved / 1048576.0);
+
+  igSeparator();
+  igText("Frame arena: %.1f KB used, %.1f KB peak, %.1f KB capacity", stats.frameArenaUsed / 1024.0,
+         stats.frameArenaPeak / 1024.0, stats.frameArenaCapacity / 1024.0);
+  igText("Worker arenas: %u, %.1f KB peak, %.1f KB total", stats.workerArenaCount, stats.workerArenaPeak / 1024.0,
+         stats.workerArenaCapacity / 1024.0);
+  igEnd();
+}
+
+void vsdl_memory_shutdown(VSDL_Context* ctx) {
+  VSDL_Memory* memory = &ctx->memory;
+  if (ctx->allocator == VK_NULL_HANDLE) return;
+
+  // The device is idle here; abandon any pending moves
+  if (memory->passActive) finish_pass(ctx, 1);
+  if (memory->defrag) end_defragmentation(ctx);
+  if (memory->movableCount > 0) {
+      SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%u movable buffers still alive at shutdown", memory->movableCount);
+  }
+  if (memory->movablePool) vmaDestroyPool(ctx->allocator, memory->movablePool);
+  if (memory->lock) SDL_DestroyMutex(memory->lock);
+  SDL_memset(memory, 0, sizeof(*memory));
+}
@@ -5,6 +5,8 @@
 #include <SDL3/SDL_log.h>
 #include "vsdl_mesh.h"
 #include "vsdl_types.h"
+#include "vsdl_memory.h"
+#include "vsdl_upload.h"
 
 int create_vertex_buffer(VSDL_Context* ctx) {
     Vertex vertices[] = {
@@ -14,29 +16,22 @@ int create_vertex_buffer(VSDL_Context* ctx) {
     };
     VkDeviceSize bufferSize = sizeof(vertices);
 
-    VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-    bufferInfo.size = bufferSize;
-    bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    VmaAllocationCreateInfo allocInfo = {0};
-    allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-    allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
-
-    VkBuffer vertexBuffer;
-    VmaAllocation allocation;
-    if (vmaCreateBuffer(ctx->allocator, &bufferInfo, &allocInfo, &vertexBuffer, &allocation, NULL) != VK_SUCCESS) {
+    // Static geometry lives in the movable device-local pool and is filled through staging
+    if (!vsdl_memory_create_movable_buffer(ctx, VSDL_MEMORY_TAG_MESH, bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, &ctx->vertexBuffer)) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create vertex buffer");
         return 0;
     }
 
-    void* data;
-    vmaMapMemory(ctx->allocator, allocation, &data);
-    memcpy(data, vertices, bufferSize);
-    vmaUnmapMemory(ctx->allocator, allocation);
-
-    ctx->vertexBuffer = vertexBuffer;
-    ctx->vertexBufferAllocation = allocation;
+    if (vsdl_upload_command_buffer(ctx) == VK_NULL_HANDLE ||
+        !vsdl_upload_buffer(ctx, ctx->vertexBuffer.buffer, 0, vertices, bufferSize)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to upload vertex buffer");
+        return 0;
+    }
+    VkMemoryBarrier barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    vkCmdPipelineBarrier(vsdl_upload_command_buffer(ctx), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0,
+                         1, &barrier, 0, NULL, 0, NULL);
     SDL_Log("Vertex buffer created with VMA");
 
     return 1;
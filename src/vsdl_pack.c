@@ -0,0 +1,194 @@
+#include <SDL3/SDL.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <lz4.h>
+#include "vsdl_pack.h"
+#include "vsdl_types.h"
+#include "vsdl_utils.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static int map_file(VSDL_Pack* pack, const char* path) {
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) return 0;
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+      CloseHandle(file);
+      return 0;
+  }
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (!mapping) {
+      CloseHandle(file);
+      return 0;
+  }
+  const void* base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!base) {
+      CloseHandle(mapping);
+      CloseHandle(file);
+      return 0;
+  }
+  pack->fileHandle = file;
+  pack->mappingHandle = mapping;
+  pack->base = (const unsigned char*)base;
+  pack->size = (size_t)fileSize.QuadPart;
+  return 1;
+#else
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return 0;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+      close(fd);
+      return 0;
+  }
+  void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);  // The mapping keeps the file referenced
+  if (base == MAP_FAILED) return 0;
+  pack->base = (const unsigned char*)base;
+  pack->size = (size_t)st.st_size;
+  return 1;
+#endif
+}
+
+static void unmap_file(VSDL_Pack* pack) {
+#ifdef _WIN32
+  if (pack->base) UnmapViewOfFile(pack->base);
+  if (pack->mappingHandle) CloseHandle((HANDLE)pack->mappingHandle);
+  if (pack->fileHandle) CloseHandle((HANDLE)pack->fileHandle);
+#else
+  if (pack->base) munmap((void*)pack->base, pack->size);
+#endif
+}
+
+int vsdl_pack_open(VSDL_Context* ctx, const char* path) {
+  VSDL_Pack* pack = &ctx->pack;
+  if (!map_file(pack, path)) {
+      SDL_Log("Asset pack %s not found, using loose files", path);
+      SDL_memset(pack, 0, sizeof(*pack));
+      return 0;
+  }
+
+  const VSDL_PackHeader* header = (const VSDL_PackHeader*)pack->base;
+  if (pack->size < sizeof(VSDL_PackHeader) ||
+      SDL_memcmp(header->magic, VSDL_PACK_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != VSDL_PACK_VERSION || header->tocOffset > pack->size ||
+      (uint64_t)header->entryCount * sizeof(VSDL_PackEntry) > pack->size - header->tocOffset ||
+      header->namesOffset > pack->size) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Invalid asset pack %s", path);
+      vsdl_pack_close(ctx);
+      return 0;
+  }
+
+  pack->header = header;
+  pack->entries = (const VSDL_PackEntry*)(pack->base + header->tocOffset);
+  pack->names = (const char*)(pack->base + header->namesOffset);
+  SDL_Log("Asset pack %s mapped (%u entries, %llu bytes)", path, header->entryCount, (unsigned long long)pack->size);
+  return 1;
+}
+
+void vsdl_pack_close(VSDL_Context* ctx) {
+  unmap_file(&ctx->pack);
+  SDL_memset(&ctx->pack, 0, sizeof(ctx->pack));
+}
+
+// Stays inside the mapping: a name whose offset or missing terminator runs past the end never matches
+static int names_match(const VSDL_Pack* pack, uint32_t nameOffset, const char* name) {
+  uint64_t start = pack->header->namesOffset + (uint64_t)nameOffset;
+  if (start >= pack->size) return 0;
+  const char* stored = pack->names + nameOffset;
+  const char* end = (const char*)pack->base + pack->size;
+  for (; stored < end; stored++, name++) {
+      char c = (*name == '\\') ? '/' : *name;
+      if (*stored != c) return 0;
+      if (!c) return 1;
+  }
+  return 0;
+}
+
+const VSDL_PackEntry* vsdl_pack_find(const VSDL_Pack* pack, const char* name) {
+  if (!pack->header) return NULL;
+
+  uint64_t hash = vsdl_pack_hash(name);
+  uint32_t lo = 0, hi = pack->header->entryCount;
+  while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (pack->entries[mid].hash < hash) lo = mid + 1;
+      else hi = mid;
+  }
+  // The packer rejects hash collisions, so a single candidate remains; confirm its name
+  if (lo < pack->header->entryCount && pack->entries[lo].hash == hash &&
+      names_match(pack, pack->entries[lo].nameOffset, name)) {
+      return &pack->entries[lo];
+  }
+  return NULL;
+}
+
+int vsdl_asset_load_from(const VSDL_Pack* pack, const char* name, VSDL_Asset* asset) {
+  SDL_memset(asset, 0, sizeof(*asset));
+
+  const VSDL_PackEntry* entry = vsdl_pack_find(pack, name);
+  if (entry) {
+      if (entry->offset > pack->size || entry->storedSize > pack->size - entry->offset) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Asset %s lies outside the pack", name);
+          return 0;
+      }
+      const unsigned char* stored = pack->base + entry->offset;
+      if (entry->compression == VSDL_PACK_COMPRESSION_NONE) {
+          // Only storedSize was checked against the mapping
+          if (entry->size != entry->storedSize) {
+              SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Corrupt entry in asset pack: %s", name);
+              return 0;
+          }
+          asset->data = stored;
+          asset->size = (size_t)entry->size;
+          return 1;
+      }
+      if (entry->compression == VSDL_PACK_COMPRESSION_LZ4) {
+          // LZ4 takes int sizes, and an empty entry is never stored compressed
+          if (entry->size == 0 || entry->size > INT_MAX || entry->storedSize > INT_MAX) {
+              SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Corrupt LZ4 entry in asset pack: %s", name);
+              return 0;
+          }
+          char* data = (char*)malloc((size_t)entry->size);
+          if (!data) return 0;
+          int written = LZ4_decompress_safe((const char*)stored, data, (int)entry->storedSize, (int)entry->size);
+          if (written != (int)entry->size) {
+              SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Corrupt LZ4 entry in asset pack: %s", name);
+              free(data);
+              return 0;
+          }
+          asset->data = data;
+          asset->size = (size_t)entry->size;
+          asset->owned = data;
+          return 1;
+      }
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unknown compression %u for %s", entry->compression, name);
+      return 0;
+  }
+
+  // Loose file fallback
+  size_t size;
+  char* data = readFile(name, &size);
+  if (!data) return 0;
+  asset->data = data;
+  asset->size = size;
+  asset->owned = data;
+  return 1;
+}
+
+int vsdl_asset_load(VSDL_Context* ctx, const char* name, VSDL_Asset* asset) {
+  return vsdl_asset_load_from(&ctx->pack, name, asset);
+}
+
+void vsdl_asset_release(VSDL_Asset* asset) {
+  if (asset->owned) free(asset->owned);
+  SDL_memset(asset, 0, sizeof(*asset));
+}
@@ -1,153 +1,609 @@
 #include <vulkan/vulkan.h>
-#include <SDL3/SDL_log.h>
+#include <SDL3/SDL.h>
 #include "vsdl_pipeline.h"
 #include "vsdl_types.h"
-#include "vsdl_utils.h"
+#include "vsdl_pack.h"
+#include "vsdl_workers.h"
 
-// Helper function to create a shader module
-static VkShaderModule create_shader_module(VkDevice device, const uint32_t* code, size_t codeSize) {
-    VkShaderModuleCreateInfo createInfo = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
-    createInfo.codeSize = codeSize;
-    createInfo.pCode = code;
+// hash_key and the variant lookups read the key as bytes; an odd attribute count would add tail padding
+SDL_COMPILE_TIME_ASSERT(pipeline_key_no_padding,
+                        sizeof(VSDL_PipelineKey) == 2 * sizeof(VkShaderModule) + sizeof(VkPipelineLayout) +
+                                                    (8 + 3 * VSDL_PIPELINE_MAX_ATTRIBUTES) * sizeof(uint32_t));
 
-    VkShaderModule shaderModule;
-    if (vkCreateShaderModule(device, &createInfo, NULL, &shaderModule) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create shader module");
-        return VK_NULL_HANDLE;
+static uint64_t hash_key(const VSDL_PipelineKey* key) {
+    const unsigned char* bytes = (const unsigned char*)key;
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < sizeof(*key); i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
     }
-    return shaderModule;
+    return hash;
 }
 
-int vsdl_create_graphics_pipeline(VSDL_Context* ctx) {
-    size_t vertSize, fragSize;
-    char* vertCode = readFile("shaders/shader2d.vert.spv", &vertSize);
-    char* fragCode = readFile("shaders/shader2d.frag.spv", &fragSize);
-    if (!vertCode || !fragCode) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load shaders");
-        free(vertCode);
-        free(fragCode);
-        return 0;
+static const char* shader_path(const VSDL_PipelineRegistry* registry, VkShaderModule module) {
+    for (uint32_t i = 0; i < registry->shaderCount; i++) {
+        if (registry->shaders[i].module == module) return registry->shaders[i].path;
     }
+    return "?";
+}
 
-    VkShaderModule vertModule, fragModule;
-    VkShaderModuleCreateInfo vertInfo = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
-    vertInfo.codeSize = vertSize;
-    vertInfo.pCode = (uint32_t*)vertCode;
-    VkShaderModuleCreateInfo fragInfo = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
-    fragInfo.codeSize = fragSize;
-    fragInfo.pCode = (uint32_t*)fragCode;
+void vsdl_pipeline_target_main_pass(VSDL_Context* ctx, VkGraphicsPipelineCreateInfo* pipelineInfo,
+                                    VkPipelineRenderingCreateInfo* renderingInfo) {
+    pipelineInfo->subpass = 0;
+    if (!ctx->features.dynamicRendering) {
+        pipelineInfo->renderPass = ctx->renderPass;
+        return;
+    }
+    *renderingInfo = (VkPipelineRenderingCreateInfo){VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO};
+    renderingInfo->pNext = pipelineInfo->pNext;
+    renderingInfo->colorAttachmentCount = 1;
+    renderingInfo->pColorAttachmentFormats = &ctx->swapchainImageFormat;
+    pipelineInfo->renderPass = VK_NULL_HANDLE;
+    pipelineInfo->pNext = renderingInfo;
+}
 
-    if (vkCreateShaderModule(ctx->device, &vertInfo, NULL, &vertModule) != VK_SUCCESS ||
-        vkCreateShaderModule(ctx->device, &fragInfo, NULL, &fragModule) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create shader modules");
-        free(vertCode);
-        free(fragCode);
+int vsdl_pipeline_registry_init(VSDL_Context* ctx) {
+    VSDL_PipelineRegistry* registry = &ctx->pipelines;
+    registry->lock = SDL_CreateMutex();
+    if (!registry->lock) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create pipeline registry mutex: %s", SDL_GetError());
         return 0;
     }
+    registry->compiled = SDL_CreateCondition();
+    if (!registry->compiled) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create pipeline registry condition: %s", SDL_GetError());
+        return 0;
+    }
+    return 1;
+}
+
+VkShaderModule vsdl_pipeline_shader(VSDL_Context* ctx, const char* path) {
+    VSDL_PipelineRegistry* registry = &ctx->pipelines;
+    SDL_LockMutex(registry->lock);
+    VkShaderModule module = VK_NULL_HANDLE;
+    for (uint32_t i = 0; i < registry->shaderCount; i++) {
+        if (SDL_strcmp(registry->shaders[i].path, path) == 0) {
+            module = registry->shaders[i].module;
+            break;
+        }
+    }
+    if (module == VK_NULL_HANDLE && registry->shaderCount < VSDL_PIPELINE_MAX_SHADERS) {
+        VSDL_Asset code;
+        if (vsdl_asset_load(ctx, path, &code)) {
+            VkShaderModuleCreateInfo createInfo = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
+            createInfo.codeSize = code.size;
+            createInfo.pCode = (const uint32_t*)code.data;
+            if (vkCreateShaderModule(ctx->device, &createInfo, NULL, &module) == VK_SUCCESS) {
+                VSDL_PipelineShader* shader = &registry->shaders[registry->shaderCount++];
+                SDL_strlcpy(shader->path, path, sizeof(shader->path));
+                shader->module = module;
+            } else {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create shader module %s", path);
+                module = VK_NULL_HANDLE;
+            }
+            vsdl_asset_release(&code);
+        }
+    } else if (module == VK_NULL_HANDLE) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Too many shaders, cannot load %s", path);
+    }
+    SDL_UnlockMutex(registry->lock);
+    return module;
+}
+
+VkPipelineLayout vsdl_pipeline_layout(VSDL_Context* ctx, const VkDescriptorSetLayout* setLayouts, uint32_t setLayoutCount,
+                                      const VkPushConstantRange* pushRange) {
+    VSDL_PipelineRegistry* registry = &ctx->pipelines;
+    if (setLayoutCount > VSDL_PIPELINE_MAX_SET_LAYOUTS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Too many descriptor set layouts (%u)", setLayoutCount);
+        return VK_NULL_HANDLE;
+    }
+    VSDL_PipelineLayoutEntry wanted = {0};
+    if (setLayoutCount) SDL_memcpy(wanted.setLayouts, setLayouts, setLayoutCount * sizeof(VkDescriptorSetLayout));
+    wanted.setLayoutCount = setLayoutCount;
+    if (pushRange) wanted.pushRange = *pushRange;
+
+    SDL_LockMutex(registry->lock);
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    for (uint32_t i = 0; i < registry->layoutCount && layout == VK_NULL_HANDLE; i++) {
+        const VSDL_PipelineLayoutEntry* entry = &registry->layouts[i];
+        if (entry->setLayoutCount == wanted.setLayoutCount &&
+            SDL_memcmp(entry->setLayouts, wanted.setLayouts, sizeof(wanted.setLayouts)) == 0 &&
+            entry->pushRange.stageFlags == wanted.pushRange.stageFlags &&
+            entry->pushRange.offset == wanted.pushRange.offset && entry->pushRange.size == wanted.pushRange.size) {
+            layout = entry->layout;
+        }
+    }
+    if (layout == VK_NULL_HANDLE && registry->layoutCount < VSDL_PIPELINE_MAX_LAYOUTS) {
+        VkPipelineLayoutCreateInfo layoutInfo = {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+        layoutInfo.setLayoutCount = setLayoutCount;
+        layoutInfo.pSetLayouts = setLayoutCount ? wanted.setLayouts : NULL;
+        layoutInfo.pushConstantRangeCount = wanted.pushRange.size ? 1 : 0;
+        layoutInfo.pPushConstantRanges = wanted.pushRange.size ? &wanted.pushRange : NULL;
+        if (vkCreatePipelineLayout(ctx->device, &layoutInfo, NULL, &wanted.layout) == VK_SUCCESS) {
+            registry->layouts[registry->layoutCount++] = wanted;
+            layout = wanted.layout;
+        } else {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create pipeline layout");
+        }
+    } else if (layout == VK_NULL_HANDLE) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Too many pipeline layouts");
+    }
+    SDL_UnlockMutex(registry->lock);
+    return layout;
+}
+
+// Every create-info a variant needs, filled from its key. Pointers refer into the struct, so fill it in place
+typedef struct {
+    VkPipelineShaderStageCreateInfo stages[2];
+    VkVertexInputBindingDescription binding;
+    VkVertexInputAttributeDescription attributes[VSDL_PIPELINE_MAX_ATTRIBUTES];
+    VkPipelineVertexInputStateCreateInfo vertexInput;
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly;
+    VkPipelineViewportStateCreateInfo viewport;
+    VkDynamicState dynamicStates[2];
+    VkPipelineDynamicStateCreateInfo dynamic;
+    VkPipelineRasterizationStateCreateInfo rasterizer;
+    VkPipelineMultisampleStateCreateInfo multisampling;
+    VkPipelineColorBlendAttachmentState blendAttachment;
+    VkPipelineColorBlendStateCreateInfo blend;
+    VkPipelineRenderingCreateInfo rendering;
+} PipelineState;
+
+static void fill_state(const VSDL_PipelineKey* key, PipelineState* state) {
+    SDL_memset(state, 0, sizeof(*state));
+    state->stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    state->stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    state->stages[0].module = key->vertexShader;
+    state->stages[0].pName = "main";
+    state->stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    state->stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    state->stages[1].module = key->fragmentShader;
+    state->stages[1].pName = "main";
+
+    state->binding.binding = 0;
+    state->binding.stride = key->vertexStride;
+    state->binding.inputRate = key->inputRate;
+    for (uint32_t i = 0; i < key->attributeCount; i++) {
+        state->attributes[i].location = key->attributes[i].location;
+        state->attributes[i].binding = 0;
+        state->attributes[i].format = key->attributes[i].format;
+        state->attributes[i].offset = key->attributes[i].offset;
+    }
+    state->vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    if (key->vertexStride) {
+        state->vertexInput.vertexBindingDescriptionCount = 1;
+        state->vertexInput.pVertexBindingDescriptions = &state->binding;
+        state->vertexInput.vertexAttributeDescriptionCount = key->attributeCount;
+        state->vertexInput.pVertexAttributeDescriptions = state->attributes;
+    }
 
-    VkPipelineShaderStageCreateInfo shaderStages[2] = {
-        {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO},
-        {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO}
-    };
-    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
-    shaderStages[0].module = vertModule;
-    shaderStages[0].pName = "main";
-    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    shaderStages[1].module = fragModule;
-    shaderStages[1].pName = "main";
-
-    VkVertexInputBindingDescription bindingDesc = {0};
-    bindingDesc.binding = 0;
-    bindingDesc.stride = sizeof(Vertex);
-    bindingDesc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-    VkVertexInputAttributeDescription attribDescs[2] = {
-        {0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, pos)}, // vec2 pos
-        {1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color)} // vec3 color
-    };
-
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDesc;
-    vertexInputInfo.vertexAttributeDescriptionCount = 2;
-    vertexInputInfo.pVertexAttributeDescriptions = attribDescs;
-
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO};
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-    VkViewport viewport = {0.0f, 0.0f, (float)ctx->swapchainExtent.width, (float)ctx->swapchainExtent.height, 0.0f, 1.0f};
-    VkRect2D scissor = {{0, 0}, ctx->swapchainExtent};
-    VkPipelineViewportStateCreateInfo viewportState = {VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO};
-    viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
-    viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
-
-    VkPipelineRasterizationStateCreateInfo rasterizer = {VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO};
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-
-    VkPipelineMultisampleStateCreateInfo multisampling = {VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO};
-    multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-    VkPipelineColorBlendAttachmentState colorBlendAttachment = {0};
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_FALSE;
-
-    VkPipelineColorBlendStateCreateInfo colorBlending = {VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO};
-    colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
-
-    // Create pipeline layout
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
-    pipelineLayoutInfo.setLayoutCount = 0; // No descriptor sets for triangle pipeline
-    pipelineLayoutInfo.pSetLayouts = NULL;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
-    pipelineLayoutInfo.pPushConstantRanges = NULL;
-
-    if (vkCreatePipelineLayout(ctx->device, &pipelineLayoutInfo, NULL, &ctx->pipelineLayout) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create pipeline layout");
-        vkDestroyShaderModule(ctx->device, fragModule, NULL);
-        vkDestroyShaderModule(ctx->device, vertModule, NULL);
-        free(vertCode);
-        free(fragCode);
+    state->inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    state->inputAssembly.topology = key->topology;
+    state->inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    // Viewport and scissor are set per command buffer, so a resize never needs new pipelines
+    state->viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    state->viewport.viewportCount = 1;
+    state->viewport.scissorCount = 1;
+    state->dynamicStates[0] = VK_DYNAMIC_STATE_VIEWPORT;
+    state->dynamicStates[1] = VK_DYNAMIC_STATE_SCISSOR;
+    state->dynamic.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    state->dynamic.dynamicStateCount = 2;
+    state->dynamic.pDynamicStates = state->dynamicStates;
+
+    state->rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    state->rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    state->rasterizer.lineWidth = 1.0f;
+    state->rasterizer.cullMode = key->cullMode;
+    state->rasterizer.frontFace = key->frontFace;
+
+    state->multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    state->multisampling.sampleShadingEnable = VK_FALSE;
+    state->multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineColorBlendAttachmentState* attachment = &state->blendAttachment;
+    attachment->colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    if (key->blend != VSDL_BLEND_NONE) {
+        attachment->blendEnable = VK_TRUE;
+        attachment->srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        attachment->dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        attachment->colorBlendOp = VK_BLEND_OP_ADD;
+        attachment->srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        attachment->dstAlphaBlendFactor = key->blend == VSDL_BLEND_ALPHA ? VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA
+                                                                         : VK_BLEND_FACTOR_ZERO;
+        attachment->alphaBlendOp = VK_BLEND_OP_ADD;
+    }
+    state->blend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    state->blend.logicOpEnable = VK_FALSE;
+    state->blend.attachmentCount = 1;
+    state->blend.pAttachments = attachment;
+}
+
+// Other color formats need dynamic rendering; the fallback render pass only knows the swapchain's
+static int target_color_format(VSDL_Context* ctx, const VSDL_PipelineKey* key, VkGraphicsPipelineCreateInfo* pipelineInfo,
+                               PipelineState* state) {
+    if (key->colorFormat == VK_FORMAT_UNDEFINED || key->colorFormat == ctx->swapchainImageFormat) {
+        vsdl_pipeline_target_main_pass(ctx, pipelineInfo, &state->rendering);
+        return 1;
+    }
+    if (!ctx->features.dynamicRendering) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Pipeline color format %d needs dynamic rendering", key->colorFormat);
         return 0;
     }
-    SDL_Log("Pipeline layout created");
+    state->rendering = (VkPipelineRenderingCreateInfo){VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO};
+    state->rendering.pNext = pipelineInfo->pNext;
+    state->rendering.colorAttachmentCount = 1;
+    state->rendering.pColorAttachmentFormats = &key->colorFormat;
+    pipelineInfo->pNext = &state->rendering;
+    return 1;
+}
+
+static VkPipeline create_variant(VSDL_Context* ctx, const VSDL_PipelineKey* key) {
+    PipelineState state;
+    fill_state(key, &state);
 
     VkGraphicsPipelineCreateInfo pipelineInfo = {VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
     pipelineInfo.stageCount = 2;
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.layout = ctx->pipelineLayout;
-    pipelineInfo.renderPass = ctx->renderPass;
-    pipelineInfo.subpass = 0;
-
-    if (vkCreateGraphicsPipelines(ctx->device, VK_NULL_HANDLE, 1, &pipelineInfo, NULL, &ctx->graphicsPipeline) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create graphics pipeline");
-        vkDestroyPipelineLayout(ctx->device, ctx->pipelineLayout, NULL);
-        vkDestroyShaderModule(ctx->device, fragModule, NULL);
-        vkDestroyShaderModule(ctx->device, vertModule, NULL);
-        free(vertCode);
-        free(fragCode);
+    pipelineInfo.pStages = state.stages;
+    pipelineInfo.pVertexInputState = &state.vertexInput;
+    pipelineInfo.pInputAssemblyState = &state.inputAssembly;
+    pipelineInfo.pViewportState = &state.viewport;
+    pipelineInfo.pRasterizationState = &state.rasterizer;
+    pipelineInfo.pMultisampleState = &state.multisampling;
+    pipelineInfo.pColorBlendState = &state.blend;
+    pipelineInfo.pDynamicState = &state.dynamic;
+    pipelineInfo.layout = key->layout;
+    if (!target_color_format(ctx, key, &pipelineInfo, &state)) return VK_NULL_HANDLE;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(ctx->device, VK_NULL_HANDLE, 1, &pipelineInfo, NULL, &pipeline) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+    return pipeline;
+}
+
+static const VkGraphicsPipelineLibraryFlagsEXT libraryParts[4] = {
+    VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT
+};
+
+// The fields of key that one library part depends on; everything else stays zero
+static void library_key(VkGraphicsPipelineLibraryFlagsEXT part, const VSDL_PipelineKey* key, VSDL_PipelineKey* out) {
+    SDL_memset(out, 0, sizeof(*out));
+    switch (part) {
+    case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT:
+        out->vertexStride = key->vertexStride;
+        out->inputRate = key->inputRate;
+        out->attributeCount = key->attributeCount;
+        SDL_memcpy(out->attributes, key->attributes, sizeof(out->attributes));
+        out->topology = key->topology;
+        break;
+    case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+        out->vertexShader = key->vertexShader;
+        out->layout = key->layout;
+        out->cullMode = key->cullMode;
+        out->frontFace = key->frontFace;
+        out->colorFormat = key->colorFormat;
+        break;
+    case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+        out->fragmentShader = key->fragmentShader;
+        out->layout = key->layout;
+        out->colorFormat = key->colorFormat;
+        break;
+    default:
+        out->blend = key->blend;
+        out->colorFormat = key->colorFormat;
+        break;
+    }
+}
+
+static VkPipeline create_library(VSDL_Context* ctx, VkGraphicsPipelineLibraryFlagsEXT part, const VSDL_PipelineKey* key) {
+    PipelineState state;
+    fill_state(key, &state);
+
+    VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo = {VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT};
+    libraryInfo.flags = part;
+    VkGraphicsPipelineCreateInfo pipelineInfo = {VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+    pipelineInfo.pNext = &libraryInfo;
+    // Keep what link-time optimization needs, so the background link can produce a full-speed pipeline
+    pipelineInfo.flags = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+    switch (part) {
+    case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT:
+        pipelineInfo.pVertexInputState = &state.vertexInput;
+        pipelineInfo.pInputAssemblyState = &state.inputAssembly;
+        break;
+    case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+        pipelineInfo.stageCount = 1;
+        pipelineInfo.pStages = &state.stages[0];
+        pipelineInfo.pViewportState = &state.viewport;
+        pipelineInfo.pRasterizationState = &state.rasterizer;
+        pipelineInfo.pDynamicState = &state.dynamic;
+        pipelineInfo.layout = key->layout;
+        break;
+    case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+        pipelineInfo.stageCount = 1;
+        pipelineInfo.pStages = &state.stages[1];
+        pipelineInfo.pMultisampleState = &state.multisampling;
+        pipelineInfo.layout = key->layout;
+        break;
+    default:
+        pipelineInfo.pColorBlendState = &state.blend;
+        pipelineInfo.pMultisampleState = &state.multisampling;
+        break;
+    }
+    if (part != VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT &&
+        !target_color_format(ctx, key, &pipelineInfo, &state)) {
+        return VK_NULL_HANDLE;
+    }
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(ctx->device, VK_NULL_HANDLE, 1, &pipelineInfo, NULL, &pipeline) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+    return pipeline;
+}
+
+// Registry lock held
+static VkPipeline find_library(const VSDL_PipelineRegistry* registry, VkGraphicsPipelineLibraryFlagsEXT part,
+                               const VSDL_PipelineKey* partKey) {
+    for (uint32_t i = 0; i < registry->libraryCount; i++) {
+        const VSDL_PipelineLibrary* library = &registry->libraries[i];
+        if (library->part == part && SDL_memcmp(&library->key, partKey, sizeof(*partKey)) == 0) return library->pipeline;
+    }
+    return VK_NULL_HANDLE;
+}
+
+// Compiles without the registry lock; when two variants race for the same part, the later copy is dropped
+static VkPipeline get_library(VSDL_Context* ctx, VkGraphicsPipelineLibraryFlagsEXT part, const VSDL_PipelineKey* key) {
+    VSDL_PipelineRegistry* registry = &ctx->pipelines;
+    VSDL_PipelineKey partKey;
+    library_key(part, key, &partKey);
+    SDL_LockMutex(registry->lock);
+    VkPipeline pipeline = find_library(registry, part, &partKey);
+    SDL_UnlockMutex(registry->lock);
+    if (pipeline != VK_NULL_HANDLE) return pipeline;
+
+    VkPipeline created = create_library(ctx, part, key);
+    if (created == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+    SDL_LockMutex(registry->lock);
+    pipeline = find_library(registry, part, &partKey);
+    if (pipeline == VK_NULL_HANDLE && registry->libraryCount < VSDL_PIPELINE_MAX_LIBRARIES) {
+        VSDL_PipelineLibrary* library = &registry->libraries[registry->libraryCount++];
+        library->part = part;
+        library->key = partKey;
+        library->pipeline = created;
+        pipeline = created;
+    } else if (pipeline == VK_NULL_HANDLE) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Too many pipeline libraries");
+    }
+    SDL_UnlockMutex(registry->lock);
+    if (pipeline != created) vkDestroyPipeline(ctx->device, created, NULL);
+    return pipeline;
+}
+
+static VkPipeline link_libraries(VSDL_Context* ctx, const VkPipeline* libraries, VkPipelineLayout layout, int optimize) {
+    VkPipelineLibraryCreateInfoKHR linkInfo = {VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR};
+    linkInfo.libraryCount = 4;
+    linkInfo.pLibraries = libraries;
+    VkGraphicsPipelineCreateInfo pipelineInfo = {VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+    pipelineInfo.pNext = &linkInfo;
+    pipelineInfo.flags = optimize ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0;
+    pipelineInfo.layout = layout;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(ctx->device, VK_NULL_HANDLE, 1, &pipelineInfo, NULL, &pipeline) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+    return pipeline;
+}
+
+// Worker job: the full link-time optimized compile of a variant that was fast-linked on the hot path
+static void optimize_job(void* data) {
+    VSDL_PipelineOptimizeJob* job = (VSDL_PipelineOptimizeJob*)data;
+    VSDL_Context* ctx = job->ctx;
+    VSDL_PipelineRegistry* registry = &ctx->pipelines;
+    // Variants never move and their key and libraries are fixed once published
+    VSDL_PipelineVariant* variant = &registry->variants[job->variant];
+    Uint64 start = SDL_GetTicksNS();
+    VkPipeline optimized = link_libraries(ctx, variant->libraries, variant->key.layout, 1);
+    if (optimized == VK_NULL_HANDLE) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to optimize pipeline %016llx; keeping the fast-linked one",
+                     (unsigned long long)variant->hash);
+        return;
+    }
+    // Bind-time lookups read optimized without the lock once the state says it is there
+    variant->optimized = optimized;
+    SDL_SetAtomicInt(&variant->state, VSDL_PIPELINE_VARIANT_OPTIMIZED);
+    SDL_Log("Pipeline %016llx optimized in the background in %.2f ms", (unsigned long long)variant->hash,
+            (double)(SDL_GetTicksNS() - start) / 1e6);
+}
+
+// Startup links with full optimization right away; on the hot path the caller gets the fast link
+// and queues the optimized one
+static VkPipeline create_linked_variant(VSDL_Context* ctx, const VSDL_PipelineKey* key, VSDL_PipelineVariant* variant,
+                                        int warm) {
+    for (uint32_t i = 0; i < 4; i++) {
+        variant->libraries[i] = get_library(ctx, libraryParts[i], key);
+        if (variant->libraries[i] == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+    }
+    return link_libraries(ctx, variant->libraries, key->layout, !warm);
+}
+
+static uint32_t lookup_slot(VkPipeline pipeline) {
+    uint64_t bits = (uint64_t)pipeline;
+    return (uint32_t)((bits ^ (bits >> 17)) * 2654435761u) & (VSDL_PIPELINE_LOOKUP_SLOTS - 1);
+}
+
+// Registry lock held, so there is one writer; readers only ever see a slot go from 0 to its final index
+static void publish_lookup(VSDL_PipelineRegistry* registry, VkPipeline pipeline, uint32_t index) {
+    for (uint32_t i = lookup_slot(pipeline);; i = (i + 1) & (VSDL_PIPELINE_LOOKUP_SLOTS - 1)) {
+        if (SDL_GetAtomicInt(&registry->lookup[i]) == 0) {
+            SDL_SetAtomicInt(&registry->lookup[i], (int)index + 1);
+            return;
+        }
+    }
+}
+
+// Registry lock held. Waits out another thread compiling the same key
+static VkPipeline find_variant(VSDL_PipelineRegistry* registry, const VSDL_PipelineKey* key, uint64_t hash, int* found) {
+    for (uint32_t i = 0; i < registry->variantCount; i++) {
+        VSDL_PipelineVariant* variant = &registry->variants[i];
+        if (variant->hash != hash || SDL_memcmp(&variant->key, key, sizeof(*key)) != 0) continue;
+        while (SDL_GetAtomicInt(&variant->state) == VSDL_PIPELINE_VARIANT_COMPILING) {
+            SDL_WaitCondition(registry->compiled, registry->lock);
+        }
+        *found = 1;
+        switch (SDL_GetAtomicInt(&variant->state)) {
+        case VSDL_PIPELINE_VARIANT_OPTIMIZED: return variant->optimized;
+        case VSDL_PIPELINE_VARIANT_READY: return variant->pipeline;
+        default: return VK_NULL_HANDLE;
+        }
+    }
+    *found = 0;
+    return VK_NULL_HANDLE;
+}
+
+VkPipeline vsdl_pipeline_get(VSDL_Context* ctx, const VSDL_PipelineKey* key) {
+    VSDL_PipelineRegistry* registry = &ctx->pipelines;
+    if (key->vertexShader == VK_NULL_HANDLE || key->fragmentShader == VK_NULL_HANDLE || key->layout == VK_NULL_HANDLE ||
+        key->attributeCount > VSDL_PIPELINE_MAX_ATTRIBUTES) {
+        return VK_NULL_HANDLE;
+    }
+    uint64_t hash = hash_key(key);
+
+    SDL_LockMutex(registry->lock);
+    int found;
+    VkPipeline pipeline = find_variant(registry, key, hash, &found);
+    if (found || registry->variantCount == VSDL_PIPELINE_MAX_VARIANTS) {
+        if (!found) SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Too many pipeline variants");
+        SDL_UnlockMutex(registry->lock);
+        return pipeline;
+    }
+    // Claim the slot so other threads asking for this key wait for it instead of compiling it again,
+    // then compile without the lock so lookups of other variants are not held up
+    uint32_t index = registry->variantCount++;
+    VSDL_PipelineVariant* variant = &registry->variants[index];
+    variant->hash = hash;
+    variant->key = *key;
+    SDL_SetAtomicInt(&variant->state, VSDL_PIPELINE_VARIANT_COMPILING);
+    int warm = registry->warm;
+    SDL_UnlockMutex(registry->lock);
+
+    Uint64 start = SDL_GetTicksNS();
+    pipeline = ctx->features.graphicsPipelineLibrary ? create_linked_variant(ctx, key, variant, warm)
+                                                     : create_variant(ctx, key);
+    double ms = (double)(SDL_GetTicksNS() - start) / 1e6;
+
+    SDL_LockMutex(registry->lock);
+    variant->pipeline = pipeline;
+    if (pipeline == VK_NULL_HANDLE) {
+        SDL_SetAtomicInt(&variant->state, VSDL_PIPELINE_VARIANT_FAILED);
+    } else {
+        SDL_SetAtomicInt(&variant->state, VSDL_PIPELINE_VARIANT_READY);
+        publish_lookup(registry, pipeline, index);
+        variant->hot = warm;
+        if (warm) registry->hotCreated++;
+    }
+    SDL_BroadcastCondition(registry->compiled);
+    SDL_UnlockMutex(registry->lock);
+
+    if (pipeline == VK_NULL_HANDLE) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create pipeline %016llx (%s, %s)", (unsigned long long)hash,
+                     shader_path(registry, key->vertexShader), shader_path(registry, key->fragmentShader));
+    } else if (warm) {
+        // Stalled a frame (briefly, when fast-linked); this variant belongs in the startup set
+        SDL_Log("Pipeline %016llx (%s, %s) created on the hot path in %.2f ms; prewarm it at startup",
+                (unsigned long long)hash, shader_path(registry, key->vertexShader),
+                shader_path(registry, key->fragmentShader), ms);
+        if (ctx->features.graphicsPipelineLibrary) {
+            VSDL_PipelineOptimizeJob* job = &registry->optimizeJobs[index];
+            job->ctx = ctx;
+            job->variant = index;
+            if (!vsdl_workers_submit(ctx, optimize_job, job)) {
+                SDL_Log("Worker queue full; pipeline %016llx stays fast-linked", (unsigned long long)hash);
+            }
+        }
+    }
+    return pipeline;
+}
+
+// A fast-linked handle stays valid until shutdown, since command buffers recorded before the
+// optimized link finished may still reference it. Called per bind, so it takes no lock
+VkPipeline vsdl_pipeline_resolve(VSDL_Context* ctx, VkPipeline pipeline) {
+    VSDL_PipelineRegistry* registry = &ctx->pipelines;
+    if (!ctx->features.graphicsPipelineLibrary || pipeline == VK_NULL_HANDLE) return pipeline;
+    for (uint32_t i = lookup_slot(pipeline);; i = (i + 1) & (VSDL_PIPELINE_LOOKUP_SLOTS - 1)) {
+        int entry = SDL_GetAtomicInt(&registry->lookup[i]);
+        if (entry == 0) return pipeline;
+        VSDL_PipelineVariant* variant = &registry->variants[entry - 1];
+        if (variant->pipeline != pipeline) continue;
+        return SDL_GetAtomicInt(&variant->state) == VSDL_PIPELINE_VARIANT_OPTIMIZED ? variant->optimized : pipeline;
+    }
+}
+
+void vsdl_pipeline_registry_warm(VSDL_Context* ctx) {
+    VSDL_PipelineRegistry* registry = &ctx->pipelines;
+    SDL_LockMutex(registry->lock);
+    registry->warm = 1;
+    SDL_Log("Pipeline registry: %u variants, %u shaders, %u layouts, %u libraries prewarmed",
+            registry->variantCount, registry->shaderCount, registry->layoutCount, registry->libraryCount);
+    SDL_UnlockMutex(registry->lock);
+}
+
+void vsdl_pipeline_registry_shutdown(VSDL_Context* ctx) {
+    VSDL_PipelineRegistry* registry = &ctx->pipelines;
+    if (registry->hotCreated) {
+        SDL_Log("Pipeline registry: %u of %u variants were created on the hot path:", registry->hotCreated, registry->variantCount);
+        for (uint32_t i = 0; i < registry->variantCount; i++) {
+            const VSDL_PipelineVariant* variant = &registry->variants[i];
+            if (!variant->hot) continue;
+            SDL_Log("  %016llx (%s, %s)", (unsigned long long)variant->hash,
+                    shader_path(registry, variant->key.vertexShader), shader_path(registry, variant->key.fragmentShader));
+        }
+    }
+    if (ctx->device != VK_NULL_HANDLE) {
+        // The workers are gone, so no variant is still compiling or being optimized
+        for (uint32_t i = 0; i < registry->variantCount; i++) {
+            vkDestroyPipeline(ctx->device, registry->variants[i].pipeline, NULL);
+            if (registry->variants[i].optimized) vkDestroyPipeline(ctx->device, registry->variants[i].optimized, NULL);
+        }
+        // Linked pipelines do not reference their libraries, so these can go in any order
+        for (uint32_t i = 0; i < registry->libraryCount; i++) vkDestroyPipeline(ctx->device, registry->libraries[i].pipeline, NULL);
+        for (uint32_t i = 0; i < registry->layoutCount; i++) vkDestroyPipelineLayout(ctx->device, registry->layouts[i].layout, NULL);
+        for (uint32_t i = 0; i < registry->shaderCount; i++) vkDestroyShaderModule(ctx->device, registry->shaders[i].module, NULL);
+    }
+    if (registry->compiled) SDL_DestroyCondition(registry->compiled);
+    if (registry->lock) SDL_DestroyMutex(registry->lock);
+    SDL_memset(registry, 0, sizeof(*registry));
+}
+
+int vsdl_create_graphics_pipeline(VSDL_Context* ctx) {
+    VSDL_PipelineKey key = {0};
+    key.vertexShader = vsdl_pipeline_shader(ctx, "shaders/shader2d.vert.spv");
+    key.fragmentShader = vsdl_pipeline_shader(ctx, "shaders/shader2d.frag.spv");
+    if (key.vertexShader == VK_NULL_HANDLE || key.fragmentShader == VK_NULL_HANDLE) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load shaders");
         return 0;
     }
+    // No descriptor sets for the triangle pipeline
+    key.layout = vsdl_pipeline_layout(ctx, NULL, 0, NULL);
+    if (key.layout == VK_NULL_HANDLE) return 0;
+    ctx->pipelineLayout = key.layout;
 
-    vkDestroyShaderModule(ctx->device, fragModule, NULL);
-    vkDestroyShaderModule(ctx->device, vertModule, NULL);
-    free(vertCode);
-    free(fragCode);
+    key.vertexStride = sizeof(Vertex);
+    key.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    key.attributeCount = 2;
+    key.attributes[0] = (VSDL_VertexAttribute){0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, pos)};      // vec2 pos
+    key.attributes[1] = (VSDL_VertexAttribute){1, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color)}; // vec3 color
+    key.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    key.cullMode = VK_CULL_MODE_BACK_BIT;
+    key.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    key.blend = VSDL_BLEND_NONE;
 
+    ctx->graphicsPipeline = vsdl_pipeline_get(ctx, &key);
+    if (ctx->graphicsPipeline == VK_NULL_HANDLE) return 0;
     SDL_Log("Graphics pipeline created");
     return 1;
-}
\ No newline at end of file
+}
@@ -0,0 +1,122 @@
+#include <SDL3/SDL.h>
+#include <vulkan/vulkan.h>
+#include "vsdl_record.h"
+#include "vsdl_types.h"
+#include "vsdl_workers.h"
+
+typedef struct {
+  VSDL_Context* ctx;
+  const VSDL_RecordTask* task;
+  const VkCommandBufferInheritanceInfo* inheritance;
+  VkExtent2D extent;
+  VkCommandBuffer commandBuffer;
+  int ok;
+} RecordJob;
+
+// Pools are externally synchronized, so each thread only touches its own slot
+static VkCommandBuffer next_secondary(VSDL_Context* ctx) {
+  uint32_t slot = vsdl_workers_thread_slot();
+  VSDL_RecordPool* pool = &ctx->recorder.pools[slot];
+  if (pool->pool == VK_NULL_HANDLE) {
+      VkCommandPoolCreateInfo poolInfo = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+      poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+      poolInfo.queueFamilyIndex = ctx->graphicsFamily;
+      if (vkCreateCommandPool(ctx->device, &poolInfo, NULL, &pool->pool) != VK_SUCCESS) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create recording command pool");
+          return VK_NULL_HANDLE;
+      }
+  }
+  if (pool->used == pool->allocated) {
+      if (pool->allocated == VSDL_RECORD_POOL_BUFFERS) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of secondary command buffers on thread slot %u", slot);
+          return VK_NULL_HANDLE;
+      }
+      VkCommandBufferAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+      allocInfo.commandPool = pool->pool;
+      allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+      allocInfo.commandBufferCount = 1;
+      if (vkAllocateCommandBuffers(ctx->device, &allocInfo, &pool->buffers[pool->allocated]) != VK_SUCCESS) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate secondary command buffer");
+          return VK_NULL_HANDLE;
+      }
+      pool->allocated++;
+  }
+  return pool->buffers[pool->used++];
+}
+
+static void record_job(void* data) {
+  RecordJob* job = (RecordJob*)data;
+  VkCommandBuffer commandBuffer = next_secondary(job->ctx);
+  if (commandBuffer != VK_NULL_HANDLE) {
+      VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+      beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+      beginInfo.pInheritanceInfo = job->inheritance;
+      if (vkBeginCommandBuffer(commandBuffer, &beginInfo) == VK_SUCCESS) {
+          // Dynamic state is not inherited, and every registry pipeline leaves viewport and scissor dynamic
+          VkExtent2D extent = job->extent;
+          VkViewport viewport = {0.0f, 0.0f, (float)extent.width, (float)extent.height, 0.0f, 1.0f};
+          VkRect2D scissor = {{0, 0}, extent};
+          vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+          vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+          job->task->fn(job->ctx, commandBuffer, job->task->data);
+          if (vkEndCommandBuffer(commandBuffer) == VK_SUCCESS) {
+              job->commandBuffer = commandBuffer;
+              job->ok = 1;
+          }
+      }
+  }
+  if (!job->ok) SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to record secondary command buffer");
+}
+
+void vsdl_record_begin_frame(VSDL_Context* ctx) {
+  for (uint32_t i = 0; i <= VSDL_MAX_WORKERS; i++) {
+      VSDL_RecordPool* pool = &ctx->recorder.pools[i];
+      if (pool->used == 0) continue;
+      vkResetCommandPool(ctx->device, pool->pool, 0);
+      pool->used = 0;
+  }
+}
+
+int vsdl_record_execute(VSDL_Context* ctx, VkCommandBuffer commandBuffer,
+                        const VkCommandBufferInheritanceInfo* inheritance, VkExtent2D extent,
+                        const VSDL_RecordTask* tasks, uint32_t count) {
+  if (count == 0) return 1;
+  if (count > VSDL_RECORD_MAX_TASKS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Too many recording tasks: %u", count);
+      return 0;
+  }
+
+  RecordJob jobs[VSDL_RECORD_MAX_TASKS];
+  SDL_memset(jobs, 0, sizeof(jobs));
+  VSDL_JobCounter counter;
+  SDL_SetAtomicInt(&counter.value, 0);
+  for (uint32_t i = 0; i < count; i++) {
+      jobs[i].ctx = ctx;
+      jobs[i].task = &tasks[i];
+      jobs[i].inheritance = inheritance;
+      jobs[i].extent = extent;
+      if (i > 0 && !vsdl_workers_submit_counted(ctx, record_job, &jobs[i], &counter)) {
+          record_job(&jobs[i]);  // Queue full: record it here
+      }
+  }
+  // The caller records too instead of idling
+  record_job(&jobs[0]);
+  vsdl_workers_wait(ctx, &counter);
+
+  VkCommandBuffer buffers[VSDL_RECORD_MAX_TASKS];
+  uint32_t recorded = 0;
+  for (uint32_t i = 0; i < count; i++) {
+      if (jobs[i].ok) buffers[recorded++] = jobs[i].commandBuffer;
+  }
+  if (recorded > 0) vkCmdExecuteCommands(commandBuffer, recorded, buffers);
+  return recorded == count;
+}
+
+void vsdl_record_shutdown(VSDL_Context* ctx) {
+  for (uint32_t i = 0; i <= VSDL_MAX_WORKERS; i++) {
+      VSDL_RecordPool* pool = &ctx->recorder.pools[i];
+      // Destroying the pool frees its buffers
+      if (pool->pool != VK_NULL_HANDLE) vkDestroyCommandPool(ctx->device, pool->pool, NULL);
+  }
+  SDL_memset(&ctx->recorder, 0, sizeof(ctx->recorder));
+}
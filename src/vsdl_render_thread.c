@@ -0,0 +1,142 @@
+#include <SDL3/SDL.h>
+#include "vsdl_render_thread.h"
+#include "vsdl_types.h"
+#include "vsdl_renderer.h"
+#include "vsdl_arena.h"
+#include "vsdl_cimgui.h"
+#include "vsdl_debug.h"
+
+static int render_thread_main(void* data) {
+  VSDL_Context* ctx = (VSDL_Context*)data;
+  VSDL_RenderThread* rt = &ctx->renderThread;
+  for (;;) {
+      SDL_LockMutex(rt->mutex);
+      VSDL_FramePacket* packet = &rt->packets[rt->readIndex % VSDL_FRAME_PACKETS];
+      while (packet->state != VSDL_PACKET_QUEUED && !rt->quit) {
+          SDL_WaitCondition(rt->condition, rt->mutex);
+      }
+      // Quit only once the queue is drained so every built frame is presented
+      if (packet->state != VSDL_PACKET_QUEUED) {
+          SDL_UnlockMutex(rt->mutex);
+          break;
+      }
+      packet->state = VSDL_PACKET_RENDERING;
+      SDL_UnlockMutex(rt->mutex);
+
+      vsdl_render_frame(ctx, packet);
+
+      SDL_LockMutex(rt->mutex);
+      packet->state = VSDL_PACKET_FREE;
+      rt->readIndex++;
+      SDL_BroadcastCondition(rt->condition);
+      SDL_UnlockMutex(rt->mutex);
+  }
+  return 0;
+}
+
+int vsdl_render_thread_init(VSDL_Context* ctx) {
+  VSDL_RenderThread* rt = &ctx->renderThread;
+  for (uint32_t i = 0; i < VSDL_FRAME_PACKETS; i++) {
+      if (!vsdl_arena_init(&rt->packets[i].arena, 256 * 1024)) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate frame packet arena");
+          return 0;
+      }
+  }
+  return 1;
+}
+
+int vsdl_render_thread_start(VSDL_Context* ctx) {
+  VSDL_RenderThread* rt = &ctx->renderThread;
+  rt->mutex = SDL_CreateMutex();
+  rt->condition = SDL_CreateCondition();
+  if (!rt->mutex || !rt->condition) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create render thread synchronization: %s", SDL_GetError());
+      return 0;
+  }
+  rt->thread = SDL_CreateThread(render_thread_main, "vsdl_render", ctx);
+  if (!rt->thread) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create render thread: %s", SDL_GetError());
+      return 0;
+  }
+  SDL_Log("Render thread started (%u frame packets)", VSDL_FRAME_PACKETS);
+  return 1;
+}
+
+VSDL_FramePacket* vsdl_frame_packet_acquire(VSDL_Context* ctx) {
+  VSDL_RenderThread* rt = &ctx->renderThread;
+  VSDL_FramePacket* packet = &rt->packets[rt->writeIndex % VSDL_FRAME_PACKETS];
+  if (rt->thread) {
+      uint64_t start = SDL_GetTicksNS();
+      SDL_LockMutex(rt->mutex);
+      while (packet->state != VSDL_PACKET_FREE) {
+          SDL_WaitCondition(rt->condition, rt->mutex);
+      }
+      SDL_UnlockMutex(rt->mutex);
+      rt->buildStallNS += SDL_GetTicksNS() - start;
+  }
+
+  packet->state = VSDL_PACKET_BUILDING;
+  packet->frameNumber = rt->framesBuilt;
+  packet->textItems = NULL;
+  packet->textCount = 0;
+  packet->textCapacity = 0;
+  packet->textObjects = NULL;
+  packet->textObjectCount = 0;
+  packet->textObjectCapacity = 0;
+  packet->textViews = NULL;
+  packet->textViewCount = 0;
+  packet->textViewCapacity = 0;
+  packet->sprites = NULL;
+  packet->spriteCount = 0;
+  packet->spriteCapacity = 0;
+  vsdl_arena_reset(&packet->arena);
+  SDL_GetWindowSize(ctx->window, &packet->windowWidth, &packet->windowHeight);
+  vsdl_debug_begin(ctx, packet);
+  rt->building = packet;
+  return packet;
+}
+
+void vsdl_frame_packet_submit(VSDL_Context* ctx, VSDL_FramePacket* packet) {
+  VSDL_RenderThread* rt = &ctx->renderThread;
+  rt->building = NULL;
+  rt->writeIndex++;
+  rt->framesBuilt++;
+  if (!rt->thread) {
+      vsdl_render_frame(ctx, packet);
+      packet->state = VSDL_PACKET_FREE;
+      rt->readIndex++;
+      return;
+  }
+  SDL_LockMutex(rt->mutex);
+  packet->state = VSDL_PACKET_QUEUED;
+  SDL_BroadcastCondition(rt->condition);
+  SDL_UnlockMutex(rt->mutex);
+}
+
+void vsdl_render_thread_flush(VSDL_Context* ctx) {
+  VSDL_RenderThread* rt = &ctx->renderThread;
+  if (!rt->thread) return;
+  SDL_LockMutex(rt->mutex);
+  while (rt->readIndex != rt->writeIndex) {
+      SDL_WaitCondition(rt->condition, rt->mutex);
+  }
+  SDL_UnlockMutex(rt->mutex);
+}
+
+void vsdl_render_thread_shutdown(VSDL_Context* ctx) {
+  VSDL_RenderThread* rt = &ctx->renderThread;
+  if (rt->thread) {
+      SDL_LockMutex(rt->mutex);
+      rt->quit = 1;
+      SDL_BroadcastCondition(rt->condition);
+      SDL_UnlockMutex(rt->mutex);
+      SDL_WaitThread(rt->thread, NULL);
+  }
+  for (uint32_t i = 0; i < VSDL_FRAME_PACKETS; i++) {
+      vsdl_cimgui_destroy_packet(&rt->packets[i]);
+      vsdl_arena_destroy(&rt->packets[i].arena);
+  }
+  if (rt->condition) SDL_DestroyCondition(rt->condition);
+  if (rt->mutex) SDL_DestroyMutex(rt->mutex);
+  SDL_memset(rt, 0, sizeof(*rt));
+}
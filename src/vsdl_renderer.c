@@ -6,96 +6,53 @@
 #include "vsdl_types.h"
 #include "vsdl_text.h"
 #include "vsdl_pipeline.h"
+#include "vsdl_gpu_cull.h"
+#include "vsdl_texture.h"
+#include "vsdl_upload.h"
+#include "vsdl_mesh.h"
+#include "vsdl_memory.h"
+#include "vsdl_arena.h"
+#include "vsdl_idle.h"
+#include "vsdl_render_thread.h"
+#include "vsdl_record.h"
+#include "vsdl_graph.h"
+#include "vsdl_sprite.h"
+#include "vsdl_debug.h"
+#include "vsdl_descriptor.h"
+#include "vsdl_sync.h"
+#include "vsdl_scale.h"
+#include "vsdl_text_object.h"
+#include "vsdl_text_view.h"
 #include <cimgui.h>
 #include <cimgui_impl.h>
 #include "vsdl_cimgui.h"
 
 int vsdl_init_renderer(VSDL_Context* ctx) {
-  Vertex vertices[] = {
-      {{ 0.0f, -0.5f}, {1.0f, 0.0f, 0.0f}},
-      {{ 0.5f,  0.5f}, {0.0f, 1.0f, 0.0f}},
-      {{-0.5f,  0.5f}, {0.0f, 0.0f, 1.0f}}
-  };
-
-  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-  bufferInfo.size = sizeof(vertices);
-  bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-  VmaAllocationCreateInfo allocInfo = {0};
-  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-  allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
-
-  if (vmaCreateBuffer(ctx->allocator, &bufferInfo, &allocInfo, &ctx->vertexBuffer, &ctx->vertexBufferAllocation, NULL) != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create vertex buffer");
-      return 0;
-  }
-
-  void* data;
-  if (vmaMapMemory(ctx->allocator, ctx->vertexBufferAllocation, &data) != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to map vertex buffer memory");
+  if (!create_vertex_buffer(ctx)) {
       return 0;
   }
-  memcpy(data, vertices, sizeof(vertices));
-  vmaUnmapMemory(ctx->allocator, ctx->vertexBufferAllocation);
 
   if (!vsdl_create_graphics_pipeline(ctx)) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create graphics pipeline");
       return 0;
   }
 
-  ctx->framebuffers = (VkFramebuffer*)malloc(ctx->swapchainImageCount * sizeof(VkFramebuffer));
-  if (!ctx->framebuffers) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate framebuffer array");
-      return 0;
-  }
-  for (uint32_t i = 0; i < ctx->swapchainImageCount; i++) {
-      VkImageView attachments[] = {ctx->swapchainImageViews[i]};
-      VkFramebufferCreateInfo fbInfo = {VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
-      fbInfo.renderPass = ctx->renderPass;
-      fbInfo.attachmentCount = 1;
-      fbInfo.pAttachments = attachments;
-      fbInfo.width = ctx->swapchainExtent.width;
-      fbInfo.height = ctx->swapchainExtent.height;
-      fbInfo.layers = 1;
-      if (vkCreateFramebuffer(ctx->device, &fbInfo, NULL, &ctx->framebuffers[i]) != VK_SUCCESS) {
-          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create framebuffer %u", i);
-          return 0;
-      }
-  }
-  ctx->framebufferCount = ctx->swapchainImageCount; // Set the count here
-
-  VkDescriptorSetAllocateInfo allocInfoDS = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
-  allocInfoDS.descriptorPool = ctx->descriptorPool;
-  allocInfoDS.descriptorSetCount = 1;
-  allocInfoDS.pSetLayouts = &ctx->descriptorSetLayout;
-  if (vkAllocateDescriptorSets(ctx->device, &allocInfoDS, &ctx->descriptorSet) != VK_SUCCESS) {
+  VSDL_DescriptorBinding fontBinding = {0};
+  fontBinding.binding = 0;
+  fontBinding.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  fontBinding.sampler = ctx->fontAtlas.sampler;
+  fontBinding.imageView = ctx->fontAtlas.textureView;
+  fontBinding.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  ctx->descriptorSet = vsdl_descriptor_get(ctx, ctx->descriptorSetLayout, &fontBinding, 1);
+  if (ctx->descriptorSet == VK_NULL_HANDLE) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate descriptor set");
       return 0;
   }
 
-  VkDescriptorImageInfo imageInfo = {0};
-  imageInfo.sampler = ctx->fontAtlas.sampler;
-  imageInfo.imageView = ctx->fontAtlas.textureView;
-  imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-  VkWriteDescriptorSet descriptorWrite = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-  descriptorWrite.dstSet = ctx->descriptorSet;
-  descriptorWrite.dstBinding = 0;
-  descriptorWrite.dstArrayElement = 0;
-  descriptorWrite.descriptorCount = 1;
-  descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-  descriptorWrite.pImageInfo = &imageInfo;
-
-  vkUpdateDescriptorSets(ctx->device, 1, &descriptorWrite, 0, NULL);
-
+  // Binary semaphores for the swapchain only; frame completion is tracked on the timeline
   VkSemaphoreCreateInfo semaphoreInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
-  VkFenceCreateInfo fenceInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-  fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
   if (vkCreateSemaphore(ctx->device, &semaphoreInfo, NULL, &ctx->imageAvailableSemaphore) != VK_SUCCESS ||
-      vkCreateSemaphore(ctx->device, &semaphoreInfo, NULL, &ctx->renderFinishedSemaphore) != VK_SUCCESS ||
-      vkCreateFence(ctx->device, &fenceInfo, NULL, &ctx->frameFence) != VK_SUCCESS) {
+      vkCreateSemaphore(ctx->device, &semaphoreInfo, NULL, &ctx->renderFinishedSemaphore) != VK_SUCCESS) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create synchronization objects");
       return 0;
   }
@@ -115,20 +72,12 @@ int vsdl_init_renderer(VSDL_Context* ctx) {
 
 
 // Helper function to recreate swapchain-related resources
-static int recreate_swapchain(VSDL_Context* ctx) {
-  // Wait for the device to be idle before recreating resources
-  vkDeviceWaitIdle(ctx->device);
-
-  // Destroy old framebuffers
-  if (ctx->framebuffers) {
-      for (uint32_t i = 0; i < ctx->framebufferCount; i++) {
-          if (ctx->framebuffers[i] != VK_NULL_HANDLE) {
-              vkDestroyFramebuffer(ctx->device, ctx->framebuffers[i], NULL);
-          }
-      }
-      free(ctx->framebuffers);
-      ctx->framebuffers = NULL;
-  }
+static int recreate_swapchain(VSDL_Context* ctx, int width, int height) {
+  // Everything submitted so far may still use the old swapchain's views
+  vsdl_sync_wait_all(ctx);
+
+  // Cached framebuffers reference the old image views
+  vsdl_graph_invalidate(ctx);
 
   // Destroy old swapchain image views
   if (ctx->swapchainImageViews) {
@@ -147,9 +96,7 @@ static int recreate_swapchain(VSDL_Context* ctx) {
       ctx->swapchainImages = NULL;
   }
 
-  // Get new window size
-  int width, height;
-  SDL_GetWindowSize(ctx->window, &width, &height);
+  // Window size comes from the main thread through the frame packet
   if (width <= 0 || height <= 0) {
       return 0; // Window minimized, skip recreation
   }
@@ -183,6 +130,7 @@ static int recreate_swapchain(VSDL_Context* ctx) {
   ctx->swapchainImages = (VkImage*)malloc(ctx->swapchainImageCount * sizeof(VkImage));
   vkGetSwapchainImagesKHR(ctx->device, ctx->swapchain, &ctx->swapchainImageCount, ctx->swapchainImages);
   ctx->swapchainImageViewCount = ctx->swapchainImageCount;
+  ctx->swapchainImageFormat = swapchainInfo.imageFormat;
   ctx->swapchainExtent = swapchainInfo.imageExtent;
 
   // Recreate swapchain image views
@@ -204,43 +152,149 @@ static int recreate_swapchain(VSDL_Context* ctx) {
   }
   SDL_Log("Swapchain image views recreated (count: %u)", ctx->swapchainImageViewCount);
 
-  // Recreate framebuffers
-  ctx->framebuffers = (VkFramebuffer*)malloc(ctx->swapchainImageCount * sizeof(VkFramebuffer));
-  for (uint32_t i = 0; i < ctx->swapchainImageCount; i++) {
-      VkImageView attachments[] = {ctx->swapchainImageViews[i]};
-      VkFramebufferCreateInfo fbInfo = {VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
-      fbInfo.renderPass = ctx->renderPass;
-      fbInfo.attachmentCount = 1;
-      fbInfo.pAttachments = attachments;
-      fbInfo.width = ctx->swapchainExtent.width;
-      fbInfo.height = ctx->swapchainExtent.height;
-      fbInfo.layers = 1;
-      if (vkCreateFramebuffer(ctx->device, &fbInfo, NULL, &ctx->framebuffers[i]) != VK_SUCCESS) {
-          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to recreate framebuffer %u", i);
-          return 0;
-      }
-  }
-  ctx->framebufferCount = ctx->swapchainImageCount;
-  SDL_Log("Framebuffers recreated (count: %u)", ctx->framebufferCount);
-
   return 1;
 }
 
 
+void vsdl_set_draw_callback(VSDL_Context* ctx, VSDL_DrawCallback callback, void* userdata) {
+  ctx->drawCallback = callback;
+  ctx->drawUserdata = userdata;
+}
+
 void vsdl_draw_frame(VSDL_Context* ctx) {
-  // Wait for the previous frame to finish
-  VkResult result = vkWaitForFences(ctx->device, 1, &ctx->frameFence, VK_TRUE, UINT64_MAX);
-  if (result != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to wait for frame fence: %d", result);
+  VSDL_FramePacket* packet = vsdl_frame_packet_acquire(ctx);
+  vsdl_idle_frame_begin(ctx);
+  // Frame-scope allocations on this thread go to the packet while it is built
+  vsdl_arena_bind_thread(&packet->arena);
+
+  vsdl_cimgui_new_frame();
+  if (ctx->drawCallback) ctx->drawCallback(ctx, ctx->drawUserdata);
+  vsdl_memory_draw_panel(ctx);
+
+  vsdl_cimgui_end_frame(packet);
+
+  vsdl_arena_bind_thread(NULL);
+  vsdl_frame_packet_submit(ctx, packet);
+}
+
+// Secondary command buffer contents; each runs on its own thread
+static void record_scene(VSDL_Context* ctx, VkCommandBuffer commandBuffer, void* data) {
+  (void)data;
+  // Draw triangle
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline_resolve(ctx, ctx->graphicsPipeline));
+  VkBuffer vertexBuffers[] = {ctx->vertexBuffer.buffer};
+  VkDeviceSize offsets[] = {0};
+  vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+  vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+
+  // Draw GPU-culled objects
+  vsdl_gpu_cull_draw(ctx, commandBuffer);
+}
+
+static void record_sprites(VSDL_Context* ctx, VkCommandBuffer commandBuffer, void* data) {
+  vsdl_sprite_record(ctx, commandBuffer, (const VSDL_FramePacket*)data);
+}
+
+static void record_debug(VSDL_Context* ctx, VkCommandBuffer commandBuffer, void* data) {
+  vsdl_debug_record(ctx, commandBuffer, (const VSDL_FramePacket*)data);
+}
+
+// Text stays one task: the shaping cache and text vertex buffer are not shared between threads
+static void record_text(VSDL_Context* ctx, VkCommandBuffer commandBuffer, void* data) {
+  const VSDL_FramePacket* packet = (const VSDL_FramePacket*)data;
+  for (uint32_t i = 0; i < packet->textCount; i++) {
+      const VSDL_TextItem* item = &packet->textItems[i];
+      vsdl_render_text(ctx, commandBuffer, item);
+  }
+  vsdl_text_objects_record(ctx, commandBuffer, packet);
+  vsdl_text_views_record(ctx, commandBuffer, packet);
+}
+
+static void record_ui(VSDL_Context* ctx, VkCommandBuffer commandBuffer, void* data) {
+  vsdl_cimgui_render(ctx, (const VSDL_FramePacket*)data, commandBuffer);
+}
+
+static void record_upscale(VSDL_Context* ctx, VkCommandBuffer commandBuffer, void* data) {
+  (void)data;
+  vsdl_scale_record(ctx, commandBuffer);
+}
+
+// Tasks are recorded in parallel and executed in order into the pass's attachment
+static void execute_secondaries(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_GraphPass* pass,
+                                VkExtent2D extent, const VSDL_RecordTask* tasks, uint32_t count) {
+  VkCommandBufferInheritanceInfo inheritance = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+  inheritance.renderPass = pass->renderPass;
+  inheritance.subpass = 0;
+  inheritance.framebuffer = pass->framebuffer;
+  // Dynamic rendering: secondaries declare the attachment formats instead of a render pass
+  VkCommandBufferInheritanceRenderingInfo renderingInheritance = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO};
+  if (ctx->features.dynamicRendering) {
+      renderingInheritance.colorAttachmentCount = 1;
+      renderingInheritance.pColorAttachmentFormats = &pass->format;
+      renderingInheritance.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+      inheritance.pNext = &renderingInheritance;
+  }
+  vsdl_record_execute(ctx, commandBuffer, &inheritance, extent, tasks, count);
+}
+
+// Dynamic resolution: scene and sprites only cover this frame's share of the scene target
+static void execute_scene_pass(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_GraphPass* pass, void* data) {
+  VSDL_RecordTask tasks[] = {
+      {record_scene, NULL},
+      {record_sprites, data},
+  };
+  execute_secondaries(ctx, commandBuffer, pass, vsdl_scale_render_extent(ctx), tasks, SDL_arraysize(tasks));
+}
+
+// Debug shapes, text and UI always land at native resolution, on top of the scene or its upscaled copy
+static void execute_main_pass(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_GraphPass* pass, void* data) {
+  if (vsdl_scale_enabled(ctx)) {
+      VSDL_RecordTask tasks[] = {
+          {record_upscale, NULL},
+          {record_debug, data},
+          {record_text, data},
+          {record_ui, data},
+      };
+      execute_secondaries(ctx, commandBuffer, pass, pass->extent, tasks, SDL_arraysize(tasks));
       return;
   }
-  vkResetFences(ctx->device, 1, &ctx->frameFence);
+  VSDL_RecordTask tasks[] = {
+      {record_scene, NULL},
+      {record_sprites, data},
+      {record_debug, data},
+      {record_text, data},
+      {record_ui, data},
+  };
+  execute_secondaries(ctx, commandBuffer, pass, pass->extent, tasks, SDL_arraysize(tasks));
+}
+
+void vsdl_render_frame(VSDL_Context* ctx, VSDL_FramePacket* packet) {
+  // Wait for the previous frame to finish; a frame that bailed out before submitting left nothing to wait for
+  if (!vsdl_sync_wait(ctx, ctx->frameValue)) return;
+  vsdl_sync_collect(ctx);
+  vsdl_record_begin_frame(ctx);
+  vsdl_descriptor_begin_frame(ctx);
+
+  // Relocated buffers are swapped in before any module records writes to them this frame
+  vsdl_memory_update(ctx);
+
+  // Transient CPU and text vertex memory from last frame is free again
+  vsdl_frame_begin(ctx);
+  vsdl_text_begin_frame(ctx);
+  vsdl_text_objects_update(ctx);
+  vsdl_text_views_update(ctx);
+  vsdl_scale_begin_frame(ctx);
+
+  // Stream texture data; the upload batch is submitted ahead of this frame's commands
+  vsdl_texture_update(ctx);
+  vsdl_gpu_cull_update(ctx);
+  vsdl_upload_flush(ctx, 0);
 
   // Acquire the next swapchain image
   uint32_t imageIndex;
-  result = vkAcquireNextImageKHR(ctx->device, ctx->swapchain, UINT64_MAX, ctx->imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+  VkResult result = vkAcquireNextImageKHR(ctx->device, ctx->swapchain, UINT64_MAX, ctx->imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
   if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-      if (!recreate_swapchain(ctx)) return;
+      if (!recreate_swapchain(ctx, packet->windowWidth, packet->windowHeight)) return;
       result = vkAcquireNextImageKHR(ctx->device, ctx->swapchain, UINT64_MAX, ctx->imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
       if (result != VK_SUCCESS) {
           SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to acquire next image after recreation: %d", result);
@@ -266,40 +320,38 @@ void vsdl_draw_frame(VSDL_Context* ctx) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to begin command buffer: %d", result);
       return;
   }
+  vsdl_scale_begin_commands(ctx, ctx->commandBuffer);
+
+  // Passes declare their resources; the graph orders them and places the barriers
+  vsdl_graph_begin(ctx);
+  uint32_t backbuffer = vsdl_graph_import_image(ctx, "backbuffer", ctx->swapchainImages[imageIndex],
+                                                ctx->swapchainImageViews[imageIndex], ctx->swapchainImageFormat,
+                                                ctx->swapchainExtent, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                                VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+  vsdl_gpu_cull_add_pass(ctx);
+  const float clearColor[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+  uint32_t mainPass;
+  if (vsdl_scale_enabled(ctx)) {
+      // Same format as the swapchain, so scene pipelines work in either pass
+      ctx->scale.sceneImage = vsdl_graph_create_image(ctx, "scene", ctx->swapchainImageFormat,
+                                                      vsdl_scale_target_extent(ctx));
+      uint32_t scenePass = vsdl_graph_add_pass(ctx, "scene", VSDL_GRAPH_PASS_GRAPHICS_SECONDARY, execute_scene_pass, packet);
+      vsdl_graph_use(ctx, scenePass, ctx->scale.sceneImage, VSDL_GRAPH_COLOR_ATTACHMENT);
+      vsdl_gpu_cull_read_draws(ctx, scenePass);
+      vsdl_graph_clear(ctx, scenePass, clearColor);
+      mainPass = vsdl_graph_add_pass(ctx, "main", VSDL_GRAPH_PASS_GRAPHICS_SECONDARY, execute_main_pass, packet);
+      vsdl_graph_use(ctx, mainPass, ctx->scale.sceneImage, VSDL_GRAPH_SAMPLED);
+      vsdl_graph_use(ctx, mainPass, backbuffer, VSDL_GRAPH_COLOR_ATTACHMENT);
+  } else {
+      mainPass = vsdl_graph_add_pass(ctx, "main", VSDL_GRAPH_PASS_GRAPHICS_SECONDARY, execute_main_pass, packet);
+      vsdl_graph_use(ctx, mainPass, backbuffer, VSDL_GRAPH_COLOR_ATTACHMENT);
+      vsdl_gpu_cull_read_draws(ctx, mainPass);
+  }
+  vsdl_graph_clear(ctx, mainPass, clearColor);
+  vsdl_graph_execute(ctx, ctx->commandBuffer);
+  vsdl_scale_end_commands(ctx, ctx->commandBuffer);
 
-  // Begin render pass
-  VkRenderPassBeginInfo renderPassInfo = {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
-  renderPassInfo.renderPass = ctx->renderPass;
-  renderPassInfo.framebuffer = ctx->framebuffers[imageIndex];
-  renderPassInfo.renderArea.offset = (VkOffset2D){0, 0};
-  renderPassInfo.renderArea.extent = ctx->swapchainExtent;
-  VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
-  renderPassInfo.clearValueCount = 1;
-  renderPassInfo.pClearValues = &clearColor;
-
-  vkCmdBeginRenderPass(ctx->commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-  // Draw triangle
-  vkCmdBindPipeline(ctx->commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx->graphicsPipeline);
-  VkBuffer vertexBuffers[] = {ctx->vertexBuffer};
-  VkDeviceSize offsets[] = {0};
-  vkCmdBindVertexBuffers(ctx->commandBuffer, 0, 1, vertexBuffers, offsets);
-  vkCmdDraw(ctx->commandBuffer, 3, 1, 0, 0);
-
-  // Draw text
-  vsdl_render_text(ctx, ctx->commandBuffer, "Hello", -0.5f, -0.5f);
-
-  // ImGui frame via module
-  vsdl_cimgui_new_frame();
-
-  igBegin("Test Window", NULL, 0);
-  igText("Hello, ImGui!");
-  igEnd();
-
-  vsdl_cimgui_render(ctx, ctx->commandBuffer);
-
-  // End render pass and command buffer
-  vkCmdEndRenderPass(ctx->commandBuffer);
   result = vkEndCommandBuffer(ctx->commandBuffer);
   if (result != VK_SUCCESS) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to end command buffer: %d", result);
@@ -319,11 +371,9 @@ void vsdl_draw_frame(VSDL_Context* ctx) {
   submitInfo.signalSemaphoreCount = 1;
   submitInfo.pSignalSemaphores = signalSemaphores;
 
-  result = vkQueueSubmit(ctx->graphicsQueue, 1, &submitInfo, ctx->frameFence);
-  if (result != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to submit queue: %d", result);
-      return;
-  }
+  if (!vsdl_sync_submit(ctx, &submitInfo, &ctx->frameValue)) return;
+  vsdl_debug_end_frame(ctx, packet);
+  vsdl_memory_snapshot(ctx);
 
   // Present the frame
   VkPresentInfoKHR presentInfo = {VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
@@ -335,7 +385,7 @@ void vsdl_draw_frame(VSDL_Context* ctx) {
 
   result = vkQueuePresentKHR(ctx->graphicsQueue, &presentInfo);
   if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
-      recreate_swapchain(ctx);
+      recreate_swapchain(ctx, packet->windowWidth, packet->windowHeight);
   } else if (result != VK_SUCCESS) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to present queue: %d", result);
   }
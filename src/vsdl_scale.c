@@ -0,0 +1,247 @@
+// #define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+// #include <volk.h>
+#include <vk_mem_alloc.h>
+#include <SDL3/SDL.h>
+#include "vsdl_scale.h"
+#include "vsdl_types.h"
+#include "vsdl_graph.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_descriptor.h"
+
+typedef struct {
+  float uvScale[2];     // Rendered part of the scene target, in its UV space
+  float texelSize[2];
+  float sharpness;
+} UpscalePushConstants;
+
+static float hint_float(const char* name, float fallback) {
+  const char* value = SDL_GetHint(name);
+  return value && *value ? (float)SDL_atof(value) : fallback;
+}
+
+static void read_settings(VSDL_Context* ctx) {
+  VSDL_Scale* scale = &ctx->scale;
+  scale->minScale = SDL_clamp(hint_float("VSDL_RENDER_SCALE_MIN", 0.5f), 0.25f, 1.0f);
+  scale->maxScale = SDL_clamp(hint_float("VSDL_RENDER_SCALE_MAX", 1.0f), scale->minScale, 1.0f);
+  scale->sharpness = SDL_clamp(hint_float("VSDL_UPSCALE_SHARPNESS", 0.25f), 0.0f, 1.0f);
+  scale->budgetMS = hint_float("VSDL_GPU_BUDGET_MS", 0.0f);
+  if (scale->budgetMS <= 0.0f) {
+      // One refresh interval, so the scene gives way before vsync starts dropping frames
+      const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(ctx->window));
+      scale->budgetMS = mode && mode->refresh_rate > 0.0f ? 1000.0f / mode->refresh_rate : 1000.0f / 60.0f;
+  }
+  scale->scale = scale->maxScale;
+}
+
+// Without timestamps the scale just stays at maxScale
+static void create_query_pool(VSDL_Context* ctx) {
+  VSDL_Scale* scale = &ctx->scale;
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(ctx->physicalDevice, &properties);
+  uint32_t familyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(ctx->physicalDevice, &familyCount, NULL);
+  VkQueueFamilyProperties* families = (VkQueueFamilyProperties*)SDL_calloc(familyCount, sizeof(VkQueueFamilyProperties));
+  if (!families) return;
+  vkGetPhysicalDeviceQueueFamilyProperties(ctx->physicalDevice, &familyCount, families);
+  uint32_t validBits = ctx->graphicsFamily < familyCount ? families[ctx->graphicsFamily].timestampValidBits : 0;
+  SDL_free(families);
+  if (validBits == 0 || properties.limits.timestampPeriod <= 0.0f) {
+      SDL_Log("GPU timestamps unsupported, render scale fixed at %.2f", scale->scale);
+      return;
+  }
+
+  VkQueryPoolCreateInfo poolInfo = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+  poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  poolInfo.queryCount = 2;
+  if (vkCreateQueryPool(ctx->device, &poolInfo, NULL, &scale->queryPool) != VK_SUCCESS) {
+      SDL_Log("Failed to create timestamp query pool, render scale fixed at %.2f", scale->scale);
+      scale->queryPool = VK_NULL_HANDLE;
+      return;
+  }
+  scale->timestampPeriod = properties.limits.timestampPeriod;
+  scale->timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+}
+
+static int create_pipeline(VSDL_Context* ctx) {
+  VSDL_Scale* scale = &ctx->scale;
+  VkDescriptorSetLayoutBinding binding = {0};
+  binding.binding = 0;
+  binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  binding.descriptorCount = 1;
+  binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+  VkDescriptorSetLayoutCreateInfo layoutInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+  layoutInfo.bindingCount = 1;
+  layoutInfo.pBindings = &binding;
+  if (vkCreateDescriptorSetLayout(ctx->device, &layoutInfo, NULL, &scale->descriptorSetLayout) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create upscale descriptor set layout");
+      return 0;
+  }
+
+  VkPushConstantRange pushRange = {VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(UpscalePushConstants)};
+  scale->pipelineLayout = vsdl_pipeline_layout(ctx, &scale->descriptorSetLayout, 1, &pushRange);
+  if (scale->pipelineLayout == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create upscale pipeline layout");
+      return 0;
+  }
+
+  // Fullscreen triangle from gl_VertexIndex, no vertex input
+  VSDL_PipelineKey key = {0};
+  key.vertexShader = vsdl_pipeline_shader(ctx, "shaders/upscale.vert.spv");
+  key.fragmentShader = vsdl_pipeline_shader(ctx, "shaders/upscale.frag.spv");
+  if (key.vertexShader == VK_NULL_HANDLE || key.fragmentShader == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load upscale shaders");
+      return 0;
+  }
+  key.layout = scale->pipelineLayout;
+  key.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+  key.cullMode = VK_CULL_MODE_NONE;
+  key.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+  key.blend = VSDL_BLEND_NONE;
+  scale->pipeline = vsdl_pipeline_get(ctx, &key);
+  if (scale->pipeline == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create upscale pipeline");
+      return 0;
+  }
+  return 1;
+}
+
+int vsdl_scale_init(VSDL_Context* ctx) {
+  VSDL_Scale* scale = &ctx->scale;
+  SDL_memset(scale, 0, sizeof(*scale));
+  scale->sceneImage = VSDL_GRAPH_NONE;
+  read_settings(ctx);
+  if (scale->minScale >= 1.0f) {
+      SDL_Log("Dynamic resolution off (render scale fixed at 1)");
+      return 1;
+  }
+
+  VkSamplerCreateInfo samplerInfo = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+  samplerInfo.magFilter = VK_FILTER_LINEAR;
+  samplerInfo.minFilter = VK_FILTER_LINEAR;
+  samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  if (vkCreateSampler(ctx->device, &samplerInfo, NULL, &scale->sampler) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create upscale sampler");
+      vsdl_scale_shutdown(ctx);
+      return 0;
+  }
+  if (!create_pipeline(ctx)) {
+      vsdl_scale_shutdown(ctx);
+      return 0;
+  }
+  create_query_pool(ctx);
+  SDL_Log("Dynamic resolution on: scale %.2f-%.2f, GPU budget %.2f ms, sharpness %.2f",
+          scale->minScale, scale->maxScale, scale->budgetMS, scale->sharpness);
+  return 1;
+}
+
+int vsdl_scale_enabled(VSDL_Context* ctx) {
+  return ctx->scale.pipeline != VK_NULL_HANDLE;
+}
+
+static void adjust(VSDL_Scale* scale, float gpuMS) {
+  scale->gpuMS = scale->gpuMS > 0.0f ? scale->gpuMS * 0.8f + gpuMS * 0.2f : gpuMS;
+  float next = scale->scale;
+  if (scale->gpuMS > scale->budgetMS) {
+      // Cost follows the pixel count, the square of the per-axis scale; aim a little under budget
+      next *= SDL_sqrtf(0.9f * scale->budgetMS / scale->gpuMS);
+  } else if (scale->gpuMS < 0.75f * scale->budgetMS) {
+      next += VSDL_SCALE_STEP;
+  }
+  next = SDL_clamp(next, scale->minScale, scale->maxScale);
+  // Carry the smoothed time over to the new size so one slow frame does not trigger several drops
+  scale->gpuMS *= (next * next) / (scale->scale * scale->scale);
+  scale->scale = next;
+}
+
+void vsdl_scale_begin_frame(VSDL_Context* ctx) {
+  VSDL_Scale* scale = &ctx->scale;
+  scale->sceneImage = VSDL_GRAPH_NONE;
+  if (scale->queryPool == VK_NULL_HANDLE || !scale->queriesWritten) return;
+  scale->queriesWritten = 0;
+  // The frame wait already covered last frame, so this never blocks
+  uint64_t stamps[2];
+  if (vkGetQueryPoolResults(ctx->device, scale->queryPool, 0, 2, sizeof(stamps), stamps, sizeof(uint64_t),
+                            VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+      return;
+  }
+  uint64_t ticks = (stamps[1] - stamps[0]) & scale->timestampMask;
+  adjust(scale, (float)((double)ticks * scale->timestampPeriod / 1000000.0));
+}
+
+void vsdl_scale_begin_commands(VSDL_Context* ctx, VkCommandBuffer commandBuffer) {
+  VSDL_Scale* scale = &ctx->scale;
+  if (scale->queryPool == VK_NULL_HANDLE) return;
+  vkCmdResetQueryPool(commandBuffer, scale->queryPool, 0, 2);
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, scale->queryPool, 0);
+}
+
+void vsdl_scale_end_commands(VSDL_Context* ctx, VkCommandBuffer commandBuffer) {
+  VSDL_Scale* scale = &ctx->scale;
+  if (scale->queryPool == VK_NULL_HANDLE) return;
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, scale->queryPool, 1);
+  scale->queriesWritten = 1;
+}
+
+static uint32_t scaled(uint32_t size, float factor) {
+  uint32_t result = (uint32_t)((float)size * factor + 0.5f);
+  return result > 0 ? result : 1;
+}
+
+VkExtent2D vsdl_scale_target_extent(VSDL_Context* ctx) {
+  VkExtent2D extent = {scaled(ctx->swapchainExtent.width, ctx->scale.maxScale),
+                       scaled(ctx->swapchainExtent.height, ctx->scale.maxScale)};
+  return extent;
+}
+
+VkExtent2D vsdl_scale_render_extent(VSDL_Context* ctx) {
+  VkExtent2D target = vsdl_scale_target_extent(ctx);
+  VkExtent2D extent = {scaled(ctx->swapchainExtent.width, ctx->scale.scale),
+                       scaled(ctx->swapchainExtent.height, ctx->scale.scale)};
+  extent.width = SDL_min(extent.width, target.width);
+  extent.height = SDL_min(extent.height, target.height);
+  return extent;
+}
+
+void vsdl_scale_record(VSDL_Context* ctx, VkCommandBuffer commandBuffer) {
+  VSDL_Scale* scale = &ctx->scale;
+  VSDL_DescriptorBinding binding = {0};
+  binding.binding = 0;
+  binding.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  binding.sampler = scale->sampler;
+  binding.imageView = vsdl_graph_image_view(ctx, scale->sceneImage);
+  binding.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  if (binding.imageView == VK_NULL_HANDLE) return;
+  // The scene image is recreated with the swapchain, so its set is not worth caching
+  VkDescriptorSet set = vsdl_descriptor_alloc_frame(ctx, scale->descriptorSetLayout, &binding, 1);
+  if (set == VK_NULL_HANDLE) return;
+
+  VkExtent2D target = vsdl_scale_target_extent(ctx);
+  VkExtent2D rendered = vsdl_scale_render_extent(ctx);
+  UpscalePushConstants push;
+  push.uvScale[0] = (float)rendered.width / (float)target.width;
+  push.uvScale[1] = (float)rendered.height / (float)target.height;
+  push.texelSize[0] = 1.0f / (float)target.width;
+  push.texelSize[1] = 1.0f / (float)target.height;
+  push.sharpness = scale->sharpness;
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline_resolve(ctx, scale->pipeline));
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, scale->pipelineLayout, 0, 1, &set, 0, NULL);
+  vkCmdPushConstants(commandBuffer, scale->pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(push), &push);
+  vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+}
+
+void vsdl_scale_shutdown(VSDL_Context* ctx) {
+  VSDL_Scale* scale = &ctx->scale;
+  if (ctx->device == VK_NULL_HANDLE) return;
+  if (scale->queryPool != VK_NULL_HANDLE) vkDestroyQueryPool(ctx->device, scale->queryPool, NULL);
+  if (scale->sampler != VK_NULL_HANDLE) vkDestroySampler(ctx->device, scale->sampler, NULL);
+  if (scale->descriptorSetLayout != VK_NULL_HANDLE) {
+      vkDestroyDescriptorSetLayout(ctx->device, scale->descriptorSetLayout, NULL);
+  }
+  // Pipeline and layout belong to the pipeline registry
+  SDL_memset(scale, 0, sizeof(*scale));
+}
@@ -0,0 +1,221 @@
+#include <SDL3/SDL.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_ADVANCES_H
+#ifdef VSDL_USE_HARFBUZZ
+#include <hb.h>
+#include <hb-ft.h>
+#endif
+#include "vsdl_shape.h"
+#include "vsdl_types.h"
+
+static uint64_t run_hash(const void* face, const char* text, size_t length) {
+  uint64_t hash = 14695981039346656037ULL ^ (uint64_t)(uintptr_t)face;
+  for (size_t i = 0; i < length; i++) {
+      hash ^= (unsigned char)text[i];
+      hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// One allocation per run: header, key copy, atlas indices, then pen offsets
+static VSDL_ShapedRun* alloc_run(const char* text, size_t length, uint32_t glyphCount) {
+  size_t penOffset = sizeof(VSDL_ShapedRun) + length + 1 + glyphCount;
+  penOffset = (penOffset + sizeof(float) - 1) & ~(sizeof(float) - 1);
+  size_t bytes = penOffset + (size_t)glyphCount * sizeof(float);
+  unsigned char* memory = (unsigned char*)SDL_malloc(bytes);
+  if (!memory) return NULL;
+
+  VSDL_ShapedRun* run = (VSDL_ShapedRun*)memory;
+  SDL_memset(run, 0, sizeof(*run));
+  run->bytes = bytes;
+  run->textLength = length;
+  run->text = (char*)(memory + sizeof(VSDL_ShapedRun));
+  SDL_memcpy(run->text, text, length);
+  run->text[length] = '\0';
+  run->glyphCount = glyphCount;
+  run->glyphs = (unsigned char*)run->text + length + 1;
+  run->penX = (float*)(memory + penOffset);
+  return run;
+}
+
+static unsigned char atlas_index(unsigned char c) {
+  return c < 128 ? c : 0;
+}
+
+#ifdef VSDL_USE_HARFBUZZ
+static VSDL_ShapedRun* shape_run(FT_Face face, const char* text, size_t length) {
+  hb_font_t* font = hb_ft_font_create_referenced(face);
+  hb_buffer_t* buffer = hb_buffer_create();
+  hb_buffer_add_utf8(buffer, text, (int)length, 0, (int)length);
+  hb_buffer_guess_segment_properties(buffer);
+  hb_shape(font, buffer, NULL, 0);
+
+  unsigned int count = 0;
+  const hb_glyph_info_t* info = hb_buffer_get_glyph_infos(buffer, &count);
+  const hb_glyph_position_t* positions = hb_buffer_get_glyph_positions(buffer, NULL);
+  VSDL_ShapedRun* run = alloc_run(text, length, count);
+  if (run) {
+      // The atlas is keyed by character, so glyphs map back through their cluster;
+      // a ligature draws as the first character it covers
+      float pen = 0.0f;
+      for (unsigned int i = 0; i < count; i++) {
+          run->glyphs[i] = atlas_index((unsigned char)text[info[i].cluster]);
+          run->penX[i] = pen + positions[i].x_offset / 64.0f;
+          pen += positions[i].x_advance / 64.0f;
+      }
+      run->width = pen;
+  }
+  hb_buffer_destroy(buffer);
+  hb_font_destroy(font);
+  return run;
+}
+#else
+static VSDL_ShapedRun* shape_run(FT_Face face, const char* text, size_t length) {
+  VSDL_ShapedRun* run = alloc_run(text, length, (uint32_t)length);
+  if (!run) return NULL;
+
+  FT_Bool kerning = FT_HAS_KERNING(face);
+  FT_UInt previous = 0;
+  float pen = 0.0f;
+  for (size_t i = 0; i < length; i++) {
+      unsigned char c = (unsigned char)text[i];
+      FT_UInt index = (c >= 32 && c < 128) ? FT_Get_Char_Index(face, c) : 0;
+      if (kerning && previous && index) {
+          FT_Vector delta;
+          if (!FT_Get_Kerning(face, previous, index, FT_KERNING_DEFAULT, &delta)) {
+              pen += (float)(delta.x >> 6);
+          }
+      }
+      run->glyphs[i] = atlas_index(c);
+      run->penX[i] = pen;
+
+      FT_Fixed advance = 0;
+      if (index && !FT_Get_Advance(face, index, FT_LOAD_DEFAULT, &advance)) {
+          pen += (float)(advance >> 16);
+      }
+      previous = index;
+  }
+  run->width = pen;
+  return run;
+}
+#endif
+
+static void lru_unlink(VSDL_ShapeCache* cache, VSDL_ShapedRun* run) {
+  if (run->lruPrev) run->lruPrev->lruNext = run->lruNext;
+  else cache->lruHead = run->lruNext;
+  if (run->lruNext) run->lruNext->lruPrev = run->lruPrev;
+  else cache->lruTail = run->lruPrev;
+  run->lruPrev = run->lruNext = NULL;
+}
+
+static void lru_push_front(VSDL_ShapeCache* cache, VSDL_ShapedRun* run) {
+  run->lruPrev = NULL;
+  run->lruNext = cache->lruHead;
+  if (cache->lruHead) cache->lruHead->lruPrev = run;
+  cache->lruHead = run;
+  if (!cache->lruTail) cache->lruTail = run;
+}
+
+static void remove_run(VSDL_ShapeCache* cache, VSDL_ShapedRun* run) {
+  VSDL_ShapedRun** link = &cache->buckets[run->hash & (cache->bucketCount - 1)];
+  while (*link != run) link = &(*link)->hashNext;
+  *link = run->hashNext;
+  lru_unlink(cache, run);
+  cache->bytes -= run->bytes;
+  cache->runCount--;
+  SDL_free(run);
+}
+
+// Always keeps the most recent run, even when it alone is over budget
+static void evict_to_budget(VSDL_ShapeCache* cache) {
+  while (cache->bytes > cache->budget && cache->lruTail && cache->lruTail != cache->lruHead) {
+      remove_run(cache, cache->lruTail);
+      cache->evictions++;
+  }
+}
+
+static void grow_buckets(VSDL_ShapeCache* cache) {
+  uint32_t bucketCount = cache->bucketCount * 2;
+  VSDL_ShapedRun** buckets = (VSDL_ShapedRun**)SDL_calloc(bucketCount, sizeof(VSDL_ShapedRun*));
+  if (!buckets) return;  // Longer chains, still correct
+  for (uint32_t i = 0; i < cache->bucketCount; i++) {
+      VSDL_ShapedRun* run = cache->buckets[i];
+      while (run) {
+          VSDL_ShapedRun* next = run->hashNext;
+          VSDL_ShapedRun** bucket = &buckets[run->hash & (bucketCount - 1)];
+          run->hashNext = *bucket;
+          *bucket = run;
+          run = next;
+      }
+  }
+  SDL_free(cache->buckets);
+  cache->buckets = buckets;
+  cache->bucketCount = bucketCount;
+}
+
+int vsdl_shape_init(VSDL_Context* ctx, size_t budgetBytes) {
+  VSDL_ShapeCache* cache = &ctx->shapeCache;
+  SDL_memset(cache, 0, sizeof(*cache));
+  cache->bucketCount = 256;
+  cache->buckets = (VSDL_ShapedRun**)SDL_calloc(cache->bucketCount, sizeof(VSDL_ShapedRun*));
+  if (!cache->buckets) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate shape cache");
+      return 0;
+  }
+  cache->budget = budgetBytes;
+#ifdef VSDL_USE_HARFBUZZ
+  SDL_Log("Text shaping: HarfBuzz %s, cache budget %zu KB", hb_version_string(), budgetBytes / 1024);
+#else
+  SDL_Log("Text shaping: FreeType kerning, cache budget %zu KB", budgetBytes / 1024);
+#endif
+  return 1;
+}
+
+void vsdl_shape_set_budget(VSDL_Context* ctx, size_t budgetBytes) {
+  ctx->shapeCache.budget = budgetBytes;
+  evict_to_budget(&ctx->shapeCache);
+}
+
+const VSDL_ShapedRun* vsdl_shape_text(VSDL_Context* ctx, FT_Face face, const char* text, size_t length) {
+  VSDL_ShapeCache* cache = &ctx->shapeCache;
+  if (!cache->buckets || !face) return NULL;
+
+  uint64_t hash = run_hash(face, text, length);
+  VSDL_ShapedRun** bucket = &cache->buckets[hash & (cache->bucketCount - 1)];
+  for (VSDL_ShapedRun* run = *bucket; run; run = run->hashNext) {
+      if (run->hash == hash && run->face == face && run->textLength == length &&
+          SDL_memcmp(run->text, text, length) == 0) {
+          lru_unlink(cache, run);
+          lru_push_front(cache, run);
+          cache->hits++;
+          return run;
+      }
+  }
+
+  VSDL_ShapedRun* run = shape_run(face, text, length);
+  if (!run) return NULL;
+  cache->misses++;
+  run->hash = hash;
+  run->face = face;
+  run->hashNext = *bucket;
+  *bucket = run;
+  lru_push_front(cache, run);
+  cache->bytes += run->bytes;
+  cache->runCount++;
+
+  evict_to_budget(cache);
+  if (cache->runCount > cache->bucketCount) grow_buckets(cache);
+  return run;
+}
+
+void vsdl_shape_clear(VSDL_Context* ctx) {
+  VSDL_ShapeCache* cache = &ctx->shapeCache;
+  while (cache->lruHead) remove_run(cache, cache->lruHead);
+}
+
+void vsdl_shape_shutdown(VSDL_Context* ctx) {
+  if (ctx->shapeCache.buckets) vsdl_shape_clear(ctx);
+  SDL_free(ctx->shapeCache.buckets);
+  SDL_memset(&ctx->shapeCache, 0, sizeof(ctx->shapeCache));
+}
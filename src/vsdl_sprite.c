@@ -0,0 +1,300 @@
+// #define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+// #include <volk.h>
+#include <vk_mem_alloc.h>
+#include <SDL3/SDL.h>
+#include <string.h>
+#include "vsdl_sprite.h"
+#include "vsdl_types.h"
+#include "vsdl_arena.h"
+#include "vsdl_memory.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_descriptor.h"
+#include "vsdl_sync.h"
+
+// Sort key: layer in bits 8..23, texture in bits 0..7 (zero with bindless, where any texture batches)
+SDL_COMPILE_TIME_ASSERT(sprite_texture_bits, VSDL_MAX_TEXTURES <= 256);
+#define SPRITE_KEY_PASSES 3
+
+typedef struct {
+  float pixelToNdc[2];
+} SpritePushConstants;
+
+static int create_layouts(VSDL_Context* ctx) {
+  VSDL_SpriteBatcher* batcher = &ctx->sprites;
+  batcher->bindless = ctx->bindless.set != VK_NULL_HANDLE;
+
+  VkPushConstantRange pushRange = {VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(SpritePushConstants)};
+  if (batcher->bindless) {
+      batcher->pipelineLayout = vsdl_pipeline_layout(ctx, &ctx->bindless.descriptorSetLayout, 1, &pushRange);
+      if (batcher->pipelineLayout == VK_NULL_HANDLE) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create sprite pipeline layout");
+          return 0;
+      }
+      return 1;
+  }
+
+  VkDescriptorSetLayoutBinding binding = {0};
+  binding.binding = 0;
+  binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  binding.descriptorCount = 1;
+  binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+  VkDescriptorSetLayoutCreateInfo layoutInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+  layoutInfo.bindingCount = 1;
+  layoutInfo.pBindings = &binding;
+  if (vkCreateDescriptorSetLayout(ctx->device, &layoutInfo, NULL, &batcher->descriptorSetLayout) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create sprite descriptor set layout");
+      return 0;
+  }
+
+  batcher->pipelineLayout = vsdl_pipeline_layout(ctx, &batcher->descriptorSetLayout, 1, &pushRange);
+  if (batcher->pipelineLayout == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create sprite pipeline layout");
+      return 0;
+  }
+  return 1;
+}
+
+static int create_pipeline(VSDL_Context* ctx) {
+  VSDL_PipelineKey key = {0};
+  key.vertexShader = vsdl_pipeline_shader(ctx, "shaders/sprite.vert.spv");
+  key.fragmentShader = vsdl_pipeline_shader(ctx, ctx->sprites.bindless ? "shaders/sprite_bindless.frag.spv"
+                                                                        : "shaders/sprite.frag.spv");
+  if (key.vertexShader == VK_NULL_HANDLE || key.fragmentShader == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load sprite shaders");
+      return 0;
+  }
+  key.layout = ctx->sprites.pipelineLayout;
+
+  // One instance per sprite; the four corners come from gl_VertexIndex
+  key.vertexStride = sizeof(VSDL_SpriteInstance);
+  key.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+  key.attributeCount = 6;
+  key.attributes[0] = (VSDL_VertexAttribute){0, VK_FORMAT_R32G32_SFLOAT, offsetof(VSDL_SpriteInstance, position)};
+  key.attributes[1] = (VSDL_VertexAttribute){1, VK_FORMAT_R32G32_SFLOAT, offsetof(VSDL_SpriteInstance, size)};
+  key.attributes[2] = (VSDL_VertexAttribute){2, VK_FORMAT_R32_SFLOAT, offsetof(VSDL_SpriteInstance, rotation)};
+  key.attributes[3] = (VSDL_VertexAttribute){3, VK_FORMAT_R8G8B8A8_UNORM, offsetof(VSDL_SpriteInstance, color)};
+  key.attributes[4] = (VSDL_VertexAttribute){4, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(VSDL_SpriteInstance, uv)};
+  key.attributes[5] = (VSDL_VertexAttribute){5, VK_FORMAT_R32_UINT, offsetof(VSDL_SpriteInstance, texture)};
+  key.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+  key.cullMode = VK_CULL_MODE_NONE;
+  key.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+  key.blend = VSDL_BLEND_ALPHA;
+
+  ctx->sprites.pipeline = vsdl_pipeline_get(ctx, &key);
+  if (ctx->sprites.pipeline == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create sprite pipeline");
+      return 0;
+  }
+  return 1;
+}
+
+static void destroy_instance_buffer(VSDL_Context* ctx) {
+  VSDL_SpriteBatcher* batcher = &ctx->sprites;
+  if (batcher->instanceBuffer != VK_NULL_HANDLE) {
+      vsdl_memory_destroy_buffer(ctx, batcher->instanceBuffer, batcher->instanceAllocation);
+  }
+  batcher->instanceBuffer = VK_NULL_HANDLE;
+  batcher->instanceAllocation = NULL;
+  batcher->instances = NULL;
+  batcher->capacity = 0;
+}
+
+// Only called while recording; the old buffer is retired once the frames using it complete
+static int reserve_instances(VSDL_Context* ctx, uint32_t count) {
+  VSDL_SpriteBatcher* batcher = &ctx->sprites;
+  if (count <= batcher->capacity) return 1;
+  uint32_t capacity = batcher->capacity ? batcher->capacity : 1024;
+  while (capacity < count) capacity *= 2;
+  vsdl_sync_defer_buffer(ctx, batcher->instanceBuffer, batcher->instanceAllocation);
+  batcher->instanceBuffer = VK_NULL_HANDLE;
+  batcher->instanceAllocation = NULL;
+  batcher->instances = NULL;
+  batcher->capacity = 0;
+
+  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  bufferInfo.size = (VkDeviceSize)capacity * sizeof(VSDL_SpriteInstance);
+  bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  VmaAllocationCreateInfo allocInfo = {0};
+  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  VmaAllocationInfo info;
+  if (!vsdl_memory_create_buffer(ctx, VSDL_MEMORY_TAG_SPRITE, &bufferInfo, &allocInfo,
+                                 &batcher->instanceBuffer, &batcher->instanceAllocation, &info)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create sprite instance buffer (%u sprites)", capacity);
+      batcher->instanceBuffer = VK_NULL_HANDLE;
+      return 0;
+  }
+  batcher->instances = (VSDL_SpriteInstance*)info.pMappedData;
+  batcher->capacity = capacity;
+  return 1;
+}
+
+int vsdl_init_sprites(VSDL_Context* ctx) {
+  if (!create_layouts(ctx) || !create_pipeline(ctx) || !reserve_instances(ctx, 1024)) {
+      vsdl_sprite_shutdown(ctx);
+      return 0;
+  }
+  SDL_Log("Sprite batcher initialized (%s)", ctx->sprites.bindless ? "bindless" : "per-texture sets");
+  return 1;
+}
+
+void vsdl_draw_sprites(VSDL_Context* ctx, const VSDL_Sprite* sprites, uint32_t count) {
+  VSDL_FramePacket* packet = ctx->renderThread.building;
+  if (!packet || count == 0) return;
+  if (packet->spriteCount + count > packet->spriteCapacity) {
+      uint32_t capacity = packet->spriteCapacity ? packet->spriteCapacity * 2 : 256;
+      while (capacity < packet->spriteCount + count) capacity *= 2;
+      VSDL_Sprite* items = (VSDL_Sprite*)vsdl_arena_alloc(&packet->arena, capacity * sizeof(VSDL_Sprite),
+                                                          VSDL_ALIGNOF(VSDL_Sprite));
+      if (!items) return;
+      if (packet->spriteCount) memcpy(items, packet->sprites, packet->spriteCount * sizeof(VSDL_Sprite));
+      packet->sprites = items;
+      packet->spriteCapacity = capacity;
+  }
+  memcpy(packet->sprites + packet->spriteCount, sprites, count * sizeof(VSDL_Sprite));
+  packet->spriteCount += count;
+}
+
+void vsdl_draw_sprite(VSDL_Context* ctx, const VSDL_Sprite* sprite) {
+  vsdl_draw_sprites(ctx, sprite, 1);
+}
+
+// Stable LSD radix sort, 8 bits per pass, on (key << 32 | sprite index) pairs so passes stream
+// through memory. Passes where every key has the same digit are skipped, so a frame using one
+// texture on one layer costs a histogram only
+static const uint64_t* sort_sprites(uint64_t* pairs, uint64_t* scratch, uint32_t count) {
+  uint32_t histograms[SPRITE_KEY_PASSES][256];
+  memset(histograms, 0, sizeof(histograms));
+  for (uint32_t i = 0; i < count; i++) {
+      uint32_t key = (uint32_t)(pairs[i] >> 32);
+      histograms[0][key & 0xFF]++;
+      histograms[1][(key >> 8) & 0xFF]++;
+      histograms[2][(key >> 16) & 0xFF]++;
+  }
+
+  uint64_t* src = pairs;
+  uint64_t* dst = scratch;
+  for (uint32_t pass = 0; pass < SPRITE_KEY_PASSES; pass++) {
+      uint32_t shift = 32 + pass * 8;
+      uint32_t* histogram = histograms[pass];
+      if (histogram[(src[0] >> shift) & 0xFF] == count) continue;
+      uint32_t offset = 0;
+      for (uint32_t digit = 0; digit < 256; digit++) {
+          uint32_t n = histogram[digit];
+          histogram[digit] = offset;
+          offset += n;
+      }
+      for (uint32_t i = 0; i < count; i++) {
+          uint64_t pair = src[i];
+          dst[histogram[(pair >> shift) & 0xFF]++] = pair;
+      }
+      uint64_t* swap = src;
+      src = dst;
+      dst = swap;
+  }
+  return src;
+}
+
+// Cached per view, so a texture's set is written once per streamed view rather than per frame
+static VkDescriptorSet texture_set(VSDL_Context* ctx, uint32_t id) {
+  if (id >= ctx->textures.count) return VK_NULL_HANDLE;
+  const VSDL_Texture* texture = &ctx->textures.textures[id];
+  if (texture->view == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+
+  VSDL_DescriptorBinding binding = {0};
+  binding.binding = 0;
+  binding.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  binding.sampler = ctx->textures.sampler;
+  binding.imageView = texture->view;
+  binding.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  return vsdl_descriptor_get(ctx, ctx->sprites.descriptorSetLayout, &binding, 1);
+}
+
+void vsdl_sprite_record(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_FramePacket* packet) {
+  VSDL_SpriteBatcher* batcher = &ctx->sprites;
+  batcher->drawn = 0;
+  batcher->draws = 0;
+  uint32_t count = packet->spriteCount;
+  if (batcher->pipeline == VK_NULL_HANDLE || count == 0) return;
+
+  uint64_t* pairs = VSDL_FRAME_NEW(ctx, uint64_t, count);
+  uint64_t* scratch = VSDL_FRAME_NEW(ctx, uint64_t, count);
+  if (!pairs || !scratch || !reserve_instances(ctx, count)) return;
+  const uint32_t textureMask = batcher->bindless ? 0 : 0xFF;
+  for (uint32_t i = 0; i < count; i++) {
+      const VSDL_Sprite* sprite = &packet->sprites[i];
+      uint32_t key = ((uint32_t)sprite->layer << 8) | (sprite->texture & textureMask);
+      pairs[i] = ((uint64_t)key << 32) | i;
+  }
+  const uint64_t* sorted = sort_sprites(pairs, scratch, count);
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline_resolve(ctx, batcher->pipeline));
+  SpritePushConstants push = {{2.0f / (float)ctx->swapchainExtent.width, 2.0f / (float)ctx->swapchainExtent.height}};
+  vkCmdPushConstants(commandBuffer, batcher->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(push), &push);
+  VkDeviceSize offset = 0;
+  vkCmdBindVertexBuffers(commandBuffer, 0, 1, &batcher->instanceBuffer, &offset);
+  if (batcher->bindless) {
+      vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, batcher->pipelineLayout,
+                              0, 1, &ctx->bindless.set, 0, NULL);
+  }
+
+  // Sorted sprites go to the mapped buffer in order; without bindless a run ends where the
+  // texture changes, with it the whole frame is one run
+  VSDL_SpriteInstance* out = batcher->instances;
+  uint32_t written = 0;
+  uint32_t runStart = 0;
+  uint32_t runTexture = UINT32_MAX;
+  VkDescriptorSet runSet = VK_NULL_HANDLE;
+  for (uint32_t i = 0; i < count; i++) {
+      const VSDL_Sprite* sprite = &packet->sprites[(uint32_t)sorted[i]];
+      uint32_t slot = 0;
+      if (batcher->bindless) {
+          if (sprite->texture >= ctx->textures.count) continue;
+          slot = ctx->textures.textures[sprite->texture].bindlessSlot;
+          if (slot == VSDL_BINDLESS_NONE) continue;  // Not resident yet
+      } else if (sprite->texture != runTexture) {
+          if (written > runStart) {
+              vkCmdDraw(commandBuffer, 4, written - runStart, 0, runStart);
+              batcher->draws++;
+          }
+          runStart = written;
+          runTexture = sprite->texture;
+          runSet = texture_set(ctx, runTexture);
+          if (runSet != VK_NULL_HANDLE) {
+              vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, batcher->pipelineLayout,
+                                      0, 1, &runSet, 0, NULL);
+          }
+      }
+      if (!batcher->bindless && runSet == VK_NULL_HANDLE) continue;
+      VSDL_SpriteInstance* instance = &out[written++];
+      instance->position[0] = sprite->x;
+      instance->position[1] = sprite->y;
+      instance->size[0] = sprite->width;
+      instance->size[1] = sprite->height;
+      instance->rotation = sprite->rotation;
+      instance->color = sprite->color;
+      memcpy(instance->uv, sprite->uv, sizeof(instance->uv));
+      instance->texture = slot;
+  }
+  if (written > runStart) {
+      vkCmdDraw(commandBuffer, 4, written - runStart, 0, runStart);
+      batcher->draws++;
+  }
+  batcher->drawn = written;
+}
+
+void vsdl_sprite_shutdown(VSDL_Context* ctx) {
+  VSDL_SpriteBatcher* batcher = &ctx->sprites;
+  if (ctx->device == VK_NULL_HANDLE) return;
+  destroy_instance_buffer(ctx);
+  // Pipeline and layout belong to the pipeline registry
+  batcher->pipeline = VK_NULL_HANDLE;
+  batcher->pipelineLayout = VK_NULL_HANDLE;
+  if (batcher->descriptorSetLayout != VK_NULL_HANDLE) {
+      vkDestroyDescriptorSetLayout(ctx->device, batcher->descriptorSetLayout, NULL);
+      batcher->descriptorSetLayout = VK_NULL_HANDLE;
+  }
+}
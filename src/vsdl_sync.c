@@ -0,0 +1,259 @@
+// #define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+// #include <volk.h>
+#include <vk_mem_alloc.h>
+#include <SDL3/SDL.h>
+#include "vsdl_sync.h"
+#include "vsdl_types.h"
+#include "vsdl_memory.h"
+
+int vsdl_sync_init(VSDL_Context* ctx) {
+  VSDL_Sync* sync = &ctx->sync;
+  sync->lock = SDL_CreateMutex();
+  if (!sync->lock) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create sync mutex: %s", SDL_GetError());
+      return 0;
+  }
+
+  if (ctx->features.timelineSemaphore) {
+      const int core = ctx->apiVersion >= VK_API_VERSION_1_2;
+      sync->waitSemaphores = (PFN_vkWaitSemaphoresKHR)
+          vkGetDeviceProcAddr(ctx->device, core ? "vkWaitSemaphores" : "vkWaitSemaphoresKHR");
+      sync->getCounterValue = (PFN_vkGetSemaphoreCounterValueKHR)
+          vkGetDeviceProcAddr(ctx->device, core ? "vkGetSemaphoreCounterValue" : "vkGetSemaphoreCounterValueKHR");
+      VkSemaphoreTypeCreateInfo typeInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+      typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+      typeInfo.initialValue = 0;
+      VkSemaphoreCreateInfo semaphoreInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+      semaphoreInfo.pNext = &typeInfo;
+      if (sync->waitSemaphores && sync->getCounterValue &&
+          vkCreateSemaphore(ctx->device, &semaphoreInfo, NULL, &sync->semaphore) == VK_SUCCESS) {
+          SDL_Log("Timeline semaphore created");
+          return 1;
+      }
+      SDL_Log("Timeline semaphore unavailable, falling back to fences");
+      ctx->features.timelineSemaphore = VK_FALSE;
+  }
+
+  VkFenceCreateInfo fenceInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+  for (uint32_t i = 0; i < VSDL_SYNC_FALLBACK_FENCES; i++) {
+      if (vkCreateFence(ctx->device, &fenceInfo, NULL, &sync->fences[i]) != VK_SUCCESS) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create sync fence");
+          return 0;
+      }
+  }
+  return 1;
+}
+
+// Fallback only, lock held: blocks until the fence carrying value has signaled
+static int wait_fence_slot(VSDL_Context* ctx, uint32_t slot, uint64_t timeout) {
+  VSDL_Sync* sync = &ctx->sync;
+  if (sync->fenceValues[slot] <= sync->completed) return 1;
+  VkResult result = timeout ? vkWaitForFences(ctx->device, 1, &sync->fences[slot], VK_TRUE, timeout)
+                            : vkGetFenceStatus(ctx->device, sync->fences[slot]);
+  if (result != VK_SUCCESS) return 0;
+  // Submits finish in order, so everything up to this value is done too
+  if (sync->fenceValues[slot] > sync->completed) sync->completed = sync->fenceValues[slot];
+  return 1;
+}
+
+int vsdl_sync_submit(VSDL_Context* ctx, const VkSubmitInfo* submitInfo, uint64_t* outValue) {
+  VSDL_Sync* sync = &ctx->sync;
+  VkSubmitInfo info = *submitInfo;
+  VkSemaphore signalSemaphores[4];
+  uint64_t signalValues[4] = {0};
+  if (submitInfo->signalSemaphoreCount >= SDL_arraysize(signalSemaphores)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Too many signal semaphores for one submit");
+      return 0;
+  }
+
+  SDL_LockMutex(sync->lock);
+  uint64_t value = sync->submitted + 1;
+  VkFence fence = VK_NULL_HANDLE;
+  VkTimelineSemaphoreSubmitInfo timelineInfo = {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+  if (sync->semaphore != VK_NULL_HANDLE) {
+      // Binary semaphores ignore their entry in the value arrays
+      for (uint32_t i = 0; i < submitInfo->signalSemaphoreCount; i++) signalSemaphores[i] = submitInfo->pSignalSemaphores[i];
+      signalSemaphores[info.signalSemaphoreCount] = sync->semaphore;
+      signalValues[info.signalSemaphoreCount] = value;
+      info.signalSemaphoreCount++;
+      info.pSignalSemaphores = signalSemaphores;
+      timelineInfo.pNext = info.pNext;
+      timelineInfo.signalSemaphoreValueCount = info.signalSemaphoreCount;
+      timelineInfo.pSignalSemaphoreValues = signalValues;
+      info.pNext = &timelineInfo;
+  } else {
+      // The slot's previous value is older than anything still worth tracking; make sure it is done
+      uint32_t slot = (uint32_t)(value % VSDL_SYNC_FALLBACK_FENCES);
+      if (!wait_fence_slot(ctx, slot, UINT64_MAX)) {
+          SDL_UnlockMutex(sync->lock);
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to wait for sync fence");
+          return 0;
+      }
+      vkResetFences(ctx->device, 1, &sync->fences[slot]);
+      sync->fenceValues[slot] = value;
+      fence = sync->fences[slot];
+  }
+
+  VkResult result = vkQueueSubmit(ctx->graphicsQueue, 1, &info, fence);
+  if (result == VK_SUCCESS) sync->submitted = value;
+  SDL_UnlockMutex(sync->lock);
+  if (result != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to submit queue: %d", result);
+      return 0;
+  }
+  if (outValue) *outValue = value;
+  return 1;
+}
+
+static int poll(VSDL_Context* ctx, uint64_t value, uint64_t timeout) {
+  VSDL_Sync* sync = &ctx->sync;
+  if (value <= sync->completed) return 1;
+  if (value > sync->submitted) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Waiting for timeline value %llu that was never submitted",
+                   (unsigned long long)value);
+      return 0;
+  }
+  if (sync->semaphore != VK_NULL_HANDLE) {
+      if (timeout) {
+          VkSemaphoreWaitInfo waitInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+          waitInfo.semaphoreCount = 1;
+          waitInfo.pSemaphores = &sync->semaphore;
+          waitInfo.pValues = &value;
+          if (sync->waitSemaphores(ctx->device, &waitInfo, timeout) != VK_SUCCESS) return 0;
+      }
+      uint64_t counter = 0;
+      if (sync->getCounterValue(ctx->device, sync->semaphore, &counter) != VK_SUCCESS) return 0;
+      if (counter > sync->completed) sync->completed = counter;
+      return value <= sync->completed;
+  }
+  // A slot is reused only after its old value completed, so value is either done or still in its slot
+  uint32_t slot = (uint32_t)(value % VSDL_SYNC_FALLBACK_FENCES);
+  if (sync->fenceValues[slot] != value) return 1;
+  return wait_fence_slot(ctx, slot, timeout);
+}
+
+uint64_t vsdl_sync_submitted(VSDL_Context* ctx) {
+  SDL_LockMutex(ctx->sync.lock);
+  uint64_t value = ctx->sync.submitted;
+  SDL_UnlockMutex(ctx->sync.lock);
+  return value;
+}
+
+int vsdl_sync_reached(VSDL_Context* ctx, uint64_t value) {
+  VSDL_Sync* sync = &ctx->sync;
+  SDL_LockMutex(sync->lock);
+  int reached = value <= sync->completed || (value <= sync->submitted && poll(ctx, value, 0));
+  SDL_UnlockMutex(sync->lock);
+  return reached;
+}
+
+int vsdl_sync_wait(VSDL_Context* ctx, uint64_t value) {
+  VSDL_Sync* sync = &ctx->sync;
+  SDL_LockMutex(sync->lock);
+  int pending = value > sync->completed && value <= sync->submitted;
+  SDL_UnlockMutex(sync->lock);
+  if (sync->semaphore != VK_NULL_HANDLE && pending) {
+      // Block without the lock so other threads can keep submitting
+      VkSemaphoreWaitInfo waitInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+      waitInfo.semaphoreCount = 1;
+      waitInfo.pSemaphores = &sync->semaphore;
+      waitInfo.pValues = &value;
+      sync->waitSemaphores(ctx->device, &waitInfo, UINT64_MAX);
+  }
+  SDL_LockMutex(sync->lock);
+  int reached = poll(ctx, value, UINT64_MAX);
+  SDL_UnlockMutex(sync->lock);
+  if (!reached) SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to wait for timeline value %llu", (unsigned long long)value);
+  return reached;
+}
+
+int vsdl_sync_wait_all(VSDL_Context* ctx) {
+  return vsdl_sync_wait(ctx, vsdl_sync_submitted(ctx));
+}
+
+static void destroy_deferred(VSDL_Context* ctx, const VSDL_Deferred* object) {
+  switch (object->type) {
+  case VSDL_DEFER_BUFFER:
+      vsdl_memory_destroy_buffer(ctx, object->buffer, object->allocation);
+      break;
+  case VSDL_DEFER_IMAGE:
+      vsdl_memory_destroy_image(ctx, object->image, object->allocation);
+      break;
+  case VSDL_DEFER_IMAGE_VIEW:
+      vkDestroyImageView(ctx->device, object->view, NULL);
+      break;
+  }
+}
+
+static void defer(VSDL_Context* ctx, const VSDL_Deferred* object) {
+  VSDL_Sync* sync = &ctx->sync;
+  SDL_LockMutex(sync->lock);
+  if (sync->deferredCount == VSDL_SYNC_MAX_DEFERRED) {
+      // Queue full: pay for one stall instead of leaking
+      SDL_UnlockMutex(sync->lock);
+      vsdl_sync_wait_all(ctx);
+      vsdl_sync_collect(ctx);
+      SDL_LockMutex(sync->lock);
+  }
+  VSDL_Deferred* entry = &sync->deferred[sync->deferredCount++];
+  *entry = *object;
+  // Callers swap the object out before recording, so only work already submitted can still use it
+  entry->value = sync->submitted;
+  SDL_UnlockMutex(sync->lock);
+}
+
+void vsdl_sync_defer_buffer(VSDL_Context* ctx, VkBuffer buffer, VmaAllocation allocation) {
+  if (buffer == VK_NULL_HANDLE) return;
+  VSDL_Deferred object = {VSDL_DEFER_BUFFER};
+  object.buffer = buffer;
+  object.allocation = allocation;
+  defer(ctx, &object);
+}
+
+void vsdl_sync_defer_image(VSDL_Context* ctx, VkImage image, VmaAllocation allocation) {
+  if (image == VK_NULL_HANDLE) return;
+  VSDL_Deferred object = {VSDL_DEFER_IMAGE};
+  object.image = image;
+  object.allocation = allocation;
+  defer(ctx, &object);
+}
+
+void vsdl_sync_defer_image_view(VSDL_Context* ctx, VkImageView view) {
+  if (view == VK_NULL_HANDLE) return;
+  VSDL_Deferred object = {VSDL_DEFER_IMAGE_VIEW};
+  object.view = view;
+  defer(ctx, &object);
+}
+
+void vsdl_sync_collect(VSDL_Context* ctx) {
+  VSDL_Sync* sync = &ctx->sync;
+  SDL_LockMutex(sync->lock);
+  poll(ctx, sync->submitted, 0);
+  // Entries are appended in value order, so the reached ones form a prefix
+  uint32_t done = 0;
+  while (done < sync->deferredCount && sync->deferred[done].value <= sync->completed) {
+      destroy_deferred(ctx, &sync->deferred[done]);
+      done++;
+  }
+  if (done) {
+      SDL_memmove(sync->deferred, sync->deferred + done, (sync->deferredCount - done) * sizeof(VSDL_Deferred));
+      sync->deferredCount -= done;
+  }
+  SDL_UnlockMutex(sync->lock);
+}
+
+void vsdl_sync_shutdown(VSDL_Context* ctx) {
+  VSDL_Sync* sync = &ctx->sync;
+  if (ctx->device == VK_NULL_HANDLE) return;
+  if (sync->lock) {
+      vsdl_sync_wait_all(ctx);
+      vsdl_sync_collect(ctx);
+  }
+  if (sync->semaphore != VK_NULL_HANDLE) vkDestroySemaphore(ctx->device, sync->semaphore, NULL);
+  for (uint32_t i = 0; i < VSDL_SYNC_FALLBACK_FENCES; i++) {
+      if (sync->fences[i] != VK_NULL_HANDLE) vkDestroyFence(ctx->device, sync->fences[i], NULL);
+  }
+  if (sync->lock) SDL_DestroyMutex(sync->lock);
+  SDL_memset(sync, 0, sizeof(*sync));
+}
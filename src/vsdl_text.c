@@ -7,8 +7,82 @@
 #include FT_FREETYPE_H
 #include "vsdl_text.h"
 #include "vsdl_types.h"
-#include "vsdl_utils.h"
+#include "vsdl_pack.h"
+#include "vsdl_upload.h"
+#include "vsdl_memory.h"
+#include "vsdl_arena.h"
+#include "vsdl_text_simd.h"
+#include "vsdl_glyph_raster.h"
+#include "vsdl_shape.h"
+#include "vsdl_idle.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_sync.h"
+#include "vsdl_text_object.h"
+#include "vsdl_text_view.h"
+
+
+// Shelf-packs one rasterized batch and widens the dirty row range for the next upload
+static int pack_glyph_batch(FontAtlas* atlas, const VSDL_GlyphBatch* batch) {
+  for (uint32_t i = 0; i < batch->count; i++) {
+      const VSDL_RasterGlyph* src = &batch->glyphs[i];
+      if (src->codepoint >= 128) continue;
+      GlyphMetrics* glyph = &atlas->glyphs[src->codepoint];
+      SDL_memset(glyph, 0, sizeof(*glyph));
+      glyph->advance = src->advance;
+      if (!src->bitmap) continue;
+
+      if (atlas->packX + src->width >= atlas->width) {
+          atlas->packX = 0;
+          atlas->packY += atlas->packRowHeight + 1;
+          atlas->packRowHeight = 0;
+      }
+      if (atlas->packY + src->rows >= atlas->height) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Font atlas too small for all glyphs");
+          return 0;
+      }
+
+      for (uint32_t row = 0; row < src->rows; row++) {
+          memcpy(atlas->pixels + (size_t)(atlas->packY + row) * atlas->width + atlas->packX,
+                 src->bitmap + (size_t)row * src->width, src->width);
+      }
+
+      glyph->x = (float)atlas->packX / atlas->width;
+      glyph->y = (float)atlas->packY / atlas->height;
+      glyph->w = (float)src->width / atlas->width;
+      glyph->h = (float)src->rows / atlas->height;
+      glyph->bearingX = (float)src->left;
+      glyph->bearingY = (float)src->top;
+
+      atlas->dirtyMinY = SDL_min(atlas->dirtyMinY, atlas->packY);
+      atlas->dirtyMaxY = SDL_max(atlas->dirtyMaxY, atlas->packY + src->rows);
+      atlas->packX += src->width + 1;
+      atlas->packRowHeight = SDL_max(atlas->packRowHeight, src->rows);
+  }
+  return 1;
+}
 
+// Releases what create_font_atlas holds so far on a failed startup. Vulkan objects are left to
+// vsdl_cleanup, which runs after a failed init too; everything freed here is cleared so it does not
+// free them again
+static int fail_font_atlas(VSDL_Context* ctx) {
+  if (ctx->glyphRaster.batches) {
+      // Queued batches read the font data, so they finish before it goes away
+      while (vsdl_glyph_raster_next(&ctx->glyphRaster, 1) != NULL) continue;
+      vsdl_glyph_raster_end(&ctx->glyphRaster);
+  }
+  free(ctx->fontAtlas.pixels);
+  ctx->fontAtlas.pixels = NULL;
+  if (ctx->ftFace) {
+      FT_Done_Face(ctx->ftFace);
+      ctx->ftFace = NULL;
+  }
+  vsdl_asset_release(&ctx->fontAsset);
+  if (ctx->ftLibrary) {
+      FT_Done_FreeType(ctx->ftLibrary);
+      ctx->ftLibrary = NULL;
+  }
+  return 0;
+}
 
 static int create_font_atlas(VSDL_Context* ctx) {
   // Initialize FreeType
@@ -18,10 +92,11 @@ static int create_font_atlas(VSDL_Context* ctx) {
   }
 
   // Load font face
-  if (FT_New_Face(ctx->ftLibrary, "fonts/Kenney Mini.ttf", 0, &ctx->ftFace)) {
+  // FreeType reads the font in place, so the asset stays alive until FT_Done_Face
+  if (!vsdl_asset_load(ctx, "fonts/Kenney Mini.ttf", &ctx->fontAsset) ||
+      FT_New_Memory_Face(ctx->ftLibrary, (const FT_Byte*)ctx->fontAsset.data, (FT_Long)ctx->fontAsset.size, 0, &ctx->ftFace)) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load font 'Kenney Mini.ttf'");
-      FT_Done_FreeType(ctx->ftLibrary);
-      return 0;
+      return fail_font_atlas(ctx);
   }
 
   FT_Set_Pixel_Sizes(ctx->ftFace, 0, 48);
@@ -32,63 +107,24 @@ static int create_font_atlas(VSDL_Context* ctx) {
   ctx->fontAtlas.pixels = (unsigned char*)calloc(atlasWidth * atlasHeight, sizeof(unsigned char));
   if (!ctx->fontAtlas.pixels) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate font atlas pixels");
-      FT_Done_Face(ctx->ftFace);
-      FT_Done_FreeType(ctx->ftLibrary);
-      return 0;
+      return fail_font_atlas(ctx);
   }
   ctx->fontAtlas.width = atlasWidth;
   ctx->fontAtlas.height = atlasHeight;
-
-  int x = 0, y = 0, maxHeight = 0;
-  for (unsigned char c = 32; c < 128; c++) {
-      if (FT_Load_Char(ctx->ftFace, c, FT_LOAD_RENDER)) {
-          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load glyph '%c'", c);
-          continue;
-      }
-
-      if (!ctx->ftFace->glyph->bitmap.buffer) {
-          ctx->fontAtlas.glyphs[c].x = 0.0f;
-          ctx->fontAtlas.glyphs[c].y = 0.0f;
-          ctx->fontAtlas.glyphs[c].w = 0.0f;
-          ctx->fontAtlas.glyphs[c].h = 0.0f;
-          ctx->fontAtlas.glyphs[c].advance = (float)(ctx->ftFace->glyph->advance.x >> 6);
-          ctx->fontAtlas.glyphs[c].bearingX = 0.0f;
-          ctx->fontAtlas.glyphs[c].bearingY = 0.0f;
-          continue;
-      }
-
-      if ((uint32_t)x + ctx->ftFace->glyph->bitmap.width >= atlasWidth) {
-          x = 0;
-          y += maxHeight + 1;
-          maxHeight = 0;
-      }
-
-      if ((uint32_t)y + ctx->ftFace->glyph->bitmap.rows >= atlasHeight) {
-          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Font atlas too small for all glyphs");
-          free(ctx->fontAtlas.pixels);
-          FT_Done_Face(ctx->ftFace);
-          FT_Done_FreeType(ctx->ftLibrary);
-          return 0;
-      }
-
-      for (unsigned int row = 0; row < ctx->ftFace->glyph->bitmap.rows; row++) {
-          for (unsigned int col = 0; col < ctx->ftFace->glyph->bitmap.width; col++) {
-              unsigned char pixel = ctx->ftFace->glyph->bitmap.buffer[row * ctx->ftFace->glyph->bitmap.width + col];
-              ctx->fontAtlas.pixels[(y + row) * atlasWidth + (x + col)] = pixel;
-          }
-      }
-
-      ctx->fontAtlas.glyphs[c].x = (float)x / atlasWidth;
-      ctx->fontAtlas.glyphs[c].y = (float)y / atlasHeight;
-      ctx->fontAtlas.glyphs[c].w = (float)ctx->ftFace->glyph->bitmap.width / atlasWidth;
-      ctx->fontAtlas.glyphs[c].h = (float)ctx->ftFace->glyph->bitmap.rows / atlasHeight;
-      ctx->fontAtlas.glyphs[c].advance = (float)(ctx->ftFace->glyph->advance.x >> 6);
-      ctx->fontAtlas.glyphs[c].bearingX = (float)ctx->ftFace->glyph->bitmap_left;
-      ctx->fontAtlas.glyphs[c].bearingY = (float)ctx->ftFace->glyph->bitmap_top;
-
-      x += ctx->ftFace->glyph->bitmap.width + 1;
-      maxHeight = (ctx->ftFace->glyph->bitmap.rows > maxHeight) ? ctx->ftFace->glyph->bitmap.rows : maxHeight;
+  ctx->fontAtlas.dirtyMinY = atlasHeight;
+  ctx->fontAtlas.dirtyMaxY = 0;
+
+  // Rasterize on the workers; the atlas goes live with the first batch and the rest
+  // are packed by vsdl_text_begin_frame as they finish
+  if (!vsdl_glyph_raster_begin(ctx, &ctx->glyphRaster, ctx->fontAsset.data, ctx->fontAsset.size, 48, 32, 127)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to start glyph rasterization");
+      return fail_font_atlas(ctx);
+  }
+  const VSDL_GlyphBatch* firstBatch = vsdl_glyph_raster_next(&ctx->glyphRaster, 1);
+  if (!firstBatch || !pack_glyph_batch(&ctx->fontAtlas, firstBatch)) {
+      return fail_font_atlas(ctx);
   }
+  vsdl_glyph_table_build(&ctx->fontAtlas.table, &ctx->fontAtlas);
 
   // Create Vulkan image
   VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
@@ -107,149 +143,39 @@ static int create_font_atlas(VSDL_Context* ctx) {
 
   VmaAllocationCreateInfo allocInfo = {0};
   allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-  if (vmaCreateImage(ctx->allocator, &imageInfo, &allocInfo, &ctx->fontAtlas.texture, &ctx->fontAtlas.textureAllocation, NULL) != VK_SUCCESS) {
+  if (!vsdl_memory_create_image(ctx, VSDL_MEMORY_TAG_TEXT, &imageInfo, &allocInfo, &ctx->fontAtlas.texture, &ctx->fontAtlas.textureAllocation, NULL)) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create font texture");
-      free(ctx->fontAtlas.pixels);
-      FT_Done_Face(ctx->ftFace);
-      FT_Done_FreeType(ctx->ftLibrary);
-      return 0;
+      return fail_font_atlas(ctx);
   }
 
-  // Upload atlas to GPU
-  VkCommandBuffer cmdBuffer;
-  VkCommandBufferAllocateInfo cmdAllocInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
-  cmdAllocInfo.commandPool = ctx->commandPool;
-  cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  cmdAllocInfo.commandBufferCount = 1;
-  if (vkAllocateCommandBuffers(ctx->device, &cmdAllocInfo, &cmdBuffer) != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate command buffer for font atlas");
-      free(ctx->fontAtlas.pixels);
-      FT_Done_Face(ctx->ftFace);
-      FT_Done_FreeType(ctx->ftLibrary);
-      return 0;
+  // Upload atlas to GPU through the shared staging path
+  VkCommandBuffer cmdBuffer = vsdl_upload_command_buffer(ctx);
+  if (cmdBuffer == VK_NULL_HANDLE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to begin font atlas upload");
+      return fail_font_atlas(ctx);
   }
 
-  VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-  if (vkBeginCommandBuffer(cmdBuffer, &beginInfo) != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to begin command buffer for font atlas");
-      vkFreeCommandBuffers(ctx->device, ctx->commandPool, 1, &cmdBuffer);
-      free(ctx->fontAtlas.pixels);
-      FT_Done_Face(ctx->ftFace);
-      FT_Done_FreeType(ctx->ftLibrary);
-      return 0;
-  }
-
-  VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-  barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  barrier.image = ctx->fontAtlas.texture;
-  barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  barrier.subresourceRange.baseMipLevel = 0;
-  barrier.subresourceRange.levelCount = 1;
-  barrier.subresourceRange.baseArrayLayer = 0;
-  barrier.subresourceRange.layerCount = 1;
-  barrier.srcAccessMask = 0;
-  barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-  vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
-
-  VkBuffer stagingBuffer;
-  VmaAllocation stagingAllocation;
-  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-  bufferInfo.size = atlasWidth * atlasHeight;
-  bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-  VmaAllocationCreateInfo stagingAllocInfo = {0};
-  stagingAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-  stagingAllocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
-  if (vmaCreateBuffer(ctx->allocator, &bufferInfo, &stagingAllocInfo, &stagingBuffer, &stagingAllocation, NULL) != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create staging buffer for font atlas");
-      vkFreeCommandBuffers(ctx->device, ctx->commandPool, 1, &cmdBuffer);
-      free(ctx->fontAtlas.pixels);
-      FT_Done_Face(ctx->ftFace);
-      FT_Done_FreeType(ctx->ftLibrary);
-      return 0;
-  }
+  vsdl_cmd_image_barrier(cmdBuffer, ctx->fontAtlas.texture, 0, 1,
+                         VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         0, VK_ACCESS_TRANSFER_WRITE_BIT,
+                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
 
-  void* data;
-  if (vmaMapMemory(ctx->allocator, stagingAllocation, &data) != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to map staging buffer memory");
-      vmaDestroyBuffer(ctx->allocator, stagingBuffer, stagingAllocation);
-      vkFreeCommandBuffers(ctx->device, ctx->commandPool, 1, &cmdBuffer);
-      free(ctx->fontAtlas.pixels);
-      FT_Done_Face(ctx->ftFace);
-      FT_Done_FreeType(ctx->ftLibrary);
-      return 0;
-  }
-  memcpy(data, ctx->fontAtlas.pixels, atlasWidth * atlasHeight);
-  vmaUnmapMemory(ctx->allocator, stagingAllocation);
-
-  VkBufferImageCopy copyRegion = {0};
-  copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  copyRegion.imageSubresource.layerCount = 1;
-  copyRegion.imageExtent.width = atlasWidth;
-  copyRegion.imageExtent.height = atlasHeight;
-  copyRegion.imageExtent.depth = 1;
-  vkCmdCopyBufferToImage(cmdBuffer, stagingBuffer, ctx->fontAtlas.texture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
-
-  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-  barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-  barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-  vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
-
-  if (vkEndCommandBuffer(cmdBuffer) != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to end command buffer for font atlas");
-      vmaDestroyBuffer(ctx->allocator, stagingBuffer, stagingAllocation);
-      vkFreeCommandBuffers(ctx->device, ctx->commandPool, 1, &cmdBuffer);
-      free(ctx->fontAtlas.pixels);
-      FT_Done_Face(ctx->ftFace);
-      FT_Done_FreeType(ctx->ftLibrary);
-      return 0;
+  if (!vsdl_upload_image(ctx, ctx->fontAtlas.texture, 0, 0, atlasWidth, atlasHeight, ctx->fontAtlas.pixels, 1)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Staging buffer too small for font atlas");
+      return fail_font_atlas(ctx);
   }
 
-  VkFenceCreateInfo fenceInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-  VkFence fence;
-  if (vkCreateFence(ctx->device, &fenceInfo, NULL, &fence) != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create fence for font atlas");
-      vmaDestroyBuffer(ctx->allocator, stagingBuffer, stagingAllocation);
-      vkFreeCommandBuffers(ctx->device, ctx->commandPool, 1, &cmdBuffer);
-      free(ctx->fontAtlas.pixels);
-      FT_Done_Face(ctx->ftFace);
-      FT_Done_FreeType(ctx->ftLibrary);
-      return 0;
-  }
+  vsdl_cmd_image_barrier(cmdBuffer, ctx->fontAtlas.texture, 0, 1,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                         VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
 
-  VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-  submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &cmdBuffer;
-  if (vkQueueSubmit(ctx->graphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to submit font atlas upload");
-      vkDestroyFence(ctx->device, fence, NULL);
-      vmaDestroyBuffer(ctx->allocator, stagingBuffer, stagingAllocation);
-      vkFreeCommandBuffers(ctx->device, ctx->commandPool, 1, &cmdBuffer);
-      free(ctx->fontAtlas.pixels);
-      FT_Done_Face(ctx->ftFace);
-      FT_Done_FreeType(ctx->ftLibrary);
-      return 0;
+  if (!vsdl_upload_flush(ctx, 1)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to upload font atlas");
+      return fail_font_atlas(ctx);
   }
-
-  if (vkWaitForFences(ctx->device, 1, &fence, VK_TRUE, UINT64_MAX) != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to wait for font atlas upload fence");
-      vkDestroyFence(ctx->device, fence, NULL);
-      vmaDestroyBuffer(ctx->allocator, stagingBuffer, stagingAllocation);
-      vkFreeCommandBuffers(ctx->device, ctx->commandPool, 1, &cmdBuffer);
-      free(ctx->fontAtlas.pixels);
-      FT_Done_Face(ctx->ftFace);
-      FT_Done_FreeType(ctx->ftLibrary);
-      return 0;
-  }
-
-  vkDestroyFence(ctx->device, fence, NULL);
-  vmaDestroyBuffer(ctx->allocator, stagingBuffer, stagingAllocation);
-  vkFreeCommandBuffers(ctx->device, ctx->commandPool, 1, &cmdBuffer);
+  ctx->fontAtlas.dirtyMinY = atlasHeight;
+  ctx->fontAtlas.dirtyMaxY = 0;
 
   // Create image view
   VkImageViewCreateInfo viewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
@@ -263,10 +189,7 @@ static int create_font_atlas(VSDL_Context* ctx) {
   viewInfo.subresourceRange.layerCount = 1;
   if (vkCreateImageView(ctx->device, &viewInfo, NULL, &ctx->fontAtlas.textureView) != VK_SUCCESS) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create font texture view");
-      free(ctx->fontAtlas.pixels);
-      FT_Done_Face(ctx->ftFace);
-      FT_Done_FreeType(ctx->ftLibrary);
-      return 0;
+      return fail_font_atlas(ctx);
   }
 
   // Create sampler
@@ -281,11 +204,7 @@ static int create_font_atlas(VSDL_Context* ctx) {
   samplerInfo.maxLod = 0.0f;
   if (vkCreateSampler(ctx->device, &samplerInfo, NULL, &ctx->fontAtlas.sampler) != VK_SUCCESS) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create font sampler");
-      vkDestroyImageView(ctx->device, ctx->fontAtlas.textureView, NULL);
-      free(ctx->fontAtlas.pixels);
-      FT_Done_Face(ctx->ftFace);
-      FT_Done_FreeType(ctx->ftLibrary);
-      return 0;
+      return fail_font_atlas(ctx);
   }
 
   SDL_Log("Font atlas created");
@@ -294,6 +213,12 @@ static int create_font_atlas(VSDL_Context* ctx) {
 
 
 int vsdl_init_text(VSDL_Context* ctx) {
+  vsdl_text_simd_init();
+  SDL_Log("Glyph layout kernel: %s", vsdl_text_simd_name());
+  if (!vsdl_shape_init(ctx, 1024 * 1024)) {
+      return 0;
+  }
+
   // Create the font atlas
   if (!create_font_atlas(ctx)) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create font atlas");
@@ -306,100 +231,31 @@ int vsdl_init_text(VSDL_Context* ctx) {
       return 0;
   }
 
+  // Retained text shares the atlas and its descriptor set layout
+  if (!vsdl_text_objects_init(ctx)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to initialize retained text");
+      return 0;
+  }
+
+  // Text views draw through the same pipeline, spaced by the face's line height
+  if (!vsdl_text_views_init(ctx)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to initialize text views");
+      return 0;
+  }
+
   SDL_Log("Text rendering initialized");
   return 1;
 }
 
 int vsdl_create_text_pipeline(VSDL_Context* ctx) {
-  size_t vertSize, fragSize;
-  char* vertCode = readFile("shaders/text.vert.spv", &vertSize);
-  char* fragCode = readFile("shaders/text.frag.spv", &fragSize);
-  if (!vertCode || !fragCode) {
+  VSDL_PipelineKey key = {0};
+  key.vertexShader = vsdl_pipeline_shader(ctx, "shaders/text.vert.spv");
+  key.fragmentShader = vsdl_pipeline_shader(ctx, "shaders/text.frag.spv");
+  if (key.vertexShader == VK_NULL_HANDLE || key.fragmentShader == VK_NULL_HANDLE) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load text shaders");
-      free(vertCode);
-      free(fragCode);
       return 0;
   }
 
-  VkShaderModule vertModule, fragModule;
-  VkShaderModuleCreateInfo vertInfo = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
-  vertInfo.codeSize = vertSize;
-  vertInfo.pCode = (uint32_t*)vertCode;
-  VkShaderModuleCreateInfo fragInfo = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
-  fragInfo.codeSize = fragSize;
-  fragInfo.pCode = (uint32_t*)fragCode;
-
-  if (vkCreateShaderModule(ctx->device, &vertInfo, NULL, &vertModule) != VK_SUCCESS ||
-      vkCreateShaderModule(ctx->device, &fragInfo, NULL, &fragModule) != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create text shader modules");
-      free(vertCode);
-      free(fragCode);
-      return 0;
-  }
-
-  VkPipelineShaderStageCreateInfo shaderStages[2] = {
-      {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO},
-      {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO}
-  };
-  shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
-  shaderStages[0].module = vertModule;
-  shaderStages[0].pName = "main";
-  shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-  shaderStages[1].module = fragModule;
-  shaderStages[1].pName = "main";
-
-  VkVertexInputBindingDescription bindingDesc = {0};
-  bindingDesc.binding = 0;
-  bindingDesc.stride = sizeof(TextVertex);
-  bindingDesc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-  VkVertexInputAttributeDescription attribDescs[2] = {
-      {0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(TextVertex, pos)},
-      {1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(TextVertex, texCoord)}
-  };
-
-  VkPipelineVertexInputStateCreateInfo vertexInputInfo = {VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
-  vertexInputInfo.vertexBindingDescriptionCount = 1;
-  vertexInputInfo.pVertexBindingDescriptions = &bindingDesc;
-  vertexInputInfo.vertexAttributeDescriptionCount = 2;
-  vertexInputInfo.pVertexAttributeDescriptions = attribDescs;
-
-  VkPipelineInputAssemblyStateCreateInfo inputAssemblyInfo = {VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO};
-  inputAssemblyInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-  inputAssemblyInfo.primitiveRestartEnable = VK_FALSE;
-
-  VkViewport viewport = {0.0f, 0.0f, (float)ctx->swapchainExtent.width, (float)ctx->swapchainExtent.height, 0.0f, 1.0f};
-  VkRect2D scissor = {{0, 0}, ctx->swapchainExtent};
-  VkPipelineViewportStateCreateInfo viewportState = {VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO};
-  viewportState.viewportCount = 1;
-  viewportState.pViewports = &viewport;
-  viewportState.scissorCount = 1;
-  viewportState.pScissors = &scissor;
-
-  VkPipelineRasterizationStateCreateInfo rasterizer = {VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO};
-  rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-  rasterizer.lineWidth = 1.0f;
-  rasterizer.cullMode = VK_CULL_MODE_NONE;
-
-  VkPipelineMultisampleStateCreateInfo multisampling = {VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO};
-  multisampling.sampleShadingEnable = VK_FALSE;
-  multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-  VkPipelineColorBlendAttachmentState colorBlendAttachment = {0};
-  colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-  colorBlendAttachment.blendEnable = VK_TRUE;
-  colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-  colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-  colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-  colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-  colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-  colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
-
-  VkPipelineColorBlendStateCreateInfo colorBlending = {VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO};
-  colorBlending.logicOpEnable = VK_FALSE;
-  colorBlending.attachmentCount = 1;
-  colorBlending.pAttachments = &colorBlendAttachment;
-
   // Create descriptor set layout for font texture
   VkDescriptorSetLayoutBinding samplerBinding = {0};
   samplerBinding.binding = 0;
@@ -413,133 +269,215 @@ int vsdl_create_text_pipeline(VSDL_Context* ctx) {
   layoutInfo.pBindings = &samplerBinding;
   if (vkCreateDescriptorSetLayout(ctx->device, &layoutInfo, NULL, &ctx->descriptorSetLayout) != VK_SUCCESS) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create descriptor set layout for text");
-      vkDestroyShaderModule(ctx->device, fragModule, NULL);
-      vkDestroyShaderModule(ctx->device, vertModule, NULL);
-      free(vertCode);
-      free(fragCode);
       return 0;
   }
 
-  // Create text pipeline layout
-  VkPipelineLayoutCreateInfo pipelineLayoutInfo = {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
-  pipelineLayoutInfo.setLayoutCount = 1;
-  pipelineLayoutInfo.pSetLayouts = &ctx->descriptorSetLayout;
-  pipelineLayoutInfo.pushConstantRangeCount = 0;
-  pipelineLayoutInfo.pPushConstantRanges = NULL;
-
-  if (vkCreatePipelineLayout(ctx->device, &pipelineLayoutInfo, NULL, &ctx->textPipelineLayout) != VK_SUCCESS) {
+  // Text pipeline layout, owned by the pipeline registry; position, scale and colour are per draw
+  VkPushConstantRange pushRange = {VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(VSDL_TextPushConstants)};
+  ctx->textPipelineLayout = vsdl_pipeline_layout(ctx, &ctx->descriptorSetLayout, 1, &pushRange);
+  if (ctx->textPipelineLayout == VK_NULL_HANDLE) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create text pipeline layout");
-      vkDestroyDescriptorSetLayout(ctx->device, ctx->descriptorSetLayout, NULL);
-      vkDestroyShaderModule(ctx->device, fragModule, NULL);
-      vkDestroyShaderModule(ctx->device, vertModule, NULL);
-      free(vertCode);
-      free(fragCode);
       return 0;
   }
   SDL_Log("Text pipeline layout created");
 
-  VkGraphicsPipelineCreateInfo pipelineInfo = {VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
-  pipelineInfo.stageCount = 2;
-  pipelineInfo.pStages = shaderStages;
-  pipelineInfo.pVertexInputState = &vertexInputInfo;
-  pipelineInfo.pInputAssemblyState = &inputAssemblyInfo;
-  pipelineInfo.pViewportState = &viewportState;
-  pipelineInfo.pRasterizationState = &rasterizer;
-  pipelineInfo.pMultisampleState = &multisampling;
-  pipelineInfo.pColorBlendState = &colorBlending;
-  pipelineInfo.layout = ctx->textPipelineLayout; // Use dedicated text pipeline layout
-  pipelineInfo.renderPass = ctx->renderPass;
-  pipelineInfo.subpass = 0;
-
-  if (vkCreateGraphicsPipelines(ctx->device, VK_NULL_HANDLE, 1, &pipelineInfo, NULL, &ctx->textPipeline) != VK_SUCCESS) {
+  key.layout = ctx->textPipelineLayout;
+  key.vertexStride = sizeof(TextVertex);
+  key.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+  key.attributeCount = 2;
+  key.attributes[0] = (VSDL_VertexAttribute){0, VK_FORMAT_R32G32_SFLOAT, offsetof(TextVertex, pos)};
+  key.attributes[1] = (VSDL_VertexAttribute){1, VK_FORMAT_R32G32_SFLOAT, offsetof(TextVertex, texCoord)};
+  key.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+  key.cullMode = VK_CULL_MODE_NONE;
+  key.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+  key.blend = VSDL_BLEND_ALPHA_REPLACE;
+
+  ctx->textPipeline = vsdl_pipeline_get(ctx, &key);
+  if (ctx->textPipeline == VK_NULL_HANDLE) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create text pipeline");
-      vkDestroyPipelineLayout(ctx->device, ctx->textPipelineLayout, NULL);
-      vkDestroyDescriptorSetLayout(ctx->device, ctx->descriptorSetLayout, NULL);
-      vkDestroyShaderModule(ctx->device, fragModule, NULL);
-      vkDestroyShaderModule(ctx->device, vertModule, NULL);
-      free(vertCode);
-      free(fragCode);
       return 0;
   }
 
-  vkDestroyShaderModule(ctx->device, fragModule, NULL);
-  vkDestroyShaderModule(ctx->device, vertModule, NULL);
-  free(vertCode);
-  free(fragCode);
-
   SDL_Log("Text pipeline created");
   return 1;
 }
 
 
-void vsdl_render_text(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const char* text, float x, float y) {
-  size_t len = strlen(text);
-  TextVertex* vertices = (TextVertex*)malloc(len * 6 * sizeof(TextVertex));
-  uint32_t vertexCount = 0;
-
-  float scale = 1.0f;
-  float cursorX = x;
-
-  for (size_t i = 0; i < len; i++) {
-      unsigned char c = (unsigned char)text[i];
-      if (c < 32 || c >= 128) continue;
+static int create_text_vertex_buffer(VSDL_Context* ctx, uint32_t capacity) {
+  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  bufferInfo.size = (VkDeviceSize)capacity * sizeof(TextVertex);
+  bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-      GlyphMetrics* glyph = &ctx->fontAtlas.glyphs[c];
-      if (glyph->w == 0 || glyph->h == 0) continue;
+  VmaAllocationCreateInfo allocInfo = {0};
+  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  VmaAllocationInfo info;
+  if (!vsdl_memory_create_buffer(ctx, VSDL_MEMORY_TAG_TEXT, &bufferInfo, &allocInfo, &ctx->textVertexBuffer, &ctx->textVertexBufferAllocation, &info)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create text vertex buffer");
+      return 0;
+  }
+  ctx->textVertices = (TextVertex*)info.pMappedData;
+  ctx->textVertexCapacity = capacity;
+  return 1;
+}
 
-      float xPos = cursorX + glyph->bearingX / (float)ctx->swapchainExtent.width * 2.0f;
-      float yPos = y - glyph->bearingY / (float)ctx->swapchainExtent.height * 2.0f;
-      float w = glyph->w * ctx->fontAtlas.width / (float)ctx->swapchainExtent.width * 2.0f * scale;
-      float h = glyph->h * ctx->fontAtlas.height / (float)ctx->swapchainExtent.height * 2.0f * scale;
+// Packs batches the workers finished since last frame and uploads the rows they touched
+static void update_font_atlas(VSDL_Context* ctx) {
+  FontAtlas* atlas = &ctx->fontAtlas;
+  if (atlas->texture == VK_NULL_HANDLE) return;
+
+  if (ctx->glyphRaster.batches) {
+      int packed = 0;
+      const VSDL_GlyphBatch* batch;
+      while ((batch = vsdl_glyph_raster_next(&ctx->glyphRaster, 0)) != NULL) {
+          // The overflow that fails startup for the first batch; the atlas never grows, so a retry
+          // would fail the same way. Glyphs packed before it are kept
+          if (!pack_glyph_batch(atlas, batch)) {
+              atlas->droppedBatches++;
+              SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Dropped glyph batch of %u glyphs (%u batches dropped)",
+                           batch->count, atlas->droppedBatches);
+          }
+          packed = 1;
+      }
+      if (packed) {
+          vsdl_glyph_table_build(&atlas->table, atlas);
+          atlas->version++;
+          vsdl_request_redraw(ctx);
+      }
+      if (vsdl_glyph_raster_finished(&ctx->glyphRaster)) {
+          vsdl_glyph_raster_end(&ctx->glyphRaster);
+          if (atlas->droppedBatches) {
+              SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Font atlas complete; %u glyph batches did not fit",
+                          atlas->droppedBatches);
+          } else {
+              SDL_Log("Font atlas complete");
+          }
+      }
+  }
 
-      float texX = glyph->x;
-      float texY = glyph->y;
-      float texW = glyph->w;
-      float texH = glyph->h;
+  if (atlas->dirtyMinY >= atlas->dirtyMaxY) return;
+  uint32_t rows = atlas->dirtyMaxY - atlas->dirtyMinY;
+  if (vsdl_upload_available(ctx) < (VkDeviceSize)rows * atlas->width + 16) {
+      vsdl_request_redraw(ctx);  // Retry next frame
+      return;
+  }
+  VkCommandBuffer cmdBuffer = vsdl_upload_command_buffer(ctx);
+  if (cmdBuffer == VK_NULL_HANDLE) return;
+
+  vsdl_cmd_image_barrier(cmdBuffer, atlas->texture, 0, 1,
+                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+  vsdl_upload_image(ctx, atlas->texture, 0, atlas->dirtyMinY, atlas->width, rows,
+                    atlas->pixels + (size_t)atlas->dirtyMinY * atlas->width, 1);
+  vsdl_cmd_image_barrier(cmdBuffer, atlas->texture, 0, 1,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                         VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+  atlas->dirtyMinY = atlas->height;
+  atlas->dirtyMaxY = 0;
+}
 
-      // SDL_Log("Rendering '%c': pos=(%f, %f), size=(%f, %f), tex=(%f, %f, %f, %f)", 
-      //         c, xPos, yPos, w, h, texX, texY, texX + texW, texY + texH);
+void vsdl_text_begin_frame(VSDL_Context* ctx) {
+  update_font_atlas(ctx);
+
+  // Grown buffers are retired through the timeline rather than relying on the frame wait
+  if (ctx->textVertexDemand > ctx->textVertexCapacity || ctx->textVertexBuffer == VK_NULL_HANDLE) {
+      if (ctx->textVertexBuffer != VK_NULL_HANDLE) {
+          // Last frame dropped text draws; draw again once the grown ring can hold them
+          if (!ctx->textVertexOverflowLogged) {
+              SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Text vertex ring overflow (%u / %u vertices), growing",
+                          ctx->textVertexDemand, ctx->textVertexCapacity);
+              ctx->textVertexOverflowLogged = 1;
+          }
+          vsdl_request_redraw(ctx);
+      }
+      uint32_t capacity = ctx->textVertexCapacity ? ctx->textVertexCapacity : 6 * 4096;
+      while (capacity < ctx->textVertexDemand) capacity *= 2;
+      if (ctx->textVertexBuffer != VK_NULL_HANDLE) {
+          vsdl_sync_defer_buffer(ctx, ctx->textVertexBuffer, ctx->textVertexBufferAllocation);
+          ctx->textVertexBuffer = VK_NULL_HANDLE;
+          ctx->textVertices = NULL;
+          ctx->textVertexCapacity = 0;
+      }
+      create_text_vertex_buffer(ctx, capacity);
+  }
+  ctx->textVertexCount = 0;
+  ctx->textVertexDemand = 0;
+}
 
-      vertices[vertexCount++] = (TextVertex){{xPos, yPos}, {texX, texY}};
-      vertices[vertexCount++] = (TextVertex){{xPos + w, yPos}, {texX + texW, texY}};
-      vertices[vertexCount++] = (TextVertex){{xPos + w, yPos + h}, {texX + texW, texY + texH}};
-      vertices[vertexCount++] = (TextVertex){{xPos, yPos}, {texX, texY}};
-      vertices[vertexCount++] = (TextVertex){{xPos + w, yPos + h}, {texX + texW, texY + texH}};
-      vertices[vertexCount++] = (TextVertex){{xPos, yPos + h}, {texX, texY + texH}};
+void vsdl_draw_text(VSDL_Context* ctx, const char* text, float x, float y) {
+  vsdl_draw_text_styled(ctx, text, x, y, 1.0f, 0xFFFFFFFFu);
+}
 
-      cursorX += glyph->advance / (float)ctx->swapchainExtent.width * 2.0f * scale;
+void vsdl_draw_text_styled(VSDL_Context* ctx, const char* text, float x, float y, float scale, uint32_t color) {
+  VSDL_FramePacket* packet = ctx->renderThread.building;
+  if (!packet) return;
+  if (packet->textCount == packet->textCapacity) {
+      uint32_t capacity = packet->textCapacity ? packet->textCapacity * 2 : 32;
+      VSDL_TextItem* items = (VSDL_TextItem*)vsdl_arena_alloc(&packet->arena, capacity * sizeof(VSDL_TextItem),
+                                                              VSDL_ALIGNOF(VSDL_TextItem));
+      if (!items) return;
+      if (packet->textCount) memcpy(items, packet->textItems, packet->textCount * sizeof(VSDL_TextItem));
+      packet->textItems = items;
+      packet->textCapacity = capacity;
   }
+  size_t len = strlen(text);
+  char* copy = (char*)vsdl_arena_alloc(&packet->arena, len + 1, 1);
+  if (!copy) return;
+  memcpy(copy, text, len + 1);
+  packet->textItems[packet->textCount++] = (VSDL_TextItem){copy, x, y, scale, color};
+}
 
-  VkDeviceSize bufferSize = vertexCount * sizeof(TextVertex);
-  if (ctx->textVertexBuffer) {
-      vmaDestroyBuffer(ctx->allocator, ctx->textVertexBuffer, ctx->textVertexBufferAllocation);
-  }
+// Glyphs still arriving from the rasterizer change the metrics retained quads were built from, so
+// text objects and view lines lay out again whenever the atlas has packed glyphs since their layout
+int vsdl_text_layout_stale(VSDL_Context* ctx, uint32_t atlasVersion) {
+  return atlasVersion != ctx->fontAtlas.version;
+}
 
-  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-  bufferInfo.size = bufferSize;
-  bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+void vsdl_text_push_constants(VSDL_Context* ctx, float x, float y, float scale, uint32_t color,
+                              VSDL_TextPushConstants* out) {
+  out->origin[0] = x;
+  out->origin[1] = y;
+  out->pixelToNdc[0] = 2.0f / (float)ctx->swapchainExtent.width;
+  out->pixelToNdc[1] = 2.0f / (float)ctx->swapchainExtent.height;
+  for (int c = 0; c < 4; c++) out->color[c] = (float)((color >> (8 * c)) & 0xFF) / 255.0f;
+  out->scale = scale;
+}
 
-  VmaAllocationCreateInfo allocInfo = {0};
-  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-  allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
-  if (vmaCreateBuffer(ctx->allocator, &bufferInfo, &allocInfo, &ctx->textVertexBuffer, &ctx->textVertexBufferAllocation, NULL) != VK_SUCCESS) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create text vertex buffer");
-      free(vertices);
+void vsdl_render_text(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_TextItem* item) {
+  const char* text = item->text;
+  size_t len = strlen(text);
+  // Shaped once per unique string; falls back to plain advances if the cache cannot allocate
+  const VSDL_ShapedRun* run = vsdl_shape_text(ctx, ctx->ftFace, text, len);
+  const unsigned char* glyphs = run ? run->glyphs : (const unsigned char*)text;
+  const float* penX = run ? run->penX : NULL;
+  size_t glyphCount = run ? run->glyphCount : len;
+
+  TextVertex* vertices = VSDL_FRAME_NEW(ctx, TextVertex, glyphCount * 6);
+  if (!vertices) return;
+  // Font pixels from the pen start; placement and projection are push constants
+  uint32_t vertexCount = vsdl_glyph_quads(&ctx->fontAtlas.table, glyphs, penX, glyphCount, 0.0f, 0.0f, 1.0f, 1.0f, vertices);
+  if (vertexCount == 0) return;
+
+  // Append to this frame's region of the mapped buffer; overflow grows it next frame
+  ctx->textVertexDemand += vertexCount;
+  if (!ctx->textVertices || ctx->textVertexCount + vertexCount > ctx->textVertexCapacity) {
       return;
   }
+  uint32_t firstVertex = ctx->textVertexCount;
+  memcpy(ctx->textVertices + firstVertex, vertices, vertexCount * sizeof(TextVertex));
+  ctx->textVertexCount += vertexCount;
 
-  void* data;
-  vmaMapMemory(ctx->allocator, ctx->textVertexBufferAllocation, &data);
-  memcpy(data, vertices, bufferSize);
-  vmaUnmapMemory(ctx->allocator, ctx->textVertexBufferAllocation);
-  free(vertices);
-
-  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx->textPipeline);
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline_resolve(ctx, ctx->textPipeline));
   vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx->textPipelineLayout, 0, 1, &ctx->descriptorSet, 0, NULL);
+  VSDL_TextPushConstants push;
+  vsdl_text_push_constants(ctx, item->x, item->y, item->scale, item->color, &push);
+  vkCmdPushConstants(commandBuffer, ctx->textPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(push), &push);
 
   VkBuffer vertexBuffers[] = {ctx->textVertexBuffer};
   VkDeviceSize offsets[] = {0};
   vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-  vkCmdDraw(commandBuffer, vertexCount, 1, 0, 0);
-}
\ No newline at end of file
+  vkCmdDraw(commandBuffer, vertexCount, 1, firstVertex, 0);
+}
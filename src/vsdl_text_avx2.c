@@ -0,0 +1,88 @@
+// Built with -mavx2 (or /arch:AVX2); only reached after SDL_HasAVX2() succeeds
+#include <immintrin.h>
+#include "vsdl_text_simd.h"
+#include "vsdl_types.h"
+
+#ifdef VSDL_TEXT_AVX2
+static void emit_half(float* dst, uint32_t* n, int visible,
+                      __m128 x0, __m128 x1, __m128 y0, __m128 y1, __m128 u0, __m128 u1, __m128 v0, __m128 v1) {
+  __m128 tl[4] = {x0, y0, u0, v0};
+  __m128 tr[4] = {x1, y0, u1, v0};
+  __m128 br[4] = {x1, y1, u1, v1};
+  __m128 bl[4] = {x0, y1, u0, v1};
+  _MM_TRANSPOSE4_PS(tl[0], tl[1], tl[2], tl[3]);
+  _MM_TRANSPOSE4_PS(tr[0], tr[1], tr[2], tr[3]);
+  _MM_TRANSPOSE4_PS(br[0], br[1], br[2], br[3]);
+  _MM_TRANSPOSE4_PS(bl[0], bl[1], bl[2], bl[3]);
+
+  for (int k = 0; k < 4; k++) {
+      if (!(visible & (1 << k))) continue;
+      float* v = dst + *n * 4;
+      // Two vertices per 256-bit store
+      _mm256_storeu_ps(v + 0, _mm256_insertf128_ps(_mm256_castps128_ps256(tl[k]), tr[k], 1));
+      _mm256_storeu_ps(v + 8, _mm256_insertf128_ps(_mm256_castps128_ps256(br[k]), tl[k], 1));
+      _mm256_storeu_ps(v + 16, _mm256_insertf128_ps(_mm256_castps128_ps256(br[k]), bl[k], 1));
+      *n += 6;
+  }
+}
+
+uint32_t vsdl_glyph_quads_avx2(const VSDL_GlyphTable* table, const unsigned char* text, const float* penX, size_t count,
+                               float x, float y, float sx, float sy, TextVertex* out) {
+  float* dst = (float*)out;
+  uint32_t n = 0;
+  const __m256 scaleX = _mm256_set1_ps(sx);
+  const __m256 scaleY = _mm256_set1_ps(sy);
+  const __m256 baseY = _mm256_set1_ps(y);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256i tableSize = _mm256_set1_epi32(VSDL_GLYPH_TABLE_SIZE);
+  const __m256i lastLow = _mm256_set1_epi32(3);
+  const __m256i lastHigh = _mm256_set1_epi32(7);
+  __m256 cursor = _mm256_set1_ps(x);
+
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+      // Widen 8 chars to indices; anything past the table maps to the empty entry 0
+      __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(text + i)));
+      idx = _mm256_and_si256(idx, _mm256_cmpgt_epi32(tableSize, idx));
+
+      __m256 pen;
+      if (penX) {
+          pen = _mm256_add_ps(cursor, _mm256_mul_ps(_mm256_loadu_ps(penX + i), scaleX));
+      } else {
+          __m256 advance = _mm256_mul_ps(_mm256_i32gather_ps(table->advance, idx, 4), scaleX);
+          __m256 scan = _mm256_add_ps(advance, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(advance), 4)));
+          scan = _mm256_add_ps(scan, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(scan), 8)));
+          // The shifts stay within 128-bit lanes; carry the low lane's total into the high lane
+          scan = _mm256_add_ps(scan, _mm256_blend_ps(zero, _mm256_permutevar8x32_ps(scan, lastLow), 0xF0));
+          pen = _mm256_add_ps(cursor, _mm256_sub_ps(scan, advance));
+          cursor = _mm256_add_ps(cursor, _mm256_permutevar8x32_ps(scan, lastHigh));
+      }
+
+      __m256 width = _mm256_i32gather_ps(table->width, idx, 4);
+      int visible = _mm256_movemask_ps(_mm256_cmp_ps(width, zero, _CMP_GT_OQ));
+      if (!visible) continue;
+
+      __m256 x0 = _mm256_add_ps(pen, _mm256_mul_ps(_mm256_i32gather_ps(table->bearingX, idx, 4), scaleX));
+      __m256 x1 = _mm256_add_ps(x0, _mm256_mul_ps(width, scaleX));
+      __m256 y0 = _mm256_sub_ps(baseY, _mm256_mul_ps(_mm256_i32gather_ps(table->bearingY, idx, 4), scaleY));
+      __m256 y1 = _mm256_add_ps(y0, _mm256_mul_ps(_mm256_i32gather_ps(table->height, idx, 4), scaleY));
+      __m256 u0 = _mm256_i32gather_ps(table->u0, idx, 4);
+      __m256 v0 = _mm256_i32gather_ps(table->v0, idx, 4);
+      __m256 u1 = _mm256_i32gather_ps(table->u1, idx, 4);
+      __m256 v1 = _mm256_i32gather_ps(table->v1, idx, 4);
+
+      emit_half(dst, &n, visible & 0xF,
+                _mm256_castps256_ps128(x0), _mm256_castps256_ps128(x1),
+                _mm256_castps256_ps128(y0), _mm256_castps256_ps128(y1),
+                _mm256_castps256_ps128(u0), _mm256_castps256_ps128(u1),
+                _mm256_castps256_ps128(v0), _mm256_castps256_ps128(v1));
+      emit_half(dst, &n, visible >> 4,
+                _mm256_extractf128_ps(x0, 1), _mm256_extractf128_ps(x1, 1),
+                _mm256_extractf128_ps(y0, 1), _mm256_extractf128_ps(y1, 1),
+                _mm256_extractf128_ps(u0, 1), _mm256_extractf128_ps(u1, 1),
+                _mm256_extractf128_ps(v0, 1), _mm256_extractf128_ps(v1, 1));
+  }
+  return n + vsdl_glyph_quads_scalar(table, text + i, penX ? penX + i : NULL, count - i,
+                                     _mm256_cvtss_f32(cursor), y, sx, sy, out + n);
+}
+#endif
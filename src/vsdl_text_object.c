@@ -0,0 +1,228 @@
+// #define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+// #include <volk.h>
+#include <vk_mem_alloc.h>
+#include <SDL3/SDL.h>
+#include <string.h>
+#include "vsdl_text_object.h"
+#include "vsdl_types.h"
+#include "vsdl_arena.h"
+#include "vsdl_memory.h"
+#include "vsdl_upload.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_text.h"
+#include "vsdl_shape.h"
+#include "vsdl_text_simd.h"
+#include "vsdl_idle.h"
+
+int vsdl_text_objects_init(VSDL_Context* ctx) {
+  VSDL_TextObjects* objects = &ctx->textObjects;
+  objects->lock = SDL_CreateMutex();
+  if (!objects->lock) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create text object mutex: %s", SDL_GetError());
+      return 0;
+  }
+  return 1;
+}
+
+// Table lock held
+static VSDL_TextObject* lookup_object(VSDL_TextObjects* objects, uint32_t id) {
+  uint32_t slot = VSDL_HANDLE_SLOT(id);
+  if (slot >= VSDL_MAX_TEXT_OBJECTS) return NULL;
+  VSDL_TextObject* object = &objects->objects[slot];
+  return object->text && object->generation == VSDL_HANDLE_GENERATION(id) ? object : NULL;
+}
+
+uint32_t vsdl_text_object_create(VSDL_Context* ctx, const char* text) {
+  VSDL_TextObjects* objects = &ctx->textObjects;
+  char* copy = SDL_strdup(text);
+  if (!copy) return VSDL_TEXT_OBJECT_NONE;
+
+  uint32_t id = VSDL_TEXT_OBJECT_NONE;
+  SDL_LockMutex(objects->lock);
+  for (uint32_t i = 0; i < VSDL_MAX_TEXT_OBJECTS; i++) {
+      VSDL_TextObject* object = &objects->objects[i];
+      if (object->text || object->released) continue;
+      object->text = copy;
+      object->dirty = 1;
+      if (i >= objects->count) objects->count = i + 1;
+      id = VSDL_HANDLE_MAKE(i, object->generation);
+      break;
+  }
+  SDL_UnlockMutex(objects->lock);
+
+  if (id == VSDL_TEXT_OBJECT_NONE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Text object limit reached (%u)", VSDL_MAX_TEXT_OBJECTS);
+      SDL_free(copy);
+      return id;
+  }
+  vsdl_request_redraw(ctx);
+  return id;
+}
+
+void vsdl_text_object_set_text(VSDL_Context* ctx, uint32_t id, const char* text) {
+  VSDL_TextObjects* objects = &ctx->textObjects;
+  int changed = 0;
+  SDL_LockMutex(objects->lock);
+  VSDL_TextObject* object = lookup_object(objects, id);
+  if (object && strcmp(object->text, text) != 0) {
+      char* copy = SDL_strdup(text);
+      if (copy) {
+          SDL_free(object->text);
+          object->text = copy;
+          object->dirty = 1;
+          changed = 1;
+      }
+  }
+  SDL_UnlockMutex(objects->lock);
+  if (changed) vsdl_request_redraw(ctx);
+}
+
+void vsdl_text_object_destroy(VSDL_Context* ctx, uint32_t id) {
+  VSDL_TextObjects* objects = &ctx->textObjects;
+  SDL_LockMutex(objects->lock);
+  VSDL_TextObject* object = lookup_object(objects, id);
+  if (object) {
+      SDL_free(object->text);
+      object->text = NULL;
+      object->dirty = 0;
+      object->released = 1;
+      object->generation = (object->generation + 1) & VSDL_HANDLE_GENERATION_MASK;
+  }
+  SDL_UnlockMutex(objects->lock);
+}
+
+void vsdl_draw_text_object(VSDL_Context* ctx, uint32_t id, float x, float y, float scale, uint32_t color) {
+  VSDL_FramePacket* packet = ctx->renderThread.building;
+  if (!packet || id == VSDL_TEXT_OBJECT_NONE) return;
+  if (packet->textObjectCount == packet->textObjectCapacity) {
+      uint32_t capacity = packet->textObjectCapacity ? packet->textObjectCapacity * 2 : 32;
+      VSDL_TextObjectDraw* draws = (VSDL_TextObjectDraw*)vsdl_arena_alloc(
+          &packet->arena, capacity * sizeof(VSDL_TextObjectDraw), VSDL_ALIGNOF(VSDL_TextObjectDraw));
+      if (!draws) return;
+      if (packet->textObjectCount) memcpy(draws, packet->textObjects, packet->textObjectCount * sizeof(VSDL_TextObjectDraw));
+      packet->textObjects = draws;
+      packet->textObjectCapacity = capacity;
+  }
+  packet->textObjects[packet->textObjectCount++] = (VSDL_TextObjectDraw){id, x, y, scale, color};
+}
+
+// Table lock held. Returns 0 to retry next frame, leaving the previous quads in place
+static int layout_object(VSDL_Context* ctx, VSDL_TextObject* object) {
+  size_t len = strlen(object->text);
+  const VSDL_ShapedRun* run = vsdl_shape_text(ctx, ctx->ftFace, object->text, len);
+  const unsigned char* glyphs = run ? run->glyphs : (const unsigned char*)object->text;
+  const float* penX = run ? run->penX : NULL;
+  size_t glyphCount = run ? run->glyphCount : len;
+
+  TextVertex* vertices = VSDL_FRAME_NEW(ctx, TextVertex, glyphCount * 6);
+  if (!vertices && glyphCount > 0) return 0;
+  // Pixels relative to the pen start; the draw's push constants place and scale them
+  uint32_t vertexCount = vsdl_glyph_quads(&ctx->fontAtlas.table, glyphs, penX, glyphCount, 0.0f, 0.0f, 1.0f, 1.0f, vertices);
+  if (vertexCount == 0) {
+      object->vertexCount = 0;
+      return 1;
+  }
+
+  VkDeviceSize size = (VkDeviceSize)vertexCount * sizeof(TextVertex);
+  if (vsdl_upload_available(ctx) < size + 16 || vsdl_upload_command_buffer(ctx) == VK_NULL_HANDLE) return 0;
+  // The frame wait covered every command that drew the current quads, so they can be overwritten
+  uint32_t target = object->current;
+  if (object->quads[target].size < size || vsdl_memory_move_pending(ctx, &object->quads[target])) {
+      // Movable buffers are tracked by address, so the grown one is built in the other slot; the same
+      // goes for a buffer the pending defragmentation pass is still copying
+      target ^= 1;
+      vsdl_memory_destroy_movable_buffer(ctx, &object->quads[target]);
+      if (!vsdl_memory_create_movable_buffer(ctx, VSDL_MEMORY_TAG_TEXT, size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                             &object->quads[target])) {
+          return 0;
+      }
+  }
+  if (!vsdl_upload_buffer(ctx, object->quads[target].buffer, 0, vertices, size)) return 0;
+  if (target != object->current) {
+      vsdl_memory_destroy_movable_buffer(ctx, &object->quads[object->current]);
+      object->current = target;
+  }
+  object->vertexCount = vertexCount;
+  return 1;
+}
+
+void vsdl_text_objects_update(VSDL_Context* ctx) {
+  VSDL_TextObjects* objects = &ctx->textObjects;
+  if (!objects->lock) return;
+  int uploaded = 0;
+  int retry = 0;
+  SDL_LockMutex(objects->lock);
+  for (uint32_t i = 0; i < objects->count; i++) {
+      VSDL_TextObject* object = &objects->objects[i];
+      if (object->released) {
+          vsdl_memory_destroy_movable_buffer(ctx, &object->quads[0]);
+          vsdl_memory_destroy_movable_buffer(ctx, &object->quads[1]);
+          uint32_t generation = object->generation;
+          SDL_memset(object, 0, sizeof(*object));
+          object->generation = generation;
+          continue;
+      }
+      if (!object->text || (!object->dirty && !vsdl_text_layout_stale(ctx, object->atlasVersion))) continue;
+      if (!layout_object(ctx, object)) {
+          retry = 1;
+          continue;
+      }
+      object->dirty = 0;
+      object->atlasVersion = ctx->fontAtlas.version;
+      objects->layouts++;
+      uploaded |= object->vertexCount > 0;
+  }
+  SDL_UnlockMutex(objects->lock);
+
+  if (uploaded) {
+      VkMemoryBarrier barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+      barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+      vkCmdPipelineBarrier(vsdl_upload_command_buffer(ctx), VK_PIPELINE_STAGE_TRANSFER_BIT,
+                           VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, NULL, 0, NULL);
+  }
+  if (retry) vsdl_request_redraw(ctx);
+}
+
+void vsdl_text_objects_record(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_FramePacket* packet) {
+  VSDL_TextObjects* objects = &ctx->textObjects;
+  if (ctx->textPipeline == VK_NULL_HANDLE || packet->textObjectCount == 0) return;
+
+  // Same pipeline and vertex layout as immediate text; only the vertex buffer differs
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline_resolve(ctx, ctx->textPipeline));
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx->textPipelineLayout, 0, 1,
+                          &ctx->descriptorSet, 0, NULL);
+  VSDL_TextPushConstants push;
+  // Quads and vertex counts only change in vsdl_text_objects_update, before recording starts; the
+  // lock covers ids destroyed since the draw was queued
+  SDL_LockMutex(objects->lock);
+  for (uint32_t i = 0; i < packet->textObjectCount; i++) {
+      const VSDL_TextObjectDraw* draw = &packet->textObjects[i];
+      const VSDL_TextObject* object = lookup_object(objects, draw->id);
+      if (!object || object->vertexCount == 0) continue;
+      const VSDL_MovableBuffer* quads = &object->quads[object->current];
+      if (quads->buffer == VK_NULL_HANDLE) continue;
+      vsdl_text_push_constants(ctx, draw->x, draw->y, draw->scale, draw->color, &push);
+      vkCmdPushConstants(commandBuffer, ctx->textPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(push), &push);
+      VkDeviceSize offset = 0;
+      vkCmdBindVertexBuffers(commandBuffer, 0, 1, &quads->buffer, &offset);
+      vkCmdDraw(commandBuffer, object->vertexCount, 1, 0, 0);
+  }
+  SDL_UnlockMutex(objects->lock);
+}
+
+void vsdl_text_objects_shutdown(VSDL_Context* ctx) {
+  VSDL_TextObjects* objects = &ctx->textObjects;
+  for (uint32_t i = 0; i < objects->count; i++) {
+      VSDL_TextObject* object = &objects->objects[i];
+      if (ctx->device != VK_NULL_HANDLE) {
+          vsdl_memory_destroy_movable_buffer(ctx, &object->quads[0]);
+          vsdl_memory_destroy_movable_buffer(ctx, &object->quads[1]);
+      }
+      SDL_free(object->text);
+  }
+  if (objects->count) SDL_Log("Text objects: %llu layouts", (unsigned long long)objects->layouts);
+  if (objects->lock) SDL_DestroyMutex(objects->lock);
+  SDL_memset(objects, 0, sizeof(*objects));
+}
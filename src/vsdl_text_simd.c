@@ -0,0 +1,243 @@
+#include <SDL3/SDL.h>
+#include "vsdl_text_simd.h"
+#include "vsdl_types.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VSDL_TEXT_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#define VSDL_TEXT_NEON 1
+#include <arm_neon.h>
+#endif
+
+// The SSE2 and NEON kernels store each vertex as one 4-float vector: pos.xy then texCoord.uv
+SDL_COMPILE_TIME_ASSERT(text_vertex_layout, sizeof(TextVertex) == 4 * sizeof(float));
+SDL_COMPILE_TIME_ASSERT(text_vertex_pos, offsetof(TextVertex, pos) == 0);
+SDL_COMPILE_TIME_ASSERT(text_vertex_tex_coord, offsetof(TextVertex, texCoord) == 2 * sizeof(float));
+
+static VSDL_GlyphKernel glyphKernel = vsdl_glyph_quads_scalar;
+static const char* glyphKernelName = "scalar";
+
+void vsdl_glyph_table_build(VSDL_GlyphTable* table, const FontAtlas* atlas) {
+  SDL_memset(table, 0, sizeof(*table));
+  for (uint32_t c = 32; c < VSDL_GLYPH_TABLE_SIZE; c++) {
+      const GlyphMetrics* glyph = &atlas->glyphs[c];
+      table->advance[c] = glyph->advance;
+      if (glyph->w == 0.0f || glyph->h == 0.0f) continue;
+      table->bearingX[c] = glyph->bearingX;
+      table->bearingY[c] = glyph->bearingY;
+      table->width[c] = glyph->w * atlas->width;
+      table->height[c] = glyph->h * atlas->height;
+      table->u0[c] = glyph->x;
+      table->v0[c] = glyph->y;
+      table->u1[c] = glyph->x + glyph->w;
+      table->v1[c] = glyph->y + glyph->h;
+  }
+}
+
+uint32_t vsdl_glyph_quads_scalar(const VSDL_GlyphTable* table, const unsigned char* text, const float* penX, size_t count,
+                                 float x, float y, float sx, float sy, TextVertex* out) {
+  uint32_t n = 0;
+  const float origin = x;
+  for (size_t i = 0; i < count; i++) {
+      unsigned c = text[i] < VSDL_GLYPH_TABLE_SIZE ? text[i] : 0;
+      float advance = table->advance[c] * sx;
+      if (penX) x = origin + penX[i] * sx;
+      if (table->width[c] > 0.0f) {
+          float x0 = x + table->bearingX[c] * sx;
+          float x1 = x0 + table->width[c] * sx;
+          float y0 = y - table->bearingY[c] * sy;
+          float y1 = y0 + table->height[c] * sy;
+          float u0 = table->u0[c], v0 = table->v0[c], u1 = table->u1[c], v1 = table->v1[c];
+          out[n++] = (TextVertex){{x0, y0}, {u0, v0}};
+          out[n++] = (TextVertex){{x1, y0}, {u1, v0}};
+          out[n++] = (TextVertex){{x1, y1}, {u1, v1}};
+          out[n++] = (TextVertex){{x0, y0}, {u0, v0}};
+          out[n++] = (TextVertex){{x1, y1}, {u1, v1}};
+          out[n++] = (TextVertex){{x0, y1}, {u0, v1}};
+      }
+      x += advance;
+  }
+  return n;
+}
+
+#ifdef VSDL_TEXT_SSE2
+#define GATHER4(array) _mm_set_ps((array)[idx[3]], (array)[idx[2]], (array)[idx[1]], (array)[idx[0]])
+
+static uint32_t glyph_quads_sse2(const VSDL_GlyphTable* table, const unsigned char* text, const float* penX, size_t count,
+                                 float x, float y, float sx, float sy, TextVertex* out) {
+  float* dst = (float*)out;
+  uint32_t n = 0;
+  const __m128 scaleX = _mm_set1_ps(sx);
+  const __m128 scaleY = _mm_set1_ps(sy);
+  const __m128 baseY = _mm_set1_ps(y);
+  const __m128 zero = _mm_setzero_ps();
+  __m128 cursor = _mm_set1_ps(x);
+
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+      unsigned idx[4];
+      for (int k = 0; k < 4; k++) idx[k] = text[i + k] < VSDL_GLYPH_TABLE_SIZE ? text[i + k] : 0;
+
+      __m128 pen;
+      if (penX) {
+          pen = _mm_add_ps(cursor, _mm_mul_ps(_mm_loadu_ps(penX + i), scaleX));
+      } else {
+          // Exclusive prefix sum of advances gives each glyph's pen position
+          __m128 advance = _mm_mul_ps(GATHER4(table->advance), scaleX);
+          __m128 scan = _mm_add_ps(advance, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(advance), 4)));
+          scan = _mm_add_ps(scan, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(scan), 8)));
+          pen = _mm_add_ps(cursor, _mm_sub_ps(scan, advance));
+          cursor = _mm_add_ps(cursor, _mm_shuffle_ps(scan, scan, _MM_SHUFFLE(3, 3, 3, 3)));
+      }
+
+      __m128 width = GATHER4(table->width);
+      int visible = _mm_movemask_ps(_mm_cmpgt_ps(width, zero));
+      if (!visible) continue;
+
+      __m128 x0 = _mm_add_ps(pen, _mm_mul_ps(GATHER4(table->bearingX), scaleX));
+      __m128 x1 = _mm_add_ps(x0, _mm_mul_ps(width, scaleX));
+      __m128 y0 = _mm_sub_ps(baseY, _mm_mul_ps(GATHER4(table->bearingY), scaleY));
+      __m128 y1 = _mm_add_ps(y0, _mm_mul_ps(GATHER4(table->height), scaleY));
+      __m128 u0 = GATHER4(table->u0), v0 = GATHER4(table->v0);
+      __m128 u1 = GATHER4(table->u1), v1 = GATHER4(table->v1);
+
+      // 4x4 transposes turn lanes-per-glyph into one register per vertex
+      __m128 tl[4] = {x0, y0, u0, v0};
+      __m128 tr[4] = {x1, y0, u1, v0};
+      __m128 br[4] = {x1, y1, u1, v1};
+      __m128 bl[4] = {x0, y1, u0, v1};
+      _MM_TRANSPOSE4_PS(tl[0], tl[1], tl[2], tl[3]);
+      _MM_TRANSPOSE4_PS(tr[0], tr[1], tr[2], tr[3]);
+      _MM_TRANSPOSE4_PS(br[0], br[1], br[2], br[3]);
+      _MM_TRANSPOSE4_PS(bl[0], bl[1], bl[2], bl[3]);
+
+      for (int k = 0; k < 4; k++) {
+          if (!(visible & (1 << k))) continue;
+          float* v = dst + n * 4;
+          _mm_storeu_ps(v + 0, tl[k]);
+          _mm_storeu_ps(v + 4, tr[k]);
+          _mm_storeu_ps(v + 8, br[k]);
+          _mm_storeu_ps(v + 12, tl[k]);
+          _mm_storeu_ps(v + 16, br[k]);
+          _mm_storeu_ps(v + 20, bl[k]);
+          n += 6;
+      }
+  }
+  return n + vsdl_glyph_quads_scalar(table, text + i, penX ? penX + i : NULL, count - i,
+                                     _mm_cvtss_f32(cursor), y, sx, sy, out + n);
+}
+#undef GATHER4
+#endif
+
+#ifdef VSDL_TEXT_NEON
+static uint32_t glyph_quads_neon(const VSDL_GlyphTable* table, const unsigned char* text, const float* penX, size_t count,
+                                 float x, float y, float sx, float sy, TextVertex* out) {
+  float* dst = (float*)out;
+  uint32_t n = 0;
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  const float32x4_t baseY = vdupq_n_f32(y);
+  float32x4_t cursor = vdupq_n_f32(x);
+
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+      float lanes[9][4];
+      for (int k = 0; k < 4; k++) {
+          unsigned c = text[i + k] < VSDL_GLYPH_TABLE_SIZE ? text[i + k] : 0;
+          lanes[0][k] = table->advance[c];
+          lanes[1][k] = table->width[c];
+          lanes[2][k] = table->bearingX[c];
+          lanes[3][k] = table->bearingY[c];
+          lanes[4][k] = table->height[c];
+          lanes[5][k] = table->u0[c];
+          lanes[6][k] = table->v0[c];
+          lanes[7][k] = table->u1[c];
+          lanes[8][k] = table->v1[c];
+      }
+
+      float32x4_t pen;
+      if (penX) {
+          pen = vmlaq_n_f32(cursor, vld1q_f32(penX + i), sx);
+      } else {
+          float32x4_t advance = vmulq_n_f32(vld1q_f32(lanes[0]), sx);
+          float32x4_t scan = vaddq_f32(advance, vextq_f32(zero, advance, 3));
+          scan = vaddq_f32(scan, vextq_f32(zero, scan, 2));
+          pen = vaddq_f32(cursor, vsubq_f32(scan, advance));
+          cursor = vaddq_f32(cursor, vdupq_n_f32(vgetq_lane_f32(scan, 3)));
+      }
+
+      float32x4_t width = vld1q_f32(lanes[1]);
+      uint32_t visible[4];
+      vst1q_u32(visible, vcgtq_f32(width, zero));
+      if (!(visible[0] | visible[1] | visible[2] | visible[3])) continue;
+
+      float32x4_t x0 = vmlaq_n_f32(pen, vld1q_f32(lanes[2]), sx);
+      float32x4_t x1 = vmlaq_n_f32(x0, width, sx);
+      float32x4_t y0 = vmlsq_n_f32(baseY, vld1q_f32(lanes[3]), sy);
+      float32x4_t y1 = vmlaq_n_f32(y0, vld1q_f32(lanes[4]), sy);
+      float32x4_t u0 = vld1q_f32(lanes[5]), v0 = vld1q_f32(lanes[6]);
+      float32x4_t u1 = vld1q_f32(lanes[7]), v1 = vld1q_f32(lanes[8]);
+
+      // vst4q interleaves lanes, which is the 4x4 transpose into one vertex per glyph
+      float corners[4][16];
+      float32x4x4_t tl = {{x0, y0, u0, v0}};
+      float32x4x4_t tr = {{x1, y0, u1, v0}};
+      float32x4x4_t br = {{x1, y1, u1, v1}};
+      float32x4x4_t bl = {{x0, y1, u0, v1}};
+      vst4q_f32(corners[0], tl);
+      vst4q_f32(corners[1], tr);
+      vst4q_f32(corners[2], br);
+      vst4q_f32(corners[3], bl);
+
+      for (int k = 0; k < 4; k++) {
+          if (!visible[k]) continue;
+          float* v = dst + n * 4;
+          vst1q_f32(v + 0, vld1q_f32(&corners[0][k * 4]));
+          vst1q_f32(v + 4, vld1q_f32(&corners[1][k * 4]));
+          vst1q_f32(v + 8, vld1q_f32(&corners[2][k * 4]));
+          vst1q_f32(v + 12, vld1q_f32(&corners[0][k * 4]));
+          vst1q_f32(v + 16, vld1q_f32(&corners[2][k * 4]));
+          vst1q_f32(v + 20, vld1q_f32(&corners[3][k * 4]));
+          n += 6;
+      }
+  }
+  return n + vsdl_glyph_quads_scalar(table, text + i, penX ? penX + i : NULL, count - i,
+                                     vgetq_lane_f32(cursor, 0), y, sx, sy, out + n);
+}
+#endif
+
+void vsdl_text_simd_init(void) {
+#ifdef VSDL_TEXT_AVX2
+  if (SDL_HasAVX2()) {
+      glyphKernel = vsdl_glyph_quads_avx2;
+      glyphKernelName = "AVX2";
+      return;
+  }
+#endif
+#ifdef VSDL_TEXT_SSE2
+  if (SDL_HasSSE2()) {
+      glyphKernel = glyph_quads_sse2;
+      glyphKernelName = "SSE2";
+      return;
+  }
+#endif
+#ifdef VSDL_TEXT_NEON
+  if (SDL_HasNEON()) {
+      glyphKernel = glyph_quads_neon;
+      glyphKernelName = "NEON";
+      return;
+  }
+#endif
+  glyphKernel = vsdl_glyph_quads_scalar;
+  glyphKernelName = "scalar";
+}
+
+const char* vsdl_text_simd_name(void) {
+  return glyphKernelName;
+}
+
+uint32_t vsdl_glyph_quads(const VSDL_GlyphTable* table, const unsigned char* text, const float* penX, size_t count,
+                          float x, float y, float sx, float sy, TextVertex* out) {
+  return glyphKernel(table, text, penX, count, x, y, sx, sy, out);
+}
@@ -0,0 +1,368 @@
+// #define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+// #include <volk.h>
+#include <SDL3/SDL.h>
+#include <string.h>
+#include "vsdl_text_view.h"
+#include "vsdl_types.h"
+#include "vsdl_arena.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_shape.h"
+#include "vsdl_text.h"
+#include "vsdl_text_simd.h"
+#include "vsdl_idle.h"
+
+int vsdl_text_views_init(VSDL_Context* ctx) {
+  VSDL_TextViews* views = &ctx->textViews;
+  views->lock = SDL_CreateMutex();
+  if (!views->lock) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create text view mutex: %s", SDL_GetError());
+      return 0;
+  }
+  // 26.6 fixed point
+  views->lineHeight = (float)ctx->ftFace->size->metrics.height / 64.0f;
+  views->ascender = (float)ctx->ftFace->size->metrics.ascender / 64.0f;
+  return 1;
+}
+
+static VSDL_TextView* lookup_view(VSDL_TextViews* views, uint32_t id) {
+  uint32_t slot = VSDL_HANDLE_SLOT(id);
+  if (slot >= VSDL_MAX_TEXT_VIEWS) return NULL;
+  VSDL_TextView* view = &views->views[slot];
+  return view->used && !view->released && view->generation == VSDL_HANDLE_GENERATION(id) ? view : NULL;
+}
+
+static VSDL_TextLine* get_line(VSDL_TextView* view, uint64_t line) {
+  return &view->pages[line / VSDL_TEXT_VIEW_PAGE_LINES][line % VSDL_TEXT_VIEW_PAGE_LINES];
+}
+
+// Chunks are never resized, so line records can point into them. A line that does not fit
+// starts a new chunk, doubled until it has room to grow in place
+static char* reserve_bytes(VSDL_TextView* view, uint32_t size) {
+  if (view->chunkCount > 0 && view->chunkSize - view->chunkUsed >= size) {
+      char* bytes = view->chunks[view->chunkCount - 1] + view->chunkUsed;
+      view->chunkUsed += size;
+      return bytes;
+  }
+  if (view->chunkCount == view->chunkCapacity) {
+      uint32_t capacity = view->chunkCapacity ? view->chunkCapacity * 2 : 16;
+      char** chunks = (char**)SDL_realloc(view->chunks, capacity * sizeof(char*));
+      if (!chunks) return NULL;
+      view->chunks = chunks;
+      view->chunkCapacity = capacity;
+  }
+  uint32_t chunkSize = VSDL_TEXT_VIEW_CHUNK_BYTES;
+  while (chunkSize < size) chunkSize *= 2;
+  char* chunk = (char*)SDL_malloc(chunkSize);
+  if (!chunk) return NULL;
+  view->chunks[view->chunkCount++] = chunk;
+  view->chunkSize = chunkSize;
+  view->chunkUsed = size;
+  return chunk;
+}
+
+static VSDL_TextLine* push_line(VSDL_TextView* view) {
+  uint64_t page = view->lineCount / VSDL_TEXT_VIEW_PAGE_LINES;
+  if (page == view->pageCount) {
+      if (view->pageCount == view->pageCapacity) {
+          uint32_t capacity = view->pageCapacity ? view->pageCapacity * 2 : 16;
+          VSDL_TextLine** pages = (VSDL_TextLine**)SDL_realloc(view->pages, capacity * sizeof(VSDL_TextLine*));
+          if (!pages) return NULL;
+          view->pages = pages;
+          view->pageCapacity = capacity;
+      }
+      VSDL_TextLine* lines = (VSDL_TextLine*)SDL_malloc(VSDL_TEXT_VIEW_PAGE_LINES * sizeof(VSDL_TextLine));
+      if (!lines) return NULL;
+      view->pages[view->pageCount++] = lines;
+  }
+  VSDL_TextLine* line = get_line(view, view->lineCount++);
+  line->text = NULL;
+  line->length = 0;
+  return line;
+}
+
+// Grows the last line in place while its bytes end the last chunk; otherwise it moves to a new
+// region and the old bytes stay behind until the view is freed
+static int extend_line(VSDL_TextView* view, VSDL_TextLine* line, const char* text, uint32_t length) {
+  if (length == 0) return 1;
+  if (line->length > 0 && view->chunkCount > 0 &&
+      line->text + line->length == view->chunks[view->chunkCount - 1] + view->chunkUsed &&
+      view->chunkSize - view->chunkUsed >= length) {
+      memcpy(view->chunks[view->chunkCount - 1] + view->chunkUsed, text, length);
+      view->chunkUsed += length;
+      line->length += length;
+      return 1;
+  }
+  char* bytes = reserve_bytes(view, line->length + length);
+  if (!bytes) return 0;
+  if (line->length) memcpy(bytes, line->text, line->length);
+  memcpy(bytes + line->length, text, length);
+  line->text = bytes;
+  line->length += length;
+  return 1;
+}
+
+uint32_t vsdl_text_view_create(VSDL_Context* ctx) {
+  VSDL_TextViews* views = &ctx->textViews;
+  uint32_t id = VSDL_TEXT_VIEW_NONE;
+  SDL_LockMutex(views->lock);
+  for (uint32_t i = 0; i < VSDL_MAX_TEXT_VIEWS; i++) {
+      VSDL_TextView* view = &views->views[i];
+      if (view->used || view->released) continue;
+      view->used = 1;
+      view->follow = 1;
+      if (i >= views->count) views->count = i + 1;
+      id = VSDL_HANDLE_MAKE(i, view->generation);
+      break;
+  }
+  SDL_UnlockMutex(views->lock);
+
+  if (id == VSDL_TEXT_VIEW_NONE) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Text view limit reached (%u)", VSDL_MAX_TEXT_VIEWS);
+  }
+  return id;
+}
+
+void vsdl_text_view_append(VSDL_Context* ctx, uint32_t id, const char* text, size_t length) {
+  VSDL_TextViews* views = &ctx->textViews;
+  int failed = 0;
+  SDL_LockMutex(views->lock);
+  VSDL_TextView* view = lookup_view(views, id);
+  size_t start = 0;
+  while (view && start < length) {
+      const char* newline = (const char*)memchr(text + start, '\n', length - start);
+      size_t end = newline ? (size_t)(newline - text) : length;
+      size_t segment = end - start;
+      // CRLF logs
+      if (newline && segment > 0 && text[end - 1] == '\r') segment--;
+      VSDL_TextLine* line = view->lineOpen ? get_line(view, view->lineCount - 1) : push_line(view);
+      if (!line || !extend_line(view, line, text + start, (uint32_t)segment)) {
+          failed = 1;
+          break;
+      }
+      // The '\r' came with an earlier append and the '\n' with this one
+      if (newline && segment == 0 && line->length > 0 && line->text[line->length - 1] == '\r') line->length--;
+      view->lineOpen = newline == NULL;
+      start = end + 1;
+  }
+  SDL_UnlockMutex(views->lock);
+
+  if (failed) SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Text view %u: out of memory, append truncated", id);
+  if (view) vsdl_request_redraw(ctx);
+}
+
+void vsdl_text_view_scroll(VSDL_Context* ctx, uint32_t id, int64_t lines) {
+  VSDL_TextViews* views = &ctx->textViews;
+  SDL_LockMutex(views->lock);
+  VSDL_TextView* view = lookup_view(views, id);
+  if (view) {
+      // Scrolling away from the tail starts from where it was last shown
+      uint64_t first = view->follow ? view->shownFirst : view->firstLine;
+      if (lines < 0) {
+          uint64_t up = (uint64_t)0 - (uint64_t)lines;
+          first = up > first ? 0 : first - up;
+      } else {
+          first += (uint64_t)lines;
+      }
+      if (view->lineCount > 0 && first >= view->lineCount) first = view->lineCount - 1;
+      view->firstLine = first;
+      view->follow = 0;
+  }
+  SDL_UnlockMutex(views->lock);
+  if (view) vsdl_request_redraw(ctx);
+}
+
+void vsdl_text_view_follow(VSDL_Context* ctx, uint32_t id) {
+  VSDL_TextViews* views = &ctx->textViews;
+  SDL_LockMutex(views->lock);
+  VSDL_TextView* view = lookup_view(views, id);
+  if (view) view->follow = 1;
+  SDL_UnlockMutex(views->lock);
+  if (view) vsdl_request_redraw(ctx);
+}
+
+void vsdl_text_view_destroy(VSDL_Context* ctx, uint32_t id) {
+  VSDL_TextViews* views = &ctx->textViews;
+  SDL_LockMutex(views->lock);
+  VSDL_TextView* view = lookup_view(views, id);
+  if (view) {
+      view->released = 1;
+      view->generation = (view->generation + 1) & VSDL_HANDLE_GENERATION_MASK;
+  }
+  SDL_UnlockMutex(views->lock);
+}
+
+void vsdl_draw_text_view(VSDL_Context* ctx, uint32_t id, float x, float y, float width, float height, float scale,
+                         uint32_t color) {
+  VSDL_FramePacket* packet = ctx->renderThread.building;
+  if (!packet || id == VSDL_TEXT_VIEW_NONE) return;
+  if (packet->textViewCount == packet->textViewCapacity) {
+      uint32_t capacity = packet->textViewCapacity ? packet->textViewCapacity * 2 : 8;
+      VSDL_TextViewDraw* draws = (VSDL_TextViewDraw*)vsdl_arena_alloc(
+          &packet->arena, capacity * sizeof(VSDL_TextViewDraw), VSDL_ALIGNOF(VSDL_TextViewDraw));
+      if (!draws) return;
+      if (packet->textViewCount) memcpy(draws, packet->textViews, packet->textViewCount * sizeof(VSDL_TextViewDraw));
+      packet->textViews = draws;
+      packet->textViewCapacity = capacity;
+  }
+  packet->textViews[packet->textViewCount++] = (VSDL_TextViewDraw){id, x, y, width, height, scale, color};
+}
+
+static void free_view(VSDL_TextView* view) {
+  for (uint32_t i = 0; i < view->chunkCount; i++) SDL_free(view->chunks[i]);
+  SDL_free(view->chunks);
+  for (uint32_t i = 0; i < view->pageCount; i++) SDL_free(view->pages[i]);
+  SDL_free(view->pages);
+  if (view->cache) {
+      for (uint32_t i = 0; i < VSDL_TEXT_VIEW_CACHE_LINES; i++) SDL_free(view->cache[i].vertices);
+      SDL_free(view->cache);
+  }
+  uint32_t generation = view->generation;
+  SDL_memset(view, 0, sizeof(*view));
+  view->generation = generation;
+}
+
+void vsdl_text_views_update(VSDL_Context* ctx) {
+  VSDL_TextViews* views = &ctx->textViews;
+  if (!views->lock) return;
+  SDL_LockMutex(views->lock);
+  for (uint32_t i = 0; i < views->count; i++) {
+      if (views->views[i].released) free_view(&views->views[i]);
+  }
+  SDL_UnlockMutex(views->lock);
+}
+
+// Pixels from the line's pen start; the entry keeps its vertex storage when it is recycled
+static int layout_line(VSDL_Context* ctx, VSDL_TextViewLine* entry, const char* text, uint32_t length) {
+  entry->vertexCount = 0;
+  if (length == 0) return 1;
+  const VSDL_ShapedRun* run = vsdl_shape_text(ctx, ctx->ftFace, text, length);
+  const unsigned char* glyphs = run ? run->glyphs : (const unsigned char*)text;
+  const float* penX = run ? run->penX : NULL;
+  size_t glyphCount = run ? run->glyphCount : length;
+
+  uint32_t needed = (uint32_t)glyphCount * 6;
+  if (needed > entry->vertexCapacity) {
+      TextVertex* vertices = (TextVertex*)SDL_realloc(entry->vertices, needed * sizeof(TextVertex));
+      if (!vertices) return 0;
+      entry->vertices = vertices;
+      entry->vertexCapacity = needed;
+  }
+  entry->vertexCount = vsdl_glyph_quads(&ctx->fontAtlas.table, glyphs, penX, glyphCount, 0.0f, 0.0f, 1.0f, 1.0f,
+                                        entry->vertices);
+  return 1;
+}
+
+// Table lock held. Lays out visible lines missing from the cache, then copies them into this
+// frame's text vertices, each moved down to its row. Returns the vertex count
+static uint32_t emit_visible(VSDL_Context* ctx, VSDL_TextView* view, const VSDL_TextViewDraw* draw) {
+  VSDL_TextViews* views = &ctx->textViews;
+  if (!view->cache) {
+      view->cache = (VSDL_TextViewLine*)SDL_calloc(VSDL_TEXT_VIEW_CACHE_LINES, sizeof(VSDL_TextViewLine));
+      if (!view->cache) return 0;
+      for (uint32_t i = 0; i < VSDL_TEXT_VIEW_CACHE_LINES; i++) view->cache[i].line = UINT64_MAX;
+  }
+
+  // Whole rows decide the tail position; one more row shows the partly visible line below. Rows
+  // past the cache are left empty at the bottom, so following still ends on the newest line
+  uint64_t rows = (uint64_t)(draw->height / (views->lineHeight * draw->scale));
+  if (rows > VSDL_TEXT_VIEW_CACHE_LINES - 1) rows = VSDL_TEXT_VIEW_CACHE_LINES - 1;
+  uint64_t visible = rows + 1;
+  uint64_t first;
+  if (view->follow) {
+      first = view->lineCount > rows ? view->lineCount - rows : 0;
+  } else {
+      first = view->firstLine < view->lineCount ? view->firstLine : (view->lineCount ? view->lineCount - 1 : 0);
+  }
+  view->shownFirst = first;
+  uint64_t last = first + visible < view->lineCount ? first + visible : view->lineCount;
+
+  // Visible lines are consecutive and fewer than the cache entries, so they never share one
+  uint32_t total = 0;
+  for (uint64_t line = first; line < last; line++) {
+      VSDL_TextViewLine* entry = &view->cache[line & (VSDL_TEXT_VIEW_CACHE_LINES - 1)];
+      const VSDL_TextLine* text = get_line(view, line);
+      uint32_t length = text->length < VSDL_TEXT_VIEW_MAX_COLUMNS ? text->length : VSDL_TEXT_VIEW_MAX_COLUMNS;
+      if (entry->line != line || entry->length != length || vsdl_text_layout_stale(ctx, entry->atlasVersion)) {
+          if (!layout_line(ctx, entry, text->text, length)) {
+              entry->line = UINT64_MAX;
+              continue;
+          }
+          entry->line = line;
+          entry->length = length;
+          entry->atlasVersion = ctx->fontAtlas.version;
+          views->layouts++;
+      }
+      total += entry->vertexCount;
+  }
+
+  // Same ring as immediate text; overflow grows it next frame
+  ctx->textVertexDemand += total;
+  if (total == 0 || !ctx->textVertices || ctx->textVertexCount + total > ctx->textVertexCapacity) return 0;
+  // Mapped memory: write each vertex whole, never read it back
+  TextVertex* out = ctx->textVertices + ctx->textVertexCount;
+  uint32_t n = 0;
+  for (uint64_t line = first; line < last; line++) {
+      const VSDL_TextViewLine* entry = &view->cache[line & (VSDL_TEXT_VIEW_CACHE_LINES - 1)];
+      if (entry->line != line) continue;
+      float baseline = (float)(line - first) * views->lineHeight + views->ascender;
+      for (uint32_t v = 0; v < entry->vertexCount; v++) {
+          TextVertex vertex = entry->vertices[v];
+          vertex.pos[1] += baseline;
+          out[n++] = vertex;
+      }
+  }
+  ctx->textVertexCount += n;
+  return n;
+}
+
+void vsdl_text_views_record(VSDL_Context* ctx, VkCommandBuffer commandBuffer, const VSDL_FramePacket* packet) {
+  VSDL_TextViews* views = &ctx->textViews;
+  if (ctx->textPipeline == VK_NULL_HANDLE || packet->textViewCount == 0 || views->lineHeight <= 0.0f) return;
+
+  int bound = 0;
+  for (uint32_t i = 0; i < packet->textViewCount; i++) {
+      const VSDL_TextViewDraw* draw = &packet->textViews[i];
+      if (draw->scale <= 0.0f) continue;
+      // Rows past the viewport edges are cut by the scissor
+      float x0 = SDL_max(draw->x, 0.0f);
+      float y0 = SDL_max(draw->y, 0.0f);
+      float x1 = SDL_min(draw->x + draw->width, (float)ctx->swapchainExtent.width);
+      float y1 = SDL_min(draw->y + draw->height, (float)ctx->swapchainExtent.height);
+      if (x1 <= x0 || y1 <= y0) continue;
+
+      SDL_LockMutex(views->lock);
+      VSDL_TextView* view = lookup_view(views, draw->id);
+      uint32_t firstVertex = ctx->textVertexCount;
+      uint32_t vertexCount = view ? emit_visible(ctx, view, draw) : 0;
+      SDL_UnlockMutex(views->lock);
+      if (vertexCount == 0) continue;
+
+      if (!bound) {
+          vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline_resolve(ctx, ctx->textPipeline));
+          vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx->textPipelineLayout, 0, 1,
+                                  &ctx->descriptorSet, 0, NULL);
+          VkDeviceSize offset = 0;
+          vkCmdBindVertexBuffers(commandBuffer, 0, 1, &ctx->textVertexBuffer, &offset);
+          bound = 1;
+      }
+      VkRect2D scissor = {{(int32_t)x0, (int32_t)y0}, {(uint32_t)(x1 - x0), (uint32_t)(y1 - y0)}};
+      vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+      VSDL_TextPushConstants push;
+      vsdl_text_push_constants(ctx, draw->x, draw->y, draw->scale, draw->color, &push);
+      vkCmdPushConstants(commandBuffer, ctx->textPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(push), &push);
+      vkCmdDraw(commandBuffer, vertexCount, 1, firstVertex, 0);
+  }
+  if (bound) {
+      VkRect2D scissor = {{0, 0}, ctx->swapchainExtent};
+      vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+  }
+}
+
+void vsdl_text_views_shutdown(VSDL_Context* ctx) {
+  VSDL_TextViews* views = &ctx->textViews;
+  for (uint32_t i = 0; i < views->count; i++) free_view(&views->views[i]);
+  if (views->count) SDL_Log("Text views: %llu line layouts", (unsigned long long)views->layouts);
+  if (views->lock) SDL_DestroyMutex(views->lock);
+  SDL_memset(views, 0, sizeof(*views));
+}
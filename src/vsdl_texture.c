@@ -0,0 +1,358 @@
+// #define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+// #include <volk.h>
+#include <vk_mem_alloc.h>
+#include <SDL3/SDL.h>
+#include <stb_image.h>
+#include "vsdl_texture.h"
+#include "vsdl_pack.h"
+#include "vsdl_memory.h"
+#include "vsdl_types.h"
+#include "vsdl_upload.h"
+#include "vsdl_workers.h"
+#include "vsdl_idle.h"
+#include "vsdl_bindless.h"
+#include "vsdl_descriptor.h"
+#include "vsdl_sync.h"
+
+static uint32_t mip_count(uint32_t width, uint32_t height) {
+  uint32_t levels = 1;
+  while ((width | height) >> levels) levels++;
+  return levels;
+}
+
+// 2x2 box filter, clamping at odd edges
+static unsigned char* downsample(const unsigned char* src, uint32_t width, uint32_t height, uint32_t* outWidth, uint32_t* outHeight) {
+  uint32_t dw = width > 1 ? width / 2 : 1;
+  uint32_t dh = height > 1 ? height / 2 : 1;
+  unsigned char* dst = (unsigned char*)SDL_malloc((size_t)dw * dh * 4);
+  if (!dst) return NULL;
+
+  for (uint32_t y = 0; y < dh; y++) {
+      uint32_t y0 = SDL_min(y * 2, height - 1);
+      uint32_t y1 = SDL_min(y * 2 + 1, height - 1);
+      for (uint32_t x = 0; x < dw; x++) {
+          uint32_t x0 = SDL_min(x * 2, width - 1);
+          uint32_t x1 = SDL_min(x * 2 + 1, width - 1);
+          for (uint32_t c = 0; c < 4; c++) {
+              uint32_t sum = src[(y0 * width + x0) * 4 + c] + src[(y0 * width + x1) * 4 + c] +
+                             src[(y1 * width + x0) * 4 + c] + src[(y1 * width + x1) * 4 + c];
+              dst[(y * dw + x) * 4 + c] = (unsigned char)((sum + 2) >> 2);
+          }
+      }
+  }
+  *outWidth = dw;
+  *outHeight = dh;
+  return dst;
+}
+
+// Level 0 belongs to stb_image, the box-filtered levels to SDL
+static void free_level(VSDL_Texture* texture, uint32_t level) {
+  if (!texture->levels[level]) return;
+  if (level == 0) {
+      stbi_image_free(texture->levels[0]);
+  } else {
+      SDL_free(texture->levels[level]);
+  }
+  texture->levels[level] = NULL;
+}
+
+static void free_levels(VSDL_Texture* texture) {
+  for (uint32_t level = 0; level < VSDL_TEXTURE_MAX_LEVELS; level++) free_level(texture, level);
+}
+
+// Worker: decode to RGBA8 and build the mips down to the low-resolution preview
+static void decode_texture(void* data) {
+  VSDL_Texture* texture = (VSDL_Texture*)data;
+  VSDL_Asset asset;
+  if (!vsdl_asset_load_from(texture->pack, texture->path, &asset)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to read texture %s", texture->path);
+      SDL_SetAtomicInt(&texture->state, VSDL_TEXTURE_FAILED);
+      return;
+  }
+  int width, height, channels;
+  unsigned char* pixels = stbi_load_from_memory((const stbi_uc*)asset.data, (int)asset.size, &width, &height, &channels, 4);
+  vsdl_asset_release(&asset);
+  if (!pixels) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to decode texture %s: %s", texture->path, stbi_failure_reason());
+      SDL_SetAtomicInt(&texture->state, VSDL_TEXTURE_FAILED);
+      return;
+  }
+
+  texture->width = (uint32_t)width;
+  texture->height = (uint32_t)height;
+  texture->mipLevels = mip_count(texture->width, texture->height);
+  texture->previewLevel = 0;
+  texture->levels[0] = pixels;
+
+  // Every level down to the preview is kept, so the finer ones can stream in coarse to fine
+  uint32_t w = texture->width, h = texture->height;
+  while (SDL_max(w, h) > VSDL_TEXTURE_PREVIEW_SIZE) {
+      uint32_t dw, dh;
+      unsigned char* dst = downsample(texture->levels[texture->previewLevel], w, h, &dw, &dh);
+      if (!dst) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate texture preview for %s", texture->path);
+          free_levels(texture);
+          SDL_SetAtomicInt(&texture->state, VSDL_TEXTURE_FAILED);
+          return;
+      }
+      w = dw;
+      h = dh;
+      texture->levels[++texture->previewLevel] = dst;
+  }
+  texture->streamLevel = texture->previewLevel > 0 ? texture->previewLevel - 1 : 0;
+
+  SDL_SetAtomicInt(&texture->state, VSDL_TEXTURE_DECODED);
+  vsdl_idle_wake();
+}
+
+// Level `first` holds data in TRANSFER_DST; blits it down through end - 1 and leaves [first, end) in SHADER_READ_ONLY
+static void generate_mips(VkCommandBuffer cmd, VSDL_Texture* texture, uint32_t first, uint32_t end) {
+  int32_t width = (int32_t)SDL_max(texture->width >> first, 1u);
+  int32_t height = (int32_t)SDL_max(texture->height >> first, 1u);
+
+  for (uint32_t level = first + 1; level < end; level++) {
+      int32_t nextWidth = width > 1 ? width / 2 : 1;
+      int32_t nextHeight = height > 1 ? height / 2 : 1;
+
+      vsdl_cmd_image_barrier(cmd, texture->image, level - 1, 1,
+                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                             VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+      VkImageBlit blit = {0};
+      blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      blit.srcSubresource.mipLevel = level - 1;
+      blit.srcSubresource.layerCount = 1;
+      blit.srcOffsets[1] = (VkOffset3D){width, height, 1};
+      blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      blit.dstSubresource.mipLevel = level;
+      blit.dstSubresource.layerCount = 1;
+      blit.dstOffsets[1] = (VkOffset3D){nextWidth, nextHeight, 1};
+      vkCmdBlitImage(cmd, texture->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                     texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+      vsdl_cmd_image_barrier(cmd, texture->image, level - 1, 1,
+                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                             VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+      width = nextWidth;
+      height = nextHeight;
+  }
+
+  vsdl_cmd_image_barrier(cmd, texture->image, end - 1, 1,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                         VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+}
+
+// The previous view may still be in use by submitted frames, so its destruction is deferred
+static int update_view(VSDL_Context* ctx, VSDL_Texture* texture, uint32_t baseLevel) {
+  VkImageViewCreateInfo viewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+  viewInfo.image = texture->image;
+  viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+  viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+  viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  viewInfo.subresourceRange.baseMipLevel = baseLevel;
+  viewInfo.subresourceRange.levelCount = texture->mipLevels - baseLevel;
+  viewInfo.subresourceRange.baseArrayLayer = 0;
+  viewInfo.subresourceRange.layerCount = 1;
+
+  VkImageView view;
+  if (vkCreateImageView(ctx->device, &viewInfo, NULL, &view) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create texture view for %s", texture->path);
+      return 0;
+  }
+  if (texture->view != VK_NULL_HANDLE) {
+      vsdl_descriptor_forget_view(ctx, texture->view);
+      vsdl_sync_defer_image_view(ctx, texture->view);
+  }
+  texture->view = view;
+  texture->residentLevel = baseLevel;
+  texture->version++;
+  // Same slot for every view, so instances recorded with it stay valid as mips stream in
+  if (texture->bindlessSlot == VSDL_BINDLESS_NONE) {
+      texture->bindlessSlot = vsdl_bindless_register(ctx, view);
+  } else {
+      vsdl_bindless_update(ctx, texture->bindlessSlot, view);
+  }
+  return 1;
+}
+
+static int start_texture(VSDL_Context* ctx, VSDL_Texture* texture, VkDeviceSize* budget) {
+  VkDeviceSize previewBytes = 0;
+  if (texture->previewLevel > 0) {
+      uint32_t pw = SDL_max(texture->width >> texture->previewLevel, 1u);
+      uint32_t ph = SDL_max(texture->height >> texture->previewLevel, 1u);
+      previewBytes = (VkDeviceSize)pw * ph * 4;
+      if (vsdl_upload_available(ctx) < previewBytes + 16) return 0;  // Retry next frame
+  }
+
+  VkCommandBuffer cmd = vsdl_upload_command_buffer(ctx);
+  if (cmd == VK_NULL_HANDLE) return 0;  // Retry next frame
+
+  // Kept across retries: the batch that recorded its layout transition may already be submitted
+  if (texture->image == VK_NULL_HANDLE) {
+      VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+      imageInfo.imageType = VK_IMAGE_TYPE_2D;
+      imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+      imageInfo.extent.width = texture->width;
+      imageInfo.extent.height = texture->height;
+      imageInfo.extent.depth = 1;
+      imageInfo.mipLevels = texture->mipLevels;
+      imageInfo.arrayLayers = 1;
+      imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+      imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+      imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+      imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+      imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+      VmaAllocationCreateInfo allocInfo = {0};
+      allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+      if (!vsdl_memory_create_image(ctx, VSDL_MEMORY_TAG_TEXTURE, &imageInfo, &allocInfo, &texture->image, &texture->allocation, NULL)) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create image for texture %s", texture->path);
+          SDL_SetAtomicInt(&texture->state, VSDL_TEXTURE_FAILED);
+          return 0;
+      }
+
+      vsdl_cmd_image_barrier(cmd, texture->image, 0, texture->mipLevels,
+                             VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                             0, VK_ACCESS_TRANSFER_WRITE_BIT,
+                             VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+      texture->residentLevel = texture->mipLevels;  // Nothing visible yet
+      texture->streamedRows = 0;
+  }
+
+  if (texture->previewLevel > 0) {
+      uint32_t pw = SDL_max(texture->width >> texture->previewLevel, 1u);
+      uint32_t ph = SDL_max(texture->height >> texture->previewLevel, 1u);
+      if (!vsdl_upload_image(ctx, texture->image, texture->previewLevel, 0, pw, ph, texture->levels[texture->previewLevel], 4)) {
+          return 0;  // Retry next frame, like a full upload batch
+      }
+      generate_mips(cmd, texture, texture->previewLevel, texture->mipLevels);
+      update_view(ctx, texture, texture->previewLevel);
+      free_level(texture, texture->previewLevel);
+      *budget -= SDL_min(*budget, previewBytes);
+  }
+
+  SDL_SetAtomicInt(&texture->state, VSDL_TEXTURE_STREAMING);
+  return 1;
+}
+
+static void stream_rows(VSDL_Context* ctx, VSDL_Texture* texture, VkDeviceSize* budget) {
+  uint32_t level = texture->streamLevel;
+  uint32_t width = SDL_max(texture->width >> level, 1u);
+  uint32_t height = SDL_max(texture->height >> level, 1u);
+  VkDeviceSize rowBytes = (VkDeviceSize)width * 4;
+  VkDeviceSize available = vsdl_upload_available(ctx);
+  available = available > 16 ? available - 16 : 0;
+
+  uint32_t rows = (uint32_t)(SDL_min(*budget, available) / rowBytes);
+  if (rows == 0 && *budget > 0 && available >= rowBytes) rows = 1;  // Always make progress on wide images
+  rows = SDL_min(rows, height - texture->streamedRows);
+  if (rows == 0) return;
+
+  if (!vsdl_upload_image(ctx, texture->image, level, texture->streamedRows, width, rows,
+                         texture->levels[level] + texture->streamedRows * rowBytes, 4)) {
+      return;
+  }
+  texture->streamedRows += rows;
+  *budget -= SDL_min(*budget, rows * rowBytes);
+  if (texture->streamedRows < height) return;
+
+  // Coarser levels are resident already unless there was no preview, in which case they are blitted from this one
+  uint32_t end = texture->previewLevel > 0 ? level + 1 : texture->mipLevels;
+  generate_mips(vsdl_upload_command_buffer(ctx), texture, level, end);
+  update_view(ctx, texture, level);
+  free_level(texture, level);
+  if (level > 0) {
+      texture->streamLevel = level - 1;
+      texture->streamedRows = 0;
+      return;
+  }
+  SDL_SetAtomicInt(&texture->state, VSDL_TEXTURE_READY);
+  SDL_Log("Texture %s ready (%ux%u, %u mips)", texture->path, texture->width, texture->height, texture->mipLevels);
+}
+
+int vsdl_init_textures(VSDL_Context* ctx) {
+  VkSamplerCreateInfo samplerInfo = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+  samplerInfo.magFilter = VK_FILTER_LINEAR;
+  samplerInfo.minFilter = VK_FILTER_LINEAR;
+  samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+  samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+  samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+  samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+  samplerInfo.minLod = 0.0f;
+  samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+  if (vkCreateSampler(ctx->device, &samplerInfo, NULL, &ctx->textures.sampler) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create texture sampler");
+      return 0;
+  }
+  ctx->textures.uploadBudget = 4 * 1024 * 1024;
+  SDL_Log("Texture system initialized");
+  return 1;
+}
+
+uint32_t vsdl_texture_load(VSDL_Context* ctx, const char* path) {
+  VSDL_TextureSystem* system = &ctx->textures;
+  if (system->count >= VSDL_MAX_TEXTURES) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Too many textures, cannot load %s", path);
+      return UINT32_MAX;
+  }
+
+  uint32_t id = system->count;
+  VSDL_Texture* texture = &system->textures[id];
+  SDL_strlcpy(texture->path, path, sizeof(texture->path));
+  texture->pack = &ctx->pack;
+  texture->bindlessSlot = VSDL_BINDLESS_NONE;
+  SDL_SetAtomicInt(&texture->state, VSDL_TEXTURE_LOADING);
+  system->count++;
+
+  if (!vsdl_workers_submit(ctx, decode_texture, texture)) {
+      SDL_SetAtomicInt(&texture->state, VSDL_TEXTURE_FAILED);
+  }
+  return id;
+}
+
+const VSDL_Texture* vsdl_texture_get(VSDL_Context* ctx, uint32_t id) {
+  if (id >= ctx->textures.count) return NULL;
+  return &ctx->textures.textures[id];
+}
+
+void vsdl_texture_update(VSDL_Context* ctx) {
+  VSDL_TextureSystem* system = &ctx->textures;
+  VkDeviceSize budget = system->uploadBudget;
+
+  for (uint32_t i = 0; i < system->count && budget > 0; i++) {
+      VSDL_Texture* texture = &system->textures[i];
+      int state = SDL_GetAtomicInt(&texture->state);
+      if (state == VSDL_TEXTURE_DECODED) {
+          if (!start_texture(ctx, texture, &budget)) continue;
+          state = VSDL_TEXTURE_STREAMING;
+      }
+      if (state == VSDL_TEXTURE_STREAMING) {
+          stream_rows(ctx, texture, &budget);
+      }
+  }
+
+  // Streaming spans frames, so keep them coming until every texture has landed
+  for (uint32_t i = 0; i < system->count; i++) {
+      int state = SDL_GetAtomicInt(&system->textures[i].state);
+      if (state == VSDL_TEXTURE_DECODED || state == VSDL_TEXTURE_STREAMING) {
+          vsdl_request_redraw(ctx);
+          break;
+      }
+  }
+}
+
+void vsdl_textures_shutdown(VSDL_Context* ctx) {
+  VSDL_TextureSystem* system = &ctx->textures;
+  for (uint32_t i = 0; i < system->count; i++) {
+      VSDL_Texture* texture = &system->textures[i];
+      if (texture->view != VK_NULL_HANDLE) vkDestroyImageView(ctx->device, texture->view, NULL);
+      if (texture->image != VK_NULL_HANDLE) vsdl_memory_destroy_image(ctx, texture->image, texture->allocation);
+      free_levels(texture);
+  }
+  if (system->sampler != VK_NULL_HANDLE) vkDestroySampler(ctx->device, system->sampler, NULL);
+  SDL_memset(system, 0, sizeof(*system));
+}
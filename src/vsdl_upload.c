@@ -0,0 +1,170 @@
+// #define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+// #include <volk.h>
+#include <vk_mem_alloc.h>
+#include <SDL3/SDL_log.h>
+#include <string.h>
+#include "vsdl_upload.h"
+#include "vsdl_types.h"
+#include "vsdl_memory.h"
+#include "vsdl_sync.h"
+
+int vsdl_upload_init(VSDL_Context* ctx, VkDeviceSize stagingSize) {
+  VSDL_Upload* upload = &ctx->upload;
+
+  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  bufferInfo.size = stagingSize;
+  bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  VmaAllocationCreateInfo allocInfo = {0};
+  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  VmaAllocationInfo info;
+  if (!vsdl_memory_create_buffer(ctx, VSDL_MEMORY_TAG_STAGING, &bufferInfo, &allocInfo, &upload->buffer, &upload->allocation, &info)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create upload staging buffer");
+      return 0;
+  }
+  upload->mapped = (unsigned char*)info.pMappedData;
+  upload->size = stagingSize;
+
+  VkCommandPoolCreateInfo poolInfo = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+  poolInfo.queueFamilyIndex = ctx->graphicsFamily;
+  poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+  if (vkCreateCommandPool(ctx->device, &poolInfo, NULL, &upload->commandPool) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create upload command pool");
+      return 0;
+  }
+
+  VkCommandBufferAllocateInfo cmdAllocInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+  cmdAllocInfo.commandPool = upload->commandPool;
+  cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  cmdAllocInfo.commandBufferCount = 1;
+  if (vkAllocateCommandBuffers(ctx->device, &cmdAllocInfo, &upload->commandBuffer) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate upload command buffer");
+      return 0;
+  }
+
+  SDL_Log("Upload staging buffer created (%llu bytes)", (unsigned long long)stagingSize);
+  return 1;
+}
+
+VkCommandBuffer vsdl_upload_command_buffer(VSDL_Context* ctx) {
+  VSDL_Upload* upload = &ctx->upload;
+  if (upload->recording) return upload->commandBuffer;
+
+  if (!vsdl_sync_wait(ctx, upload->submitValue)) return VK_NULL_HANDLE;
+  upload->offset = 0;
+
+  vkResetCommandBuffer(upload->commandBuffer, 0);
+  VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  if (vkBeginCommandBuffer(upload->commandBuffer, &beginInfo) != VK_SUCCESS) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to begin upload command buffer");
+      return VK_NULL_HANDLE;
+  }
+  upload->recording = 1;
+  return upload->commandBuffer;
+}
+
+void* vsdl_upload_alloc(VSDL_Context* ctx, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize* outOffset) {
+  VSDL_Upload* upload = &ctx->upload;
+  if (vsdl_upload_command_buffer(ctx) == VK_NULL_HANDLE) return NULL;
+
+  VkDeviceSize offset = (upload->offset + alignment - 1) & ~(alignment - 1);
+  if (offset + size > upload->size) return NULL;
+  upload->offset = offset + size;
+  *outOffset = offset;
+  return upload->mapped + offset;
+}
+
+VkDeviceSize vsdl_upload_available(VSDL_Context* ctx) {
+  VSDL_Upload* upload = &ctx->upload;
+  // A batch in flight is reclaimed as a whole when the next one begins
+  VkDeviceSize used = upload->recording ? upload->offset : 0;
+  return upload->size - used;
+}
+
+int vsdl_upload_image(VSDL_Context* ctx, VkImage image, uint32_t mipLevel, uint32_t y, uint32_t width, uint32_t height,
+                      const void* pixels, uint32_t bytesPerPixel) {
+  VkDeviceSize size = (VkDeviceSize)width * height * bytesPerPixel;
+  VkDeviceSize offset;
+  void* dst = vsdl_upload_alloc(ctx, size, 16, &offset);
+  if (!dst) return 0;
+  memcpy(dst, pixels, (size_t)size);
+
+  VkBufferImageCopy copyRegion = {0};
+  copyRegion.bufferOffset = offset;
+  copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  copyRegion.imageSubresource.mipLevel = mipLevel;
+  copyRegion.imageSubresource.layerCount = 1;
+  copyRegion.imageOffset.y = (int32_t)y;
+  copyRegion.imageExtent.width = width;
+  copyRegion.imageExtent.height = height;
+  copyRegion.imageExtent.depth = 1;
+  vkCmdCopyBufferToImage(ctx->upload.commandBuffer, ctx->upload.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+  return 1;
+}
+
+int vsdl_upload_buffer(VSDL_Context* ctx, VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size) {
+  VkDeviceSize offset;
+  void* staging = vsdl_upload_alloc(ctx, size, 16, &offset);
+  if (!staging) return 0;
+  memcpy(staging, data, (size_t)size);
+
+  VkBufferCopy region = {offset, dstOffset, size};
+  vkCmdCopyBuffer(ctx->upload.commandBuffer, ctx->upload.buffer, dst, 1, &region);
+  vsdl_memory_buffer_written(ctx, dst);
+  return 1;
+}
+
+int vsdl_upload_flush(VSDL_Context* ctx, int wait) {
+  VSDL_Upload* upload = &ctx->upload;
+  if (upload->recording) {
+      upload->recording = 0;
+      if (vkEndCommandBuffer(upload->commandBuffer) != VK_SUCCESS) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to end upload command buffer");
+          return 0;
+      }
+
+      VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+      submitInfo.commandBufferCount = 1;
+      submitInfo.pCommandBuffers = &upload->commandBuffer;
+      if (!vsdl_sync_submit(ctx, &submitInfo, &upload->submitValue)) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to submit upload batch");
+          return 0;
+      }
+  }
+
+  if (wait && !vsdl_sync_wait(ctx, upload->submitValue)) return 0;
+  return 1;
+}
+
+void vsdl_upload_shutdown(VSDL_Context* ctx) {
+  VSDL_Upload* upload = &ctx->upload;
+  if (ctx->device == VK_NULL_HANDLE) return;
+
+  vsdl_sync_wait(ctx, upload->submitValue);
+  if (upload->commandPool != VK_NULL_HANDLE) vkDestroyCommandPool(ctx->device, upload->commandPool, NULL);
+  if (upload->buffer != VK_NULL_HANDLE) vsdl_memory_destroy_buffer(ctx, upload->buffer, upload->allocation);
+  memset(upload, 0, sizeof(*upload));
+}
+
+void vsdl_cmd_image_barrier(VkCommandBuffer cmd, VkImage image, uint32_t baseMipLevel, uint32_t levelCount,
+                            VkImageLayout oldLayout, VkImageLayout newLayout,
+                            VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+                            VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage) {
+  VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+  barrier.oldLayout = oldLayout;
+  barrier.newLayout = newLayout;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = image;
+  barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  barrier.subresourceRange.baseMipLevel = baseMipLevel;
+  barrier.subresourceRange.levelCount = levelCount;
+  barrier.subresourceRange.baseArrayLayer = 0;
+  barrier.subresourceRange.layerCount = 1;
+  barrier.srcAccessMask = srcAccess;
+  barrier.dstAccessMask = dstAccess;
+  vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 0, NULL, 0, NULL, 1, &barrier);
+}
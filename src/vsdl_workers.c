@@ -0,0 +1,358 @@
+#include <SDL3/SDL.h>
+#include "vsdl_workers.h"
+#include "vsdl_types.h"
+#include "vsdl_arena.h"
+
+static SDL_TLSID threadSlot;
+
+// Indices only grow and wrap at 2^32; VSDL_WORK_DEQUE_SIZE divides that, so slots stay consistent
+static int deque_push(VSDL_WorkDeque* deque, const VSDL_WorkItem* item) {
+  uint32_t bottom = SDL_GetAtomicU32(&deque->bottom);
+  uint32_t top = SDL_GetAtomicU32(&deque->top);
+  if (bottom - top >= VSDL_WORK_DEQUE_SIZE) return 0;
+  deque->items[bottom % VSDL_WORK_DEQUE_SIZE] = *item;
+  SDL_SetAtomicU32(&deque->bottom, bottom + 1);
+  return 1;
+}
+
+static int deque_pop(VSDL_WorkDeque* deque, VSDL_WorkItem* out) {
+  uint32_t bottom = SDL_GetAtomicU32(&deque->bottom) - 1;
+  SDL_SetAtomicU32(&deque->bottom, bottom);
+  uint32_t top = SDL_GetAtomicU32(&deque->top);
+  int32_t size = (int32_t)(bottom - top);
+  if (size < 0) {
+      SDL_SetAtomicU32(&deque->bottom, bottom + 1);
+      return 0;
+  }
+  *out = deque->items[bottom % VSDL_WORK_DEQUE_SIZE];
+  if (size > 0) return 1;
+  // Last item: race thieves for it
+  int won = SDL_CompareAndSwapAtomicU32(&deque->top, top, top + 1);
+  SDL_SetAtomicU32(&deque->bottom, top + 1);
+  return won;
+}
+
+static int deque_steal(VSDL_WorkDeque* deque, VSDL_WorkItem* out) {
+  uint32_t top = SDL_GetAtomicU32(&deque->top);
+  uint32_t bottom = SDL_GetAtomicU32(&deque->bottom);
+  if ((int32_t)(bottom - top) <= 0) return 0;
+  // The owner cannot overwrite this slot while top is still ours, so a won CAS means a whole item
+  VSDL_WorkItem item = deque->items[top % VSDL_WORK_DEQUE_SIZE];
+  if (!SDL_CompareAndSwapAtomicU32(&deque->top, top, top + 1)) return 0;
+  *out = item;
+  return 1;
+}
+
+// Caller holds the mutex
+static int enqueue_shared(VSDL_Workers* workers, const VSDL_WorkItem* item) {
+  if (workers->tail - workers->head >= VSDL_WORK_QUEUE_SIZE) return 0;
+  workers->queue[workers->tail % VSDL_WORK_QUEUE_SIZE] = *item;
+  workers->tail++;
+  SDL_AddAtomicInt(&workers->shared, 1);
+  SDL_AddAtomicInt(&workers->queued, 1);
+  return 1;
+}
+
+// A counter reached zero: release jobs parked on it and wake anyone waiting
+static void counter_finished(VSDL_Workers* workers) {
+  SDL_LockMutex(workers->mutex);
+  uint32_t kept = 0;
+  int released = 0;
+  for (uint32_t i = 0; i < workers->parkedCount; i++) {
+      VSDL_WorkItem item = workers->parked[i];
+      if (SDL_GetAtomicInt(&item.dependency->value) == 0) {
+          item.dependency = NULL;
+          if (enqueue_shared(workers, &item)) {
+              released = 1;
+              continue;
+          }
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Worker queue full; job stays parked");
+          item.dependency = workers->parked[i].dependency;
+      }
+      workers->parked[kept++] = item;
+  }
+  workers->parkedCount = kept;
+  if (released) SDL_BroadcastCondition(workers->condition);
+  SDL_BroadcastCondition(workers->doneCondition);
+  SDL_UnlockMutex(workers->mutex);
+}
+
+static void finish_counter(VSDL_Workers* workers, VSDL_JobCounter* counter) {
+  if (counter && SDL_AddAtomicInt(&counter->value, -1) == 1 && workers->mutex) {
+      counter_finished(workers);
+  }
+}
+
+// arena is NULL for jobs run while waiting inside another job, which still owns the arena
+static void run_item(VSDL_Workers* workers, const VSDL_WorkItem* item, VSDL_Arena* arena) {
+  if (arena) vsdl_arena_reset(arena);
+  item->fn(item->data);
+  finish_counter(workers, item->counter);
+}
+
+// Own deque first, then the shared queue, then steal starting from the next worker over
+static int take_work(VSDL_Workers* workers, uint32_t slot, VSDL_WorkItem* out) {
+  int found = deque_pop(&workers->deques[slot], out);
+  if (!found && SDL_GetAtomicInt(&workers->shared) > 0) {
+      SDL_LockMutex(workers->mutex);
+      if (workers->head != workers->tail) {
+          *out = workers->queue[workers->head % VSDL_WORK_QUEUE_SIZE];
+          workers->head++;
+          SDL_AddAtomicInt(&workers->shared, -1);
+          found = 1;
+      }
+      SDL_UnlockMutex(workers->mutex);
+  }
+  for (uint32_t i = 1; !found && i < workers->threadCount; i++) {
+      found = deque_steal(&workers->deques[(slot + i) % workers->threadCount], out);
+  }
+  if (found) SDL_AddAtomicInt(&workers->queued, -1);
+  return found;
+}
+
+static int worker_main(void* data) {
+  VSDL_Workers* workers = (VSDL_Workers*)data;
+  int slot = SDL_AddAtomicInt(&workers->nextIndex, 1);
+  VSDL_Arena* arena = &workers->arenas[slot];
+  vsdl_arena_bind_thread(arena);
+  // Stored +1 so threads that never set it read back 0
+  SDL_SetTLS(&threadSlot, (void*)(uintptr_t)(slot + 1), NULL);
+  for (;;) {
+      VSDL_WorkItem item;
+      if (take_work(workers, (uint32_t)slot, &item)) {
+          run_item(workers, &item, arena);
+          continue;
+      }
+
+      // Submitters bump queued before checking sleeping, so one side always sees the other
+      SDL_LockMutex(workers->mutex);
+      SDL_AddAtomicInt(&workers->sleeping, 1);
+      while (SDL_GetAtomicInt(&workers->queued) <= 0 && !workers->quit) {
+          SDL_WaitCondition(workers->condition, workers->mutex);
+      }
+      SDL_AddAtomicInt(&workers->sleeping, -1);
+      int quit = workers->quit;
+      SDL_UnlockMutex(workers->mutex);
+      if (quit) break;
+  }
+  return 0;
+}
+
+int vsdl_workers_init(VSDL_Context* ctx, uint32_t threadCount) {
+  VSDL_Workers* workers = &ctx->workers;
+  if (threadCount == 0) {
+      int cores = SDL_GetNumLogicalCPUCores();
+      threadCount = cores > 1 ? (uint32_t)(cores - 1) : 1;
+  }
+  if (threadCount > VSDL_MAX_WORKERS) threadCount = VSDL_MAX_WORKERS;
+
+  workers->mutex = SDL_CreateMutex();
+  workers->condition = SDL_CreateCondition();
+  workers->doneCondition = SDL_CreateCondition();
+  if (!workers->mutex || !workers->condition || !workers->doneCondition) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create worker synchronization: %s", SDL_GetError());
+      return 0;
+  }
+
+  // Steal loops read threadCount, so it is final before any thread starts
+  for (uint32_t i = 0; i < threadCount; i++) {
+      if (!vsdl_arena_init(&workers->arenas[i], 1024 * 1024)) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate worker arena");
+          threadCount = i;
+          break;
+      }
+  }
+  workers->threadCount = threadCount;
+  for (uint32_t i = 0; i < threadCount; i++) {
+      char name[32];
+      SDL_snprintf(name, sizeof(name), "vsdl_worker_%u", i);
+      workers->threads[i] = SDL_CreateThread(worker_main, name, workers);
+      if (!workers->threads[i]) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create worker thread: %s", SDL_GetError());
+          // Only owners push to a deque, so slots nobody claims just stay empty
+          if (i == 0) {
+              vsdl_workers_shutdown(ctx);
+              return 0;
+          }
+          break;
+      }
+  }
+  if (workers->threadCount == 0) return 0;
+
+  SDL_Log("Worker threads started (count: %u)", workers->threadCount);
+  return 1;
+}
+
+static int push_item(VSDL_Workers* workers, const VSDL_WorkItem* item) {
+  uint32_t slot = vsdl_workers_thread_slot();
+  if (slot < VSDL_MAX_WORKERS) {
+      SDL_AddAtomicInt(&workers->queued, 1);
+      if (deque_push(&workers->deques[slot], item)) {
+          if (SDL_GetAtomicInt(&workers->sleeping) > 0) {
+              SDL_LockMutex(workers->mutex);
+              SDL_SignalCondition(workers->condition);
+              SDL_UnlockMutex(workers->mutex);
+          }
+          return 1;
+      }
+      SDL_AddAtomicInt(&workers->queued, -1);  // Deque full: fall back to the shared queue
+  }
+
+  SDL_LockMutex(workers->mutex);
+  int ok = enqueue_shared(workers, item);
+  if (ok) SDL_SignalCondition(workers->condition);
+  SDL_UnlockMutex(workers->mutex);
+  if (!ok && slot < VSDL_MAX_WORKERS) {
+      run_item(workers, item, NULL);  // Everything is full: a worker just runs the job itself
+      return 1;
+  }
+  if (!ok) SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Worker queue full");
+  return ok;
+}
+
+int vsdl_workers_submit(VSDL_Context* ctx, VSDL_WorkFn fn, void* data) {
+  return vsdl_workers_submit_counted(ctx, fn, data, NULL);
+}
+
+int vsdl_workers_submit_counted(VSDL_Context* ctx, VSDL_WorkFn fn, void* data, VSDL_JobCounter* counter) {
+  VSDL_Workers* workers = &ctx->workers;
+  VSDL_WorkItem item = {fn, data, counter, NULL};
+  if (counter) SDL_AddAtomicInt(&counter->value, 1);
+  if (workers->threadCount == 0) {
+      run_item(workers, &item, NULL);  // No workers: run inline
+      return 1;
+  }
+  if (!push_item(workers, &item)) {
+      finish_counter(workers, counter);
+      return 0;
+  }
+  return 1;
+}
+
+int vsdl_workers_submit_after(VSDL_Context* ctx, VSDL_JobCounter* dependency, VSDL_WorkFn fn, void* data,
+                              VSDL_JobCounter* counter) {
+  VSDL_Workers* workers = &ctx->workers;
+  if (!dependency || workers->threadCount == 0) {
+      return vsdl_workers_submit_counted(ctx, fn, data, counter);
+  }
+
+  VSDL_WorkItem item = {fn, data, counter, dependency};
+  if (counter) SDL_AddAtomicInt(&counter->value, 1);
+  // Checked under the mutex that counter_finished takes, so the release cannot be missed
+  SDL_LockMutex(workers->mutex);
+  int parked = 0;
+  if (SDL_GetAtomicInt(&dependency->value) > 0) {
+      if (workers->parkedCount == VSDL_WORK_QUEUE_SIZE) {
+          SDL_UnlockMutex(workers->mutex);
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Too many parked jobs");
+          finish_counter(workers, counter);
+          return 0;
+      }
+      workers->parked[workers->parkedCount++] = item;
+      parked = 1;
+  }
+  SDL_UnlockMutex(workers->mutex);
+  if (parked) return 1;
+
+  item.dependency = NULL;
+  if (!push_item(workers, &item)) {
+      finish_counter(workers, counter);
+      return 0;
+  }
+  return 1;
+}
+
+void vsdl_workers_wait(VSDL_Context* ctx, VSDL_JobCounter* counter) {
+  VSDL_Workers* workers = &ctx->workers;
+  uint32_t slot = vsdl_workers_thread_slot();
+  if (slot < VSDL_MAX_WORKERS) {
+      // Blocking here would take a core out of the pool, so help until the counter drains
+      while (SDL_GetAtomicInt(&counter->value) > 0) {
+          VSDL_WorkItem item;
+          if (take_work(workers, slot, &item)) {
+              run_item(workers, &item, NULL);
+          } else {
+              SDL_CPUPauseInstruction();
+          }
+      }
+      return;
+  }
+
+  // Other threads keep out of the workers' per-slot state and just sleep
+  if (SDL_GetAtomicInt(&counter->value) <= 0 || !workers->mutex) return;
+  SDL_LockMutex(workers->mutex);
+  while (SDL_GetAtomicInt(&counter->value) > 0) {
+      SDL_WaitCondition(workers->doneCondition, workers->mutex);
+  }
+  SDL_UnlockMutex(workers->mutex);
+}
+
+typedef struct {
+  VSDL_ParallelFn fn;
+  void* data;
+  uint32_t count;
+  uint32_t grain;
+  SDL_AtomicInt next;
+} ParallelRange;
+
+// Every participant pulls slices until the range runs out, so uneven slices balance themselves
+static void run_range(void* data) {
+  ParallelRange* range = (ParallelRange*)data;
+  for (;;) {
+      uint32_t begin = (uint32_t)SDL_AddAtomicInt(&range->next, (int)range->grain);
+      if (begin >= range->count) break;
+      uint32_t end = range->count - begin > range->grain ? begin + range->grain : range->count;
+      range->fn(range->data, begin, end);
+  }
+}
+
+void vsdl_parallel_for(VSDL_Context* ctx, uint32_t count, uint32_t grain, VSDL_ParallelFn fn, void* data) {
+  if (count == 0) return;
+  uint32_t participants = ctx->workers.threadCount + 1;
+  if (grain == 0) {
+      grain = count / (participants * 4);
+      if (grain == 0) grain = 1;
+  }
+
+  ParallelRange range;
+  range.fn = fn;
+  range.data = data;
+  range.count = count;
+  range.grain = grain;
+  SDL_SetAtomicInt(&range.next, 0);
+  uint32_t slices = (count + grain - 1) / grain;
+  uint32_t helpers = slices - 1 < ctx->workers.threadCount ? slices - 1 : ctx->workers.threadCount;
+
+  VSDL_JobCounter counter;
+  SDL_SetAtomicInt(&counter.value, 0);
+  for (uint32_t i = 0; i < helpers; i++) {
+      if (!vsdl_workers_submit_counted(ctx, run_range, &range, &counter)) break;
+  }
+  run_range(&range);
+  vsdl_workers_wait(ctx, &counter);
+}
+
+uint32_t vsdl_workers_thread_slot(void) {
+  uintptr_t slot = (uintptr_t)SDL_GetTLS(&threadSlot);
+  return slot ? (uint32_t)(slot - 1) : VSDL_MAX_WORKERS;
+}
+
+void vsdl_workers_shutdown(VSDL_Context* ctx) {
+  VSDL_Workers* workers = &ctx->workers;
+  if (workers->mutex) {
+      SDL_LockMutex(workers->mutex);
+      workers->quit = 1;
+      SDL_BroadcastCondition(workers->condition);
+      SDL_UnlockMutex(workers->mutex);
+  }
+  for (uint32_t i = 0; i < workers->threadCount; i++) {
+      if (workers->threads[i]) SDL_WaitThread(workers->threads[i], NULL);
+  }
+  for (uint32_t i = 0; i < VSDL_MAX_WORKERS; i++) {
+      vsdl_arena_destroy(&workers->arenas[i]);
+  }
+  if (workers->doneCondition) SDL_DestroyCondition(workers->doneCondition);
+  if (workers->condition) SDL_DestroyCondition(workers->condition);
+  if (workers->mutex) SDL_DestroyMutex(workers->mutex);
+  SDL_memset(workers, 0, sizeof(*workers));
+}
@@ -0,0 +1,235 @@
+// Builds a VSDL asset pack from one or more directories.
+//   vsdl_packer [-z] out.pak dir=prefix [dir=prefix ...]
+// Files under dir are stored as "prefix/relative/path". With -z, entries are
+// LZ4 HC compressed when that actually saves space.
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <lz4.h>
+#include <lz4hc.h>
+#include "vsdl_pack_format.h"
+
+typedef struct {
+  char* name;
+  void* data;
+  size_t size;
+  size_t storedSize;
+  uint32_t compression;
+  uint64_t hash;
+  uint64_t offset;
+  uint32_t nameOffset;
+} PackInput;
+
+typedef struct {
+  PackInput* items;
+  uint32_t count;
+  uint32_t capacity;
+} PackInputs;
+
+static int add_input(PackInputs* inputs, const char* name, void* data, size_t size) {
+  if (inputs->count == inputs->capacity) {
+      uint32_t capacity = inputs->capacity ? inputs->capacity * 2 : 64;
+      PackInput* items = (PackInput*)SDL_realloc(inputs->items, capacity * sizeof(PackInput));
+      if (!items) return 0;
+      inputs->items = items;
+      inputs->capacity = capacity;
+  }
+  PackInput* input = &inputs->items[inputs->count++];
+  SDL_memset(input, 0, sizeof(*input));
+  input->name = SDL_strdup(name);
+  input->data = data;
+  input->size = size;
+  input->storedSize = size;
+  input->hash = vsdl_pack_hash(name);
+  return input->name != NULL;
+}
+
+static int gather_directory(PackInputs* inputs, const char* dir, const char* prefix) {
+  int count = 0;
+  char** paths = SDL_GlobDirectory(dir, NULL, 0, &count);
+  if (!paths) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Cannot list %s: %s", dir, SDL_GetError());
+      return 0;
+  }
+
+  int ok = 1;
+  for (int i = 0; i < count && ok; i++) {
+      char* fullPath = NULL;
+      SDL_asprintf(&fullPath, "%s/%s", dir, paths[i]);
+      SDL_PathInfo info;
+      if (fullPath && SDL_GetPathInfo(fullPath, &info) && info.type == SDL_PATHTYPE_FILE) {
+          size_t size = 0;
+          void* data = SDL_LoadFile(fullPath, &size);
+          char* name = NULL;
+          SDL_asprintf(&name, "%s/%s", prefix, paths[i]);
+          if (!data || !name) {
+              SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Cannot read %s: %s", fullPath, SDL_GetError());
+              ok = 0;
+          } else {
+              for (char* c = name; *c; c++) {
+                  if (*c == '\\') *c = '/';
+              }
+              ok = add_input(inputs, name, data, size);
+          }
+          SDL_free(name);
+      }
+      SDL_free(fullPath);
+  }
+  SDL_free(paths);
+  return ok;
+}
+
+static void compress_input(PackInput* input) {
+  if (input->size == 0 || input->size > LZ4_MAX_INPUT_SIZE) return;
+  int bound = LZ4_compressBound((int)input->size);
+  char* compressed = (char*)SDL_malloc((size_t)bound);
+  if (!compressed) return;
+  int written = LZ4_compress_HC((const char*)input->data, compressed, (int)input->size, bound, LZ4HC_CLEVEL_MAX);
+  if (written > 0 && (size_t)written < input->size) {
+      SDL_free(input->data);
+      input->data = compressed;
+      input->storedSize = (size_t)written;
+      input->compression = VSDL_PACK_COMPRESSION_LZ4;
+  } else {
+      SDL_free(compressed);
+  }
+}
+
+static int compare_inputs(const void* a, const void* b) {
+  uint64_t ha = ((const PackInput*)a)->hash;
+  uint64_t hb = ((const PackInput*)b)->hash;
+  return (ha > hb) - (ha < hb);
+}
+
+static uint64_t align_up(uint64_t value) {
+  return (value + VSDL_PACK_ALIGNMENT - 1) & ~(uint64_t)(VSDL_PACK_ALIGNMENT - 1);
+}
+
+static int write_zeros(SDL_IOStream* io, uint64_t count) {
+  static const unsigned char zeros[VSDL_PACK_ALIGNMENT];
+  while (count > 0) {
+      size_t chunk = count < sizeof(zeros) ? (size_t)count : sizeof(zeros);
+      if (SDL_WriteIO(io, zeros, chunk) != chunk) return 0;
+      count -= chunk;
+  }
+  return 1;
+}
+
+static int write_pack(const char* path, PackInputs* inputs) {
+  uint64_t tocOffset = sizeof(VSDL_PackHeader);
+  uint64_t namesOffset = tocOffset + (uint64_t)inputs->count * sizeof(VSDL_PackEntry);
+
+  uint64_t namesSize = 0;
+  for (uint32_t i = 0; i < inputs->count; i++) {
+      inputs->items[i].nameOffset = (uint32_t)namesSize;
+      namesSize += SDL_strlen(inputs->items[i].name) + 1;
+  }
+  uint64_t offset = align_up(namesOffset + namesSize);
+  for (uint32_t i = 0; i < inputs->count; i++) {
+      inputs->items[i].offset = offset;
+      offset = align_up(offset + inputs->items[i].storedSize);
+  }
+
+  SDL_IOStream* io = SDL_IOFromFile(path, "wb");
+  if (!io) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Cannot create %s: %s", path, SDL_GetError());
+      return 0;
+  }
+
+  VSDL_PackHeader header;
+  SDL_memset(&header, 0, sizeof(header));
+  SDL_memcpy(header.magic, VSDL_PACK_MAGIC, sizeof(header.magic));
+  header.version = VSDL_PACK_VERSION;
+  header.entryCount = inputs->count;
+  header.tocOffset = tocOffset;
+  header.namesOffset = namesOffset;
+  int ok = SDL_WriteIO(io, &header, sizeof(header)) == sizeof(header);
+
+  for (uint32_t i = 0; i < inputs->count && ok; i++) {
+      const PackInput* input = &inputs->items[i];
+      VSDL_PackEntry entry;
+      SDL_memset(&entry, 0, sizeof(entry));
+      entry.hash = input->hash;
+      entry.offset = input->offset;
+      entry.storedSize = input->storedSize;
+      entry.size = input->size;
+      entry.compression = input->compression;
+      entry.nameOffset = input->nameOffset;
+      ok = SDL_WriteIO(io, &entry, sizeof(entry)) == sizeof(entry);
+  }
+  for (uint32_t i = 0; i < inputs->count && ok; i++) {
+      size_t length = SDL_strlen(inputs->items[i].name) + 1;
+      ok = SDL_WriteIO(io, inputs->items[i].name, length) == length;
+  }
+
+  uint64_t position = namesOffset + namesSize;
+  for (uint32_t i = 0; i < inputs->count && ok; i++) {
+      const PackInput* input = &inputs->items[i];
+      ok = write_zeros(io, input->offset - position) &&
+           SDL_WriteIO(io, input->data, input->storedSize) == input->storedSize;
+      position = input->offset + input->storedSize;
+  }
+
+  if (!SDL_CloseIO(io)) ok = 0;
+  if (!ok) SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed writing %s: %s", path, SDL_GetError());
+  return ok;
+}
+
+int main(int argc, char* argv[]) {
+  int compress = 0;
+  int arg = 1;
+  if (arg < argc && SDL_strcmp(argv[arg], "-z") == 0) {
+      compress = 1;
+      arg++;
+  }
+  if (argc - arg < 2) {
+      SDL_Log("usage: vsdl_packer [-z] out.pak dir=prefix [dir=prefix ...]");
+      return 1;
+  }
+  const char* outPath = argv[arg++];
+
+  PackInputs inputs = {0};
+  int ok = 1;
+  for (; arg < argc && ok; arg++) {
+      char* spec = SDL_strdup(argv[arg]);
+      char* separator = spec ? SDL_strrchr(spec, '=') : NULL;
+      if (!separator) {
+          SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Expected dir=prefix, got %s", argv[arg]);
+          ok = 0;
+      } else {
+          *separator = '\0';
+          ok = gather_directory(&inputs, spec, separator + 1);
+      }
+      SDL_free(spec);
+  }
+
+  if (ok) {
+      SDL_qsort(inputs.items, inputs.count, sizeof(PackInput), compare_inputs);
+      for (uint32_t i = 1; i < inputs.count; i++) {
+          if (inputs.items[i].hash == inputs.items[i - 1].hash) {
+              SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Hash collision between %s and %s",
+                           inputs.items[i - 1].name, inputs.items[i].name);
+              ok = 0;
+          }
+      }
+  }
+
+  size_t rawBytes = 0, storedBytes = 0;
+  if (ok) {
+      for (uint32_t i = 0; i < inputs.count; i++) {
+          if (compress) compress_input(&inputs.items[i]);
+          rawBytes += inputs.items[i].size;
+          storedBytes += inputs.items[i].storedSize;
+      }
+      ok = write_pack(outPath, &inputs);
+  }
+  if (ok) {
+      SDL_Log("Packed %u files into %s (%zu -> %zu bytes)", inputs.count, outPath, rawBytes, storedBytes);
+  }
+
+  for (uint32_t i = 0; i < inputs.count; i++) {
+      SDL_free(inputs.items[i].name);
+      SDL_free(inputs.items[i].data);
+  }
+  SDL_free(inputs.items);
+  return ok ? 0 : 1;
+}